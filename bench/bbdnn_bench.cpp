@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bbdnn/Allocator.hpp"
+#include "bbdnn/Gemm.hpp"
+#include "bbdnn/NeuralNetwork.hpp"
+#include "bbdnn/Profiler.hpp"
+#include "bbdnn/Quantization.hpp"
+#include "bbdnn/Simd.hpp"
+
+using namespace bbdnn;
+
+// Parameterized benchmarks for the matrix kernels, activations, inference and training.
+//
+//   bbdnn_bench [--filter TEXT] [--json PATH] [--min-time SECONDS] [--repetitions N]
+//
+// Every benchmark is timed in `repetitions` rounds of at least min-time / repetitions seconds each;
+// the median round is the headline number and the fastest is kept alongside it. With --json the
+// results are also written in a stable format that bench/compare_bench.py can diff.
+
+namespace {
+
+    struct Options {
+        std::string filter;
+        std::string jsonPath;
+        double minSeconds = 0.5;
+        int repetitions = 5;
+    };
+
+    struct Result {
+        std::string name;
+        std::string group;
+        std::vector<std::pair<std::string, int>> params;
+        long iterations = 0;
+        double medianSeconds = 0.0;
+        double minSeconds = 0.0;
+        // Work per call, for throughput columns; 0 when not meaningful
+        double flops = 0.0;
+        double items = 0.0;
+    };
+
+    // Keep results observable so the timed work is not optimized away
+    volatile float sink;
+
+    class Runner {
+        Options options;
+        std::vector<Result> results;
+
+        // Calls per round so that one round lasts about roundSeconds
+        template <typename Fn>
+        long calibrate(Fn& fn, double roundSeconds) {
+            using Clock = std::chrono::steady_clock;
+
+            long calls = 1;
+            while (true) {
+                auto start = Clock::now();
+                for (long i = 0; i < calls; i++)
+                    fn();
+                double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+                if (elapsed >= roundSeconds * 0.5 || calls >= (1L << 30))
+                    return std::max(1L, static_cast<long>(calls * roundSeconds / std::max(elapsed, 1e-9)));
+
+                calls *= elapsed > 0.0 ? std::min(10L, static_cast<long>(roundSeconds / elapsed) + 1) : 10L;
+            }
+        }
+
+    public:
+        explicit Runner(Options Opts) : options(std::move(Opts)) {}
+
+        // Time fn unless the filter excludes it. flops and items are the work done by one call
+        template <typename Fn>
+        void run(const std::string& group, std::vector<std::pair<std::string, int>> params, double flops, double items, Fn fn) {
+            std::string name = group;
+            for (const auto& [key, value] : params)
+                name += "/" + key + "=" + std::to_string(value);
+
+            if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+                return;
+
+            using Clock = std::chrono::steady_clock;
+
+            fn(); // warm-up
+            long calls = calibrate(fn, options.minSeconds / options.repetitions);
+
+            std::vector<double> rounds;
+            for (int r = 0; r < options.repetitions; r++) {
+                auto start = Clock::now();
+                for (long i = 0; i < calls; i++)
+                    fn();
+                rounds.push_back(std::chrono::duration<double>(Clock::now() - start).count() / calls);
+            }
+
+            std::sort(rounds.begin(), rounds.end());
+
+            Result result;
+            result.name = name;
+            result.group = group;
+            result.params = std::move(params);
+            result.iterations = calls * options.repetitions;
+            result.medianSeconds = rounds[rounds.size() / 2];
+            result.minSeconds = rounds.front();
+            result.flops = flops;
+            result.items = items;
+
+            print(result);
+            results.push_back(std::move(result));
+        }
+
+        static void printHeader() {
+            std::cout << std::left << std::setw(48) << "benchmark"
+                      << std::right << std::setw(13) << "median us"
+                      << std::setw(13) << "min us"
+                      << std::setw(11) << "GFLOP/s"
+                      << std::setw(14) << "items/s" << std::endl;
+        }
+
+        static void print(const Result& r) {
+            std::ostringstream gflops;
+            std::ostringstream itemRate;
+            gflops << std::fixed << std::setprecision(2) << r.flops / r.medianSeconds * 1e-9;
+            itemRate << std::scientific << std::setprecision(2) << r.items / r.medianSeconds;
+
+            std::cout << std::left << std::setw(48) << r.name << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(13) << r.medianSeconds * 1e6
+                      << std::setw(13) << r.minSeconds * 1e6
+                      << std::setw(11) << (r.flops > 0.0 ? gflops.str() : "-")
+                      << std::setw(14) << (r.items > 0.0 ? itemRate.str() : "-")
+                      << std::defaultfloat << std::endl;
+        }
+
+        void writeJson(const std::string& path) const {
+            std::ofstream file(path, std::ios::trunc);
+            if (!file) {
+                std::cerr << "Could not open " << path << " for writing" << std::endl;
+                std::exit(1);
+            }
+
+            std::time_t now = std::time(nullptr);
+            char date[32];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+            file << std::setprecision(9);
+            file << "{\n  \"context\": {\n"
+                 << "    \"date\": \"" << date << "\",\n"
+                 << "    \"simd\": \"" << kernels::simdLevelName(kernels::detectSimdLevel()) << "\",\n"
+                 << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+#if defined(__clang__)
+                 << "    \"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\",\n"
+#elif defined(__GNUC__)
+                 << "    \"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\",\n"
+#else
+                 << "    \"compiler\": \"unknown\",\n"
+#endif
+                 << "    \"profiling\": " << (profiling::enabled() ? "true" : "false") << ",\n"
+                 << "    \"min_time\": " << options.minSeconds << ",\n"
+                 << "    \"repetitions\": " << options.repetitions << "\n"
+                 << "  },\n  \"benchmarks\": [";
+
+            for (size_t i = 0; i < results.size(); i++) {
+                const Result& r = results[i];
+
+                file << (i == 0 ? "\n" : ",\n")
+                     << "    {\"name\": \"" << r.name << "\", \"group\": \"" << r.group << "\", \"params\": {";
+
+                for (size_t p = 0; p < r.params.size(); p++)
+                    file << (p == 0 ? "" : ", ") << "\"" << r.params[p].first << "\": " << r.params[p].second;
+
+                file << "}, \"iterations\": " << r.iterations
+                     << ", \"median_ns\": " << r.medianSeconds * 1e9
+                     << ", \"min_ns\": " << r.minSeconds * 1e9
+                     << ", \"flops\": " << r.flops
+                     << ", \"items\": " << r.items << "}";
+            }
+
+            file << "\n  ]\n}\n";
+
+            if (!file) {
+                std::cerr << "Could not write " << path << std::endl;
+                std::exit(1);
+            }
+        }
+
+        bool empty() const {
+            return results.empty();
+        }
+    };
+
+    // A random input or label vector
+    Vector randomVector(int size, std::mt19937& engine) {
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        Vector v(size);
+        for (int i = 0; i < size; i++)
+            v[i] = distribution(engine);
+
+        return v;
+    }
+
+    // depth hidden ReLU layers of width neurons between a width-wide input and 10 sigmoid outputs
+    NeuralNetwork makeNetwork(int width, int depth) {
+        std::vector<DenseLayer> layers;
+        layers.emplace_back(width, Activation::Linear());
+        for (int d = 0; d < depth; d++)
+            layers.emplace_back(width, Activation::ReLU());
+        layers.emplace_back(10, Activation::Sigmoid());
+
+        return NeuralNetwork(7, std::move(layers));
+    }
+
+    void matrixBenchmarks(Runner& runner) {
+        for (int n : { 64, 128, 256, 512 }) {
+            Matrix a = Matrix::xavierMatrix(n, n, 1);
+            Matrix b = Matrix::xavierMatrix(n, n, 2);
+            Matrix c(n, n, 0.0f);
+            double flops = 2.0 * n * n * n;
+
+            runner.run("matrix/gemm", { { "n", n } }, flops, 0.0, [&] {
+                Matrix product = a * b;
+                sink = product.at(0, 0);
+            });
+
+            // C = A^T * B through the strided kernel, as the backward pass uses it
+            runner.run("matrix/gemm_tn", { { "n", n } }, flops, 0.0, [&] {
+                kernels::gemm(n, n, n, 1.0f, a.rawData(), 1, n, b.rawData(), n, 1, 0.0f, c.rawData(), n);
+                sink = c.at(0, 0);
+            });
+        }
+
+        for (int n : { 256, 1024, 2048 }) {
+            Matrix weights = Matrix::xavierMatrix(n, n, 3);
+            Vector input(n, 0.5f);
+
+            runner.run("matrix/matvec", { { "n", n } }, 2.0 * n * n, 0.0, [&] {
+                Vector output = weights.applyMatrix(input);
+                sink = output[0];
+            });
+
+            runner.run("matrix/transpose", { { "n", n } }, 0.0, static_cast<double>(n) * n, [&] {
+                Matrix t = weights.transposed();
+                sink = t.at(0, 0);
+            });
+
+            Matrix other = Matrix::xavierMatrix(n, n, 4);
+            runner.run("matrix/hadamard", { { "n", n } }, static_cast<double>(n) * n, static_cast<double>(n) * n, [&] {
+                Matrix product = weights.hadamardProduct(other);
+                sink = product.at(0, 0);
+            });
+        }
+
+        // A chain of eager operators, each allocating its result, from the heap and from an arena reset per call
+        for (int n : { 16, 64, 256 }) {
+            Matrix a = Matrix::xavierMatrix(n, n, 5);
+            Matrix b = Matrix::xavierMatrix(n, n, 6);
+            double items = 4.0 * n * n;
+
+            auto temporaries = [&] {
+                Matrix result = ((a + b) * 0.5f - a).hadamardProduct(b) / 3.0f;
+                sink = result.at(0, 0);
+            };
+
+            runner.run("matrix/temporaries_heap", { { "n", n } }, 0.0, items, temporaries);
+
+            MatrixArena& arena = threadArena();
+            runner.run("matrix/temporaries_arena", { { "n", n } }, 0.0, items, [&] {
+                {
+                    AllocatorScope scope(arena);
+                    temporaries();
+                }
+
+                arena.reset();
+            });
+        }
+    }
+
+    void activationBenchmarks(Runner& runner) {
+        std::vector<std::pair<const char*, ActivationPtr>> activations;
+        activations.emplace_back("linear", Activation::Linear());
+        activations.emplace_back("relu", Activation::ReLU());
+        activations.emplace_back("leaky_relu", Activation::LeakyReLU(0.01f));
+        activations.emplace_back("sigmoid", Activation::Sigmoid());
+        activations.emplace_back("logistic", Activation::Logistic(1.0f, 1.0f));
+        activations.emplace_back("tanh", Activation::Tanh());
+
+        for (int n : { 1024, 65536 }) {
+            std::mt19937 engine(5);
+            Vector input = randomVector(n, engine);
+            Vector output(n);
+
+            for (const auto& [name, activation] : activations) {
+                std::string group = std::string("activation/") + name;
+                const IActivation& f = *activation;
+
+                runner.run(group + "/apply", { { "n", n } }, 0.0, n, [&] {
+                    f.apply(input.rawData(), output.rawData(), static_cast<size_t>(n));
+                    sink = output[0];
+                });
+
+                runner.run(group + "/derive", { { "n", n } }, 0.0, n, [&] {
+                    f.deriveInto(input.rawData(), output.rawData(), static_cast<size_t>(n));
+                    sink = output[0];
+                });
+            }
+        }
+    }
+
+    void networkBenchmarks(Runner& runner) {
+        for (int width : { 64, 256, 1024 }) {
+            for (int depth : { 1, 3 }) {
+                NeuralNetwork nn = makeNetwork(width, depth);
+                std::vector<std::pair<std::string, int>> shape { { "width", width }, { "depth", depth } };
+
+                // A multiply-add per weight; activations and biases are not counted
+                double forwardFlops = 2.0 * nn.parameterCount();
+
+                std::mt19937 engine(11);
+                Vector input = randomVector(width, engine);
+                Vector expected = randomVector(10, engine);
+
+                runner.run("forward/single", shape, forwardFlops, 1.0, [&] {
+                    nn.setInput(input);
+                    nn.forwardPropogate();
+                    sink = nn.getNeuronValue(depth + 1, 0);
+                });
+
+                const int batch = 64;
+                Matrix inputs = Matrix::xavierMatrix(batch, width, 13);
+                std::vector<std::pair<std::string, int>> batchShape = shape;
+                batchShape.emplace_back("batch", batch);
+
+                runner.run("forward/batched", batchShape, forwardFlops * batch, batch, [&] {
+                    MatrixView outputs = nn.forwardPropogate(inputs);
+                    sink = outputs.at(0, 0);
+                });
+
+                // Backward pass alone, from the activations of one forward pass
+                nn.setInput(input);
+                nn.forwardPropogate();
+                runner.run("backprop", shape, 2.0 * forwardFlops, 1.0, [&] {
+                    auto [deltaWeights, deltaBiases, loss] = nn.backPropagate(expected, 0.01f);
+                    sink = loss;
+                });
+
+                // One epoch of each training mode over a synthetic dataset. The tiny learning rate keeps the
+                // weights from drifting far while the epoch is repeated
+                const int examples = width >= 1024 ? 128 : 512;
+                std::vector<Vector> features;
+                std::vector<Vector> labels;
+                for (int i = 0; i < examples; i++) {
+                    features.push_back(randomVector(width, engine));
+                    labels.push_back(randomVector(10, engine));
+                }
+
+                Dataset data(features, labels);
+                std::vector<std::pair<std::string, int>> trainShape = shape;
+                trainShape.emplace_back("examples", examples);
+
+                double epochFlops = 3.0 * forwardFlops * examples;
+
+                runner.run("train/sgd", trainShape, epochFlops, examples, [&] {
+                    std::vector<float> losses = nn.train(features, labels, 1e-6f, 1, true);
+                    sink = losses.back();
+                });
+
+                runner.run("train/full_batch", trainShape, epochFlops, examples, [&] {
+                    std::vector<float> losses = nn.train(features, labels, 1e-6f, 1, false);
+                    sink = losses.back();
+                });
+
+                std::vector<std::pair<std::string, int>> minibatchShape = trainShape;
+                minibatchShape.emplace_back("batch", 32);
+
+                runner.run("train/minibatch", minibatchShape, epochFlops, examples, [&] {
+                    std::vector<float> losses = nn.trainMinibatch(data, 1e-6f, 1, 32);
+                    sink = losses.back();
+                });
+
+                // Int8 inference next to forward/single, calibrated on the synthetic examples
+                QuantizedNetwork quantized = QuantizedNetwork::quantize(nn, data);
+                QuantizedContext quantizedContext = quantized.createContext();
+
+                runner.run("int8/predict", shape, forwardFlops, 1.0, [&] {
+                    const Vector& output = quantized.predict(input, quantizedContext);
+                    sink = output[0];
+                });
+
+                // 16-bit weight storage, widened to fp32 as the forward pass reads it
+                for (auto [name, precision] : { std::pair<const char*, WeightPrecision>{ "bf16", WeightPrecision::BFloat16 },
+                                                std::pair<const char*, WeightPrecision>{ "fp16", WeightPrecision::Float16 } }) {
+                    nn.setWeightPrecision(precision);
+
+                    runner.run(std::string("forward/single_") + name, shape, forwardFlops, 1.0, [&] {
+                        nn.setInput(input);
+                        nn.forwardPropogate();
+                        sink = nn.getNeuronValue(depth + 1, 0);
+                    });
+
+                    runner.run(std::string("forward/batched_") + name, batchShape, forwardFlops * batch, batch, [&] {
+                        MatrixView outputs = nn.forwardPropogate(inputs);
+                        sink = outputs.at(0, 0);
+                    });
+                }
+
+                nn.setWeightPrecision(WeightPrecision::Float32);
+
+                // Weight layouts picked for inference: packed panels or column-major copies of the weights
+                nn.setWorkload(Workload::Inference);
+                runner.run("forward/single_inference_layout", shape, forwardFlops, 1.0, [&] {
+                    nn.setInput(input);
+                    nn.forwardPropogate();
+                    sink = nn.getNeuronValue(depth + 1, 0);
+                });
+                nn.setWorkload(Workload::Training);
+            }
+        }
+    }
+
+    void usage(const char* program) {
+        std::cerr << "usage: " << program << " [--filter TEXT] [--json PATH] [--min-time SECONDS] [--repetitions N]" << std::endl;
+        std::exit(2);
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (i + 1 >= argc)
+            usage(argv[0]);
+
+        if (arg == "--filter")
+            options.filter = argv[++i];
+        else if (arg == "--json")
+            options.jsonPath = argv[++i];
+        else if (arg == "--min-time")
+            options.minSeconds = std::atof(argv[++i]);
+        else if (arg == "--repetitions")
+            options.repetitions = std::atoi(argv[++i]);
+        else
+            usage(argv[0]);
+    }
+
+    if (options.minSeconds <= 0.0 || options.repetitions <= 0)
+        usage(argv[0]);
+
+    Runner runner(options);
+    Runner::printHeader();
+
+    matrixBenchmarks(runner);
+    activationBenchmarks(runner);
+    networkBenchmarks(runner);
+
+    if (runner.empty())
+        std::cerr << "No benchmark matched the filter" << std::endl;
+
+    if (!options.jsonPath.empty())
+        runner.writeJson(options.jsonPath);
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Compare two bbdnn_bench JSON result files and flag regressions.
+
+    bench/compare_bench.py BASELINE.json CURRENT.json [--threshold PERCENT] [--metric median_ns|min_ns]
+
+A benchmark regresses when its time in CURRENT exceeds BASELINE by more than the threshold
+(5% by default). Exits with status 1 if anything regressed, so it can gate a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data.get("context", {}), {b["name"]: b for b in data["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Diff two bbdnn_bench --json outputs.")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent slowdown that counts as a regression")
+    parser.add_argument("--metric", choices=("median_ns", "min_ns"), default="median_ns")
+    args = parser.parse_args()
+
+    base_context, baseline = load(args.baseline)
+    current_context, current = load(args.current)
+
+    for key in ("simd", "compiler", "hardware_threads", "profiling"):
+        if base_context.get(key) != current_context.get(key):
+            print(f"note: {key} differs: {base_context.get(key)} -> {current_context.get(key)}")
+
+    regressions = []
+    improvements = 0
+    width = max((len(name) for name in baseline), default=9)
+
+    print(f"{'benchmark':<{width}} {'baseline us':>13} {'current us':>13} {'change':>9}")
+
+    for name, base in baseline.items():
+        if name not in current:
+            print(f"{name:<{width}} {base[args.metric] / 1e3:13.3f} {'missing':>13}")
+            continue
+
+        before = base[args.metric]
+        after = current[name][args.metric]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append((name, change))
+        elif change < -args.threshold:
+            flag = "  faster"
+            improvements += 1
+
+        print(f"{name:<{width}} {before / 1e3:13.3f} {after / 1e3:13.3f} {change:+8.1f}%{flag}")
+
+    for name in current:
+        if name not in baseline:
+            print(f"{name:<{width}} {'new':>13} {current[name][args.metric] / 1e3:13.3f}")
+
+    print(f"\n{len(regressions)} regressed and {improvements} improved beyond {args.threshold:g}%")
+    for name, change in sorted(regressions, key=lambda r: -r[1]):
+        print(f"  {name}: {change:+.1f}%")
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
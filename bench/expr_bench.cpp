@@ -0,0 +1,75 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "bbdnn/Expr.hpp"
+
+using namespace bbdnn;
+
+namespace {
+
+    // Repeat fn until at least minSeconds elapsed and return the mean seconds per call
+    template <typename Fn>
+    double timeIt(Fn&& fn, double minSeconds = 0.2) {
+        using Clock = std::chrono::steady_clock;
+
+        fn(); // warm-up
+        int iterations = 0;
+        auto start = Clock::now();
+        double elapsed = 0;
+
+        do {
+            fn();
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        return elapsed / iterations;
+    }
+
+    void report(const char* name, int n, double eagerSeconds, double lazySeconds) {
+        std::cout << std::left << std::setw(34) << name << std::right << std::setw(6) << n
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(12) << eagerSeconds * 1e6
+                  << std::setw(12) << lazySeconds * 1e6
+                  << std::setw(9) << eagerSeconds / lazySeconds << "x" << std::endl;
+    }
+
+}
+
+int main() {
+    std::cout << std::left << std::setw(34) << "expression" << std::right << std::setw(6) << "n"
+              << std::setw(12) << "eager us" << std::setw(12) << "lazy us" << std::setw(10) << "speedup" << std::endl;
+
+    for (int n : { 64, 256, 1024 }) {
+        Matrix weights = Matrix::xavierMatrix(n, n, 1);
+        Matrix delta = Matrix::xavierMatrix(n, n, 2);
+        Matrix other = Matrix::xavierMatrix(n, n, 3);
+        Matrix accumulator(n, n, 0.0f);
+        Matrix result(n, n, 0.0f);
+        float exampleWeight = 0.25f;
+
+        // Full-batch accumulation in NeuralNetwork::train
+        report("acc += delta * w", n,
+            timeIt([&] { accumulator += delta * exampleWeight; }),
+            timeIt([&] { accumulator += expr::lazy(delta) * exampleWeight; }));
+
+        // Parameter step in NeuralNetwork::takeStep
+        report("w = w - delta", n,
+            timeIt([&] { weights = weights - delta; }),
+            timeIt([&] { weights = expr::lazy(weights) - delta; }));
+
+        // Learning-rate scaled step with the gradient scaling folded in
+        report("w = w - delta * lr", n,
+            timeIt([&] { weights = weights - delta * 0.01f; }),
+            timeIt([&] { weights -= expr::lazy(delta) * 0.01f; }));
+
+        // Generic three-operand chain
+        report("r = a + b * s - c", n,
+            timeIt([&] { result = weights + delta * 0.5f - other; }),
+            timeIt([&] { result = expr::lazy(weights) + expr::lazy(delta) * 0.5f - other; }));
+    }
+
+    return 0;
+}
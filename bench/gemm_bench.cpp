@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "bbdnn/Matrix.hpp"
+
+using namespace bbdnn;
+
+namespace {
+
+    struct Shape {
+        const char* name;
+        int m;
+        int k;
+        int n;
+    };
+
+    // The triple loop Matrix::operator* used before the blocked GEMM
+    Matrix naiveMultiply(const Matrix& a, const Matrix& b) {
+        Matrix product(a.Rows(), b.Cols(), 0.0f);
+
+        for (int r = 0; r < a.Rows(); r++)
+            for (int c = 0; c < b.Cols(); c++)
+                for (int i = 0; i < a.Cols(); i++)
+                    product.at(r, c) += a.at(r, i) * b.at(i, c);
+
+        return product;
+    }
+
+    // Repeat fn until at least minSeconds elapsed and return the mean seconds per call
+    template <typename Fn>
+    double timeIt(Fn&& fn, double minSeconds = 0.2) {
+        using Clock = std::chrono::steady_clock;
+
+        fn(); // warm-up
+        int iterations = 0;
+        auto start = Clock::now();
+        double elapsed = 0;
+
+        do {
+            fn();
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        return elapsed / iterations;
+    }
+
+    float maxAbsDiff(const Matrix& a, const Matrix& b) {
+        float diff = 0;
+
+        for (int r = 0; r < a.Rows(); r++)
+            for (int c = 0; c < a.Cols(); c++)
+                diff = std::fmax(diff, std::fabs(a.at(r, c) - b.at(r, c)));
+
+        return diff;
+    }
+
+}
+
+int main() {
+    std::vector<Shape> shapes {
+        { "square 64",         64,   64,   64 },
+        { "square 128",       128,  128,  128 },
+        { "square 256",       256,  256,  256 },
+        { "square 512",       512,  512,  512 },
+        { "outer 512x1x512",  512,    1,  512 },
+        { "gemv 1024x1024x1", 1024, 1024,   1 },
+        { "vecmat 1x1024x1024", 1, 1024, 1024 },
+        { "skinny 1024x32x1024", 1024, 32, 1024 },
+        { "skinny 32x1024x32",  32, 1024,  32 },
+    };
+
+    std::cout << std::left << std::setw(22) << "shape"
+              << std::right << std::setw(14) << "naive GF/s"
+              << std::setw(14) << "gemm GF/s"
+              << std::setw(10) << "speedup"
+              << std::setw(12) << "max |diff|" << std::endl;
+
+    for (const Shape& shape : shapes) {
+        Matrix a = Matrix::xavierMatrix(shape.m, shape.k, 1);
+        Matrix b = Matrix::xavierMatrix(shape.k, shape.n, 2);
+
+        double flops = 2.0 * shape.m * shape.n * shape.k;
+
+        Matrix reference = naiveMultiply(a, b);
+        Matrix result = a * b;
+
+        double naiveSeconds = timeIt([&] { Matrix c = naiveMultiply(a, b); (void)c; });
+        double gemmSeconds = timeIt([&] { Matrix c = a * b; (void)c; });
+
+        std::cout << std::left << std::setw(22) << shape.name << std::right << std::fixed
+                  << std::setprecision(2)
+                  << std::setw(14) << flops / naiveSeconds * 1e-9
+                  << std::setw(14) << flops / gemmSeconds * 1e-9
+                  << std::setw(9) << naiveSeconds / gemmSeconds << "x"
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(12) << maxAbsDiff(reference, result) << std::endl;
+    }
+
+    return 0;
+}
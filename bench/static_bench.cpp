@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "bbdnn/NeuralNetwork.hpp"
+#include "bbdnn/StaticNetwork.hpp"
+
+using namespace bbdnn;
+
+namespace {
+
+    // Repeat fn until at least minSeconds elapsed and return the mean seconds per call
+    template <typename Fn>
+    double timeIt(Fn&& fn, double minSeconds = 0.3) {
+        using Clock = std::chrono::steady_clock;
+
+        fn(); // warm-up
+        long iterations = 0;
+        auto start = Clock::now();
+        double elapsed = 0;
+
+        do {
+            for (int i = 0; i < 64; i++)
+                fn();
+            iterations += 64;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        return elapsed / iterations;
+    }
+
+    // Keep results observable so the timed work is not optimized away
+    volatile float sink;
+
+}
+
+int main() {
+    // The XOR demo topology from examples/nn_demo.cpp
+    NeuralNetwork dynamic(42, {
+        DenseLayer(2, Activation::Linear()),
+        DenseLayer(8, Activation::Tanh()),
+        DenseLayer(8, Activation::Tanh()),
+        DenseLayer(1, Activation::Sigmoid()),
+    });
+
+    using XorNetwork = StaticNetwork<
+        StaticLayer<2, StaticActivation::Linear>,
+        StaticLayer<8, StaticActivation::Tanh>,
+        StaticLayer<8, StaticActivation::Tanh>,
+        StaticLayer<1, StaticActivation::Sigmoid>>;
+
+    std::vector<Vector> features { Vector{0.0f, 0.0f}, Vector{0.0f, 1.0f}, Vector{1.0f, 0.0f}, Vector{1.0f, 1.0f} };
+    std::vector<Vector> labels { Vector{0.0f}, Vector{1.0f}, Vector{1.0f}, Vector{0.0f} };
+    std::vector<XorNetwork::Input> staticFeatures { {0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f} };
+    std::vector<XorNetwork::Output> staticLabels { {0.0f}, {1.0f}, {1.0f}, {0.0f} };
+
+    dynamic.train(features, labels, 0.05f, 2000, false);
+
+    XorNetwork model(dynamic);
+
+    float maxDiff = 0;
+    for (size_t i = 0; i < features.size(); i++)
+        maxDiff = std::fmax(maxDiff, std::fabs(dynamic.predict(features[i])[0] - model.predict(staticFeatures[i])[0]));
+
+    size_t example = 0;
+    double dynamicPredict = timeIt([&] { sink = dynamic.predict(features[example++ & 3])[0]; });
+    double staticPredict = timeIt([&] { sink = model.predict(staticFeatures[example++ & 3])[0]; });
+
+    // One per-example SGD step: the body of NeuralNetwork::train with isStochastic = true
+    double dynamicStep = timeIt([&] {
+        size_t i = example++ & 3;
+        dynamic.setInput(features[i]);
+        dynamic.forwardPropogate();
+        auto [deltaWeights, deltaBiases, ssr] = dynamic.backPropagate(labels[i], 0.01f);
+        auto [newWeights, newBiases] = dynamic.takeStep(deltaWeights, deltaBiases);
+        dynamic.updateParameters(std::move(newWeights), std::move(newBiases));
+        sink = ssr;
+    });
+    double staticStep = timeIt([&] {
+        size_t i = example++ & 3;
+        sink = model.trainStep(staticFeatures[i], staticLabels[i], 0.01f);
+    });
+
+    std::cout << "XOR 2-8-8-1, max |dynamic - static| prediction: " << maxDiff << std::endl;
+    std::cout << std::left << std::setw(12) << "operation" << std::right
+              << std::setw(14) << "dynamic ns" << std::setw(14) << "static ns" << std::setw(10) << "speedup" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(12) << "predict" << std::right << std::setw(14) << dynamicPredict * 1e9
+              << std::setw(14) << staticPredict * 1e9 << std::setw(9) << dynamicPredict / staticPredict << "x" << std::endl;
+    std::cout << std::left << std::setw(12) << "train step" << std::right << std::setw(14) << dynamicStep * 1e9
+              << std::setw(14) << staticStep * 1e9 << std::setw(9) << dynamicStep / staticStep << "x" << std::endl;
+
+    return 0;
+}
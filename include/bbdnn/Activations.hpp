@@ -1,14 +1,37 @@
 #ifndef ACTIVATIONS_HPP
 #define ACTIVATIONS_HPP
 
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <memory>
 #include <concepts>
 #include <type_traits>
 
 namespace bbdnn {
 
+    /// Identifies the built-in activations so kernels can specialize on them.
+    enum class ActivationKind {
+        Custom,
+        Linear,
+        ReLU,
+        LeakyReLU,
+        Sigmoid,
+        Logistic,
+        Tanh
+    };
+
     /// Activation function interface.
+    ///
+    /// The span methods apply() and deriveInto() default to calling the scalar methods once per element.
+    /// The built-in activations override them with SIMD kernels that evaluate exp and tanh with
+    /// polynomial approximations instead of std::exp and std::tanh:
+    /// - exp: Cody-Waite range reduction and a degree-6 polynomial, max relative error 1e-7 on [-87, 88].
+    ///   Below -87.3 it flushes to 0 and above 88 it overflows to +inf, so sigmoid and tanh saturate
+    ///   exactly; NaN propagates.
+    /// - tanh: x + x^3 P(x^2) below |x| = 0.625 and 1 - 2 / (exp(2|x|) + 1) above it, max absolute error 1e-7
+    ///   and max relative error 1.5e-7.
+    /// - sigmoid and logistic: 1 / (1 + exp(-x)) on the exp approximation, max relative error 1.5e-7.
     struct IActivation {
         /// Construct a base activation.
         IActivation() = default;
@@ -19,6 +42,16 @@ namespace bbdnn {
         virtual float operator()(float x) const = 0;
         /// Derivative of activation at a value.
         virtual float derive(float x) const = 0;
+
+        /// Apply activation to n values: out[i] = f(in[i]). in and out may alias.
+        virtual void apply(const float* in, float* out, size_t n) const;
+        /// Derivative of activation at n values: out[i] = f'(in[i]). in and out may alias.
+        virtual void deriveInto(const float* in, float* out, size_t n) const;
+
+        /// Which built-in activation this is, or Custom for user-defined activations.
+        virtual ActivationKind kind() const;
+        /// The p0 and p1 a KernelTable activation kernel takes for kind(); zero for activations without parameters.
+        virtual std::array<float, 2> kernelParameters() const;
     
         /// Clone this activation.
         virtual std::unique_ptr<IActivation> clone() const =  0;
@@ -37,6 +70,12 @@ namespace bbdnn {
 
         /// Derivative of activation at a value.
         float derive(float x) const override;
+        /// Apply activation to n values with a SIMD kernel.
+        void apply(const float* in, float* out, size_t n) const override;
+        /// Derivative of activation at n values with a SIMD kernel.
+        void deriveInto(const float* in, float* out, size_t n) const override;
+        /// Built-in activation kind.
+        ActivationKind kind() const override;
         
         /// Clone this activation.
         ActivationPtr clone() const override;
@@ -51,6 +90,12 @@ namespace bbdnn {
         float operator()(float x) const override;
         /// Derivative of activation at a value.
         float derive(float x) const override;
+        /// Apply activation to n values with a SIMD kernel.
+        void apply(const float* in, float* out, size_t n) const override;
+        /// Derivative of activation at n values with a SIMD kernel.
+        void deriveInto(const float* in, float* out, size_t n) const override;
+        /// Built-in activation kind.
+        ActivationKind kind() const override;
         /// Clone this activation.
         ActivationPtr clone() const override;
     };
@@ -67,6 +112,14 @@ namespace bbdnn {
         float operator()(float x) const override;
         /// Derivative of activation at a value.
         float derive(float x) const override;
+        /// Apply activation to n values with a SIMD kernel.
+        void apply(const float* in, float* out, size_t n) const override;
+        /// Derivative of activation at n values with a SIMD kernel.
+        void deriveInto(const float* in, float* out, size_t n) const override;
+        /// Built-in activation kind.
+        ActivationKind kind() const override;
+        /// Kernel parameters: alpha.
+        std::array<float, 2> kernelParameters() const override;
         /// Clone this activation.
         ActivationPtr clone() const override;
     };
@@ -80,6 +133,12 @@ namespace bbdnn {
         float operator()(float x) const override;
         /// Derivative of activation at a value.
         float derive(float x) const override;
+        /// Apply activation to n values with a SIMD kernel.
+        void apply(const float* in, float* out, size_t n) const override;
+        /// Derivative of activation at n values with a SIMD kernel.
+        void deriveInto(const float* in, float* out, size_t n) const override;
+        /// Built-in activation kind.
+        ActivationKind kind() const override;
         /// Clone this activation.
         ActivationPtr clone() const override;
     };
@@ -98,6 +157,14 @@ namespace bbdnn {
         float operator()(float x) const override;
         /// Derivative of activation at a value.
         float derive(float x) const override;
+        /// Apply activation to n values with a SIMD kernel.
+        void apply(const float* in, float* out, size_t n) const override;
+        /// Derivative of activation at n values with a SIMD kernel.
+        void deriveInto(const float* in, float* out, size_t n) const override;
+        /// Built-in activation kind.
+        ActivationKind kind() const override;
+        /// Kernel parameters: L and K.
+        std::array<float, 2> kernelParameters() const override;
         /// Clone this activation.
         ActivationPtr clone() const override;
     };
@@ -111,6 +178,12 @@ namespace bbdnn {
         float operator()(float x) const override;
         /// Derivative of activation at a value.
         float derive(float x) const override;
+        /// Apply activation to n values with a SIMD kernel.
+        void apply(const float* in, float* out, size_t n) const override;
+        /// Derivative of activation at n values with a SIMD kernel.
+        void deriveInto(const float* in, float* out, size_t n) const override;
+        /// Built-in activation kind.
+        ActivationKind kind() const override;
         /// Clone this activation.
         ActivationPtr clone() const override;
     };
@@ -0,0 +1,42 @@
+#ifndef ALIGNEDBUFFER_HPP
+#define ALIGNEDBUFFER_HPP
+
+#include <cstddef>
+
+namespace bbdnn {
+
+    /// Owning, zero-filled array of floats starting on a 64-byte boundary. Copies are deep.
+    class AlignedBuffer {
+        float* values = nullptr;
+        size_t count = 0;
+
+    public:
+        /// Create an empty buffer.
+        AlignedBuffer() = default;
+        /// Create a buffer of count zeros.
+        explicit AlignedBuffer(size_t count);
+        /// Copy-construct from another buffer.
+        AlignedBuffer(const AlignedBuffer& other);
+        /// Move-construct, leaving other empty.
+        AlignedBuffer(AlignedBuffer&& other) noexcept;
+        /// Free the storage.
+        ~AlignedBuffer();
+
+        /// Assign a deep copy of another buffer.
+        AlignedBuffer& operator=(const AlignedBuffer& other);
+        /// Move-assign, leaving other empty.
+        AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
+
+        /// Pointer to the first value (mutable).
+        float* data();
+        /// Pointer to the first value (const).
+        const float* data() const;
+        /// Number of values.
+        size_t size() const;
+        /// Whether the buffer holds no values.
+        bool empty() const;
+    };
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace bbdnn {
+
+    /// Byte alignment of every Matrix buffer: one cache line, and one AVX-512 register.
+    constexpr size_t MATRIX_ALIGNMENT = 64;
+
+    /// Usage counters of a Matrix allocator.
+    struct AllocatorStats {
+        /// Bytes handed out and not yet reclaimed, in whole cache lines for arenas and pools.
+        size_t bytesInUse = 0;
+        /// Highest bytesInUse seen. For an arena this is the capacity that serves every pass from one block.
+        size_t peakBytes = 0;
+        /// Buffers handed out and not yet returned.
+        size_t liveAllocations = 0;
+        /// Buffers handed out in total.
+        uint64_t totalAllocations = 0;
+    };
+
+    /// Source of Matrix storage. Every buffer starts on a MATRIX_ALIGNMENT boundary, and a Matrix returns its
+    /// buffer to the allocator that supplied it, which must outlive the matrix.
+    struct IMatrixAllocator {
+        /// Construct a base allocator.
+        IMatrixAllocator() = default;
+        /// Virtual destructor for interface.
+        virtual ~IMatrixAllocator() = default;
+
+        /// Storage for count floats, or nullptr when count is 0.
+        virtual float* allocate(size_t count) = 0;
+        /// Return a buffer from allocate along with the count it was allocated for.
+        virtual void deallocate(float* data, size_t count) = 0;
+        /// Current usage counters.
+        virtual AllocatorStats stats() const = 0;
+    };
+
+    /// Bump allocator for the temporaries of one example or batch. Buffers are carved from a block in order
+    /// and only reclaimed by reset, apart from the most recent one, which is popped when returned first.
+    /// When a block fills, a larger one is chained on and reset merges them, so an arena warms up to a
+    /// single block that holds a whole pass. Not thread-safe: each thread uses its own (see threadArena).
+    class MatrixArena : public IMatrixAllocator {
+        struct Block {
+            float* values;
+            size_t capacity;
+        };
+
+        // Blocks in allocation order; only the last has room left
+        std::vector<Block> blocks;
+        // Floats used in the last block
+        size_t top = 0;
+        size_t firstBlockBytes;
+        AllocatorStats counters;
+
+        void addBlock(size_t minimumCount);
+        void releaseBlocks();
+
+    public:
+        /// Create an arena whose first block holds initialBytes, allocated on first use.
+        explicit MatrixArena(size_t initialBytes = 1 << 20);
+        /// Free the blocks. Matrices still using them are left dangling.
+        ~MatrixArena();
+
+        MatrixArena(const MatrixArena& other) = delete;
+        MatrixArena& operator=(const MatrixArena& other) = delete;
+
+        float* allocate(size_t count) override;
+        void deallocate(float* data, size_t count) override;
+        AllocatorStats stats() const override;
+
+        /// Reclaim every buffer at once, at an example or batch boundary. Throws std::logic_error while any
+        /// matrix still uses the arena's storage.
+        void reset();
+        /// Bytes reserved across all blocks.
+        size_t capacity() const;
+    };
+
+    /// Size-class pool for long-lived matrices such as weights and optimizer state. Sizes are rounded up to a
+    /// class at most 25% larger, and returned buffers wait on their class's free list for the next matrix of
+    /// that class instead of going back to the system. Thread-safe.
+    class MatrixPool : public IMatrixAllocator {
+        mutable std::mutex mutex;
+        // Free buffers keyed by class size in cache lines
+        std::map<size_t, std::vector<float*>> freeLists;
+        size_t cached = 0;
+        AllocatorStats counters;
+
+    public:
+        /// Create an empty pool.
+        MatrixPool() = default;
+        /// Free the cached buffers. Buffers still in use are left dangling.
+        ~MatrixPool();
+
+        MatrixPool(const MatrixPool& other) = delete;
+        MatrixPool& operator=(const MatrixPool& other) = delete;
+
+        float* allocate(size_t count) override;
+        void deallocate(float* data, size_t count) override;
+        AllocatorStats stats() const override;
+
+        /// Bytes held on the free lists.
+        size_t cachedBytes() const;
+        /// Give the cached buffers back to the system.
+        void trim();
+    };
+
+    /// Routes the Matrix allocations of the current thread to an allocator for the enclosing block,
+    /// restoring the previous one on exit.
+    class AllocatorScope {
+        IMatrixAllocator* previous;
+
+    public:
+        /// Make allocator the current thread's Matrix allocator.
+        explicit AllocatorScope(IMatrixAllocator& allocator);
+        /// Restore the previous allocator.
+        ~AllocatorScope();
+
+        AllocatorScope(const AllocatorScope& other) = delete;
+        AllocatorScope& operator=(const AllocatorScope& other) = delete;
+    };
+
+    /// The allocator new Matrix storage comes from on this thread: the innermost AllocatorScope's, else the default.
+    IMatrixAllocator& currentAllocator();
+
+    /// Set the allocator used outside any AllocatorScope, on every thread. nullptr restores the heap.
+    void setDefaultAllocator(IMatrixAllocator* allocator);
+
+    /// The built-in heap allocator (aligned operator new), the default until setDefaultAllocator.
+    IMatrixAllocator& heapAllocator();
+
+    /// This thread's arena, created with the default block size on first use.
+    MatrixArena& threadArena();
+
+}
+
+#endif
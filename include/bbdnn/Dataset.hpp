@@ -0,0 +1,92 @@
+#ifndef DATASET_HPP
+#define DATASET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bbdnn/Matrix.hpp"
+
+namespace bbdnn {
+
+    /// Version written by Dataset::save; Dataset::map rejects any other version.
+    constexpr uint32_t DATASET_FORMAT_VERSION = 1;
+
+    /// Examples stored as two contiguous row-major buffers, one for features and one for labels.
+    ///
+    /// Row i of the features starts at featureRow(i) and rows follow each other with no padding, so any run
+    /// of consecutive rows is already a (rows x featureSize) batch that can be fed to the network without
+    /// a copy. The rows either live in owned storage or point into a memory-mapped dataset file.
+    class Dataset {
+        int featureCount;
+        int labelCount;
+        size_t rowCount = 0;
+
+        std::vector<float> featureStorage;
+        std::vector<float> labelStorage;
+
+        // Set when the rows live in a mapped file instead of the owned storage
+        std::shared_ptr<void> mapping;
+        const float* mappedFeatures = nullptr;
+        const float* mappedLabels = nullptr;
+
+    public:
+        /// Create an empty dataset for examples of the given sizes.
+        Dataset(int featureSize, int labelSize);
+
+        /// Copy per-example vectors into contiguous storage.
+        Dataset(const std::vector<Vector>& features, const std::vector<Vector>& labels);
+
+        /// Map a dataset file written by save. Rows are paged in on first use, so the file may be larger
+        /// than memory; the mapping is private and released with the last copy of the dataset.
+        static Dataset map(const std::string& path);
+
+        /// Write the dataset to a binary file.
+        ///
+        /// Layout (little-endian): a 64-byte header (magic "BBDNNDAT", uint32 version, uint32 feature size,
+        /// uint32 label size, 4 reserved bytes, uint64 row count, uint64 features offset, uint64 labels offset, uint64 file size),
+        /// then the feature rows and the label rows as raw floats, each blob starting on a 64-byte boundary.
+        void save(const std::string& path) const;
+
+        /// Reserve owned storage for a number of rows.
+        void reserve(size_t rows);
+
+        /// Append one example; features and labels must hold featureSize() and labelSize() values.
+        /// Throws on a mapped dataset, whose rows cannot grow.
+        void append(const float* features, const float* labels);
+        /// Append one example from vectors.
+        void append(const Vector& features, const Vector& labels);
+
+        /// Remove every row, keeping owned capacity for reuse and dropping any mapping.
+        void clear();
+
+        /// Number of examples.
+        size_t size() const;
+        /// Whether the dataset has no examples.
+        bool empty() const;
+        /// Values per feature row.
+        int featureSize() const;
+        /// Values per label row.
+        int labelSize() const;
+        /// Whether the rows point into a mapped file.
+        bool isMapped() const;
+
+        /// Start of feature row i.
+        const float* featureRow(size_t i) const;
+        /// Start of label row i.
+        const float* labelRow(size_t i) const;
+        /// View of count feature rows starting at row first, as one (count x featureSize) batch.
+        MatrixView featureRows(size_t first, int count) const;
+        /// View of count label rows starting at row first, as one (count x labelSize) batch.
+        MatrixView labelRows(size_t first, int count) const;
+
+        /// Start of the feature rows.
+        const float* featureData() const;
+        /// Start of the label rows.
+        const float* labelData() const;
+    };
+
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef DATASET_STREAM_HPP
+#define DATASET_STREAM_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bbdnn/Dataset.hpp"
+
+namespace bbdnn {
+
+    /// Source of examples read a chunk at a time.
+    class IChunkReader {
+    public:
+        virtual ~IChunkReader() = default;
+
+        /// Values per feature row.
+        virtual int featureSize() const = 0;
+        /// Values per label row.
+        virtual int labelSize() const = 0;
+
+        /// Replace chunk's rows with up to maxRows of the next examples; fewer (or none) at the end of the source.
+        virtual void readChunk(Dataset& chunk, size_t maxRows) = 0;
+        /// Go back to the first example.
+        virtual void rewind() = 0;
+    };
+
+    /// Reads a CSV file of numbers, one example per line: the feature columns followed by labelCount label columns.
+    class CsvChunkReader : public IChunkReader {
+        std::ifstream file;
+        std::string path;
+        std::string line;
+        std::vector<float> row;
+        std::streampos dataStart;
+        int featureCount = 0;
+        int labelCount;
+        size_t lineNumber = 0;
+        size_t firstLineNumber = 0;
+
+    public:
+        /// Open a CSV file. With hasHeader set the first line is skipped. The feature count is taken
+        /// from the first example's column count.
+        CsvChunkReader(const std::string& Path, int LabelCount, bool hasHeader = false);
+
+        int featureSize() const override;
+        int labelSize() const override;
+        void readChunk(Dataset& chunk, size_t maxRows) override;
+        void rewind() override;
+    };
+
+    /// Reads an IDX image file and its matching IDX label file (the MNIST layout).
+    ///
+    /// Each image becomes one feature row of its values times featureScale. A one-dimensional label file
+    /// holds class indices, which become one-hot rows of classCount values; otherwise each label entry is
+    /// read as a row of values and classCount is ignored.
+    class IdxChunkReader : public IChunkReader {
+        struct IdxFile {
+            std::ifstream stream;
+            std::string path;
+            std::streampos dataStart;
+            int typeCode = 0;
+            size_t elementSize = 0;
+            size_t count = 0;
+            size_t rowSize = 0;
+            int dimensions = 0;
+            std::vector<char> buffer;
+        };
+
+        IdxFile images;
+        IdxFile labels;
+        int classCount;
+        float featureScale;
+        size_t position = 0;
+        std::vector<float> featureRow;
+        std::vector<float> labelRow;
+
+        static void open(IdxFile& file, const std::string& path);
+        static void readValues(IdxFile& file, size_t rows, float scale, float* out);
+
+    public:
+        /// Open an image file and its label file. Throws if the headers are invalid or the counts differ.
+        IdxChunkReader(const std::string& imagesPath, const std::string& labelsPath, int ClassCount, float FeatureScale = 1.0f);
+
+        int featureSize() const override;
+        int labelSize() const override;
+        void readChunk(Dataset& chunk, size_t maxRows) override;
+        void rewind() override;
+    };
+
+    /// Streams a chunk reader's examples with a background thread that reads the next chunk while the
+    /// caller works on the current one, so only a few chunks are ever resident.
+    class DatasetStream {
+        std::unique_ptr<IChunkReader> reader;
+        size_t chunkRows;
+
+        std::thread prefetcher;
+        std::mutex mutex;
+        std::condition_variable changed;
+
+        // Chunk being filled by the prefetcher and the chunk waiting for next()
+        Dataset filling;
+        Dataset ready;
+        bool hasReady = false;
+        bool finished = false;
+        bool stopping = false;
+        std::exception_ptr error;
+
+        void prefetch();
+        void start();
+        void stop();
+
+    public:
+        /// Stream a reader's examples chunkRows at a time and start prefetching the first chunk.
+        DatasetStream(std::unique_ptr<IChunkReader> Reader, size_t ChunkRows);
+
+        /// Stop the prefetch thread.
+        ~DatasetStream();
+
+        DatasetStream(const DatasetStream& other) = delete;
+        DatasetStream& operator=(const DatasetStream& other) = delete;
+
+        /// Stream a CSV file; see CsvChunkReader.
+        static std::unique_ptr<DatasetStream> csv(const std::string& path, int labelCount, size_t chunkRows, bool hasHeader = false);
+        /// Stream an IDX image and label file pair; see IdxChunkReader.
+        static std::unique_ptr<DatasetStream> idx(const std::string& imagesPath, const std::string& labelsPath, int classCount, size_t chunkRows, float featureScale = 1.0f);
+
+        /// Swap the next chunk into chunk and return true, or return false at the end of the source.
+        /// The chunk passed in is handed to the prefetcher for reuse, so steady-state streaming does not allocate.
+        /// Rethrows any error the reader hit.
+        bool next(Dataset& chunk);
+
+        /// Restart from the first example.
+        void rewind();
+
+        /// Values per feature row.
+        int featureSize() const;
+        /// Values per label row.
+        int labelSize() const;
+        /// Maximum rows per chunk.
+        size_t chunkSize() const;
+    };
+
+}
+
+#endif
@@ -17,35 +17,69 @@ namespace bbdnn {
         Vector activatedValues;
         Vector unactivatedValues;
 
+        // Row-per-sample values for batched propagation, sized for the largest batch so far; the first
+        // batchRows rows hold the current batch
+        Matrix activatedBatch;
+        Matrix unactivatedBatch;
+        int batchRows = 0;
+
     public:
         /// Construct a layer with neuron count and activation.
         DenseLayer(int neuronCount, ActivationPtr acFunc);
         /// Copy-construct a layer.
         DenseLayer(const DenseLayer& other);
+        /// Move-construct a layer, taking its activation and value storage.
+        DenseLayer(DenseLayer&& other) noexcept;
         /// Destroy the layer.
         ~DenseLayer();
 
         /// Assign from another layer.
         DenseLayer& operator=(DenseLayer& other);
+        /// Move-assign from another layer.
+        DenseLayer& operator=(DenseLayer&& other) noexcept;
 
         /// Get the activation function.
         const ActivationPtr& getActivationFunction() const;
         /// Set the activation function.
         void setActivationFunction(ActivationPtr& newActivation);
 
-        /// Get activated output values.
-        Vector getActivatedVector() const;
-        /// Get pre-activation values.
-        Vector getUnactivatedVector() const;
+        /// View of the activated output values.
+        VectorView getActivatedVector() const;
+        /// View of the pre-activation values.
+        VectorView getUnactivatedVector() const;
         /// Get activated value at index.
         float getActivatedValue(int i) const;
         /// Get pre-activation value at index.
         float getUnactivatedValue(int i) const;
+        /// Get activated output values without copying.
+        const Vector& getActivatedValues() const;
+        /// Get activated output values for writing.
+        Vector& getActivatedValues();
+        /// Get pre-activation values without copying.
+        const Vector& getUnactivatedValues() const;
+        /// Get pre-activation values for writing.
+        Vector& getUnactivatedValues();
 
         /// Set activated values.
-        void setActivatedValues(const Vector& newVals);
+        void setActivatedValues(VectorView newVals);
         /// Set pre-activation values.
-        void setUnactivatedValues(const Vector& newVals);
+        void setUnactivatedValues(VectorView newVals);
+
+        /// Make the current batch batchSize rows. Storage only grows, so a smaller batch after a larger one
+        /// runs on a row prefix of the existing storage.
+        void resizeBatch(int batchSize);
+        /// Number of rows in the current batch.
+        int batchSize() const;
+        /// Get activated batch storage (rows x neurons); the first batchSize() rows are the current batch.
+        const Matrix& getActivatedBatch() const;
+        /// Get activated batch storage for writing; the first batchSize() rows are the current batch.
+        Matrix& getActivatedBatch();
+        /// Get pre-activation batch storage (rows x neurons); the first batchSize() rows are the current batch.
+        const Matrix& getUnactivatedBatch() const;
+        /// Get pre-activation batch storage for writing; the first batchSize() rows are the current batch.
+        Matrix& getUnactivatedBatch();
+        /// Set activated batch values; each row is one sample.
+        void setActivatedBatch(const Matrix& newVals);
     
         /// Number of neurons in the layer.
         int size() const;
@@ -0,0 +1,192 @@
+#ifndef EXPR_HPP
+#define EXPR_HPP
+
+#include <stdexcept>
+#include "bbdnn/Matrix.hpp"
+
+namespace bbdnn {
+
+    /// Lazy element-wise expressions over Matrix and Vector.
+    ///
+    /// Wrap an operand with lazy() and combine it with +, -, * and / as usual; nothing is computed
+    /// until the expression is assigned to a Matrix, which evaluates every element in a single pass
+    /// with no intermediate matrices:
+    ///
+    ///     weights -= expr::lazy(gradient) * learningRate;
+    ///     result = expr::lazy(a) + expr::lazy(b) * s - c;
+    ///
+    /// Expressions keep pointers to their operands, so they must be consumed within the statement
+    /// that builds them. Operators on plain Matrix objects remain eager: b * s without lazy() is the
+    /// member Matrix::operator*, which allocates a temporary before the lazy chain sees it.
+    namespace expr {
+
+        /// CRTP base for all expression nodes.
+        template <typename E>
+        struct Expr {
+            /// Access the concrete node.
+            const E& self() const { return static_cast<const E&>(*this); }
+
+            /// Number of rows of the result.
+            int Rows() const { return self().Rows(); }
+            /// Number of columns of the result.
+            int Cols() const { return self().Cols(); }
+            /// Element i of the result in row-major order.
+            float operator[](int i) const { return self()[i]; }
+        };
+
+        /// Leaf node referencing a matrix's storage.
+        struct Leaf : Expr<Leaf> {
+            const float* data;
+            int rows;
+            int cols;
+
+            explicit Leaf(const Matrix& m) : data(m.rawData()), rows(m.Rows()), cols(m.Cols()) { }
+            explicit Leaf(const MatrixView& v) : data(v.rawData()), rows(v.Rows()), cols(v.Cols()) {
+                if (!v.isContiguous())
+                    throw std::invalid_argument("Lazy expressions need contiguous views.");
+            }
+            explicit Leaf(const VectorView& v) : data(v.rawData()), rows(v.size()), cols(1) {
+                if (!v.isContiguous())
+                    throw std::invalid_argument("Lazy expressions need contiguous views.");
+            }
+
+            int Rows() const { return rows; }
+            int Cols() const { return cols; }
+            float operator[](int i) const { return data[i]; }
+        };
+
+        /// Element-wise binary node.
+        template <typename L, typename R, typename Op>
+        struct Binary : Expr<Binary<L, R, Op>> {
+            L lhs;
+            R rhs;
+
+            Binary(const L& Lhs, const R& Rhs) : lhs(Lhs), rhs(Rhs) {
+                if (lhs.Rows() != rhs.Rows() || lhs.Cols() != rhs.Cols())
+                    throw std::invalid_argument("Matrices must be of the same dimensions");
+            }
+
+            int Rows() const { return lhs.Rows(); }
+            int Cols() const { return lhs.Cols(); }
+            float operator[](int i) const { return Op::apply(lhs[i], rhs[i]); }
+        };
+
+        /// Node combining every element with a scalar.
+        template <typename E, typename Op>
+        struct ScalarOp : Expr<ScalarOp<E, Op>> {
+            E operand;
+            float scalar;
+
+            ScalarOp(const E& Operand, float Scalar) : operand(Operand), scalar(Scalar) { }
+
+            int Rows() const { return operand.Rows(); }
+            int Cols() const { return operand.Cols(); }
+            float operator[](int i) const { return Op::apply(operand[i], scalar); }
+        };
+
+        struct AddOp { static float apply(float a, float b) { return a + b; } };
+        struct SubOp { static float apply(float a, float b) { return a - b; } };
+        struct MulOp { static float apply(float a, float b) { return a * b; } };
+        struct DivOp { static float apply(float a, float b) { return a / b; } };
+
+        /// Start a lazy expression from a matrix or vector.
+        inline Leaf lazy(const Matrix& m) { return Leaf(m); }
+        /// Start a lazy expression from a contiguous matrix view.
+        inline Leaf lazy(const MatrixView& v) { return Leaf(v); }
+        /// Start a lazy expression from a contiguous vector view.
+        inline Leaf lazy(const VectorView& v) { return Leaf(v); }
+
+        template <typename L, typename R>
+        Binary<L, R, AddOp> operator+(const Expr<L>& lhs, const Expr<R>& rhs) { return { lhs.self(), rhs.self() }; }
+        template <typename L>
+        Binary<L, Leaf, AddOp> operator+(const Expr<L>& lhs, const Matrix& rhs) { return { lhs.self(), Leaf(rhs) }; }
+        template <typename R>
+        Binary<Leaf, R, AddOp> operator+(const Matrix& lhs, const Expr<R>& rhs) { return { Leaf(lhs), rhs.self() }; }
+
+        template <typename L, typename R>
+        Binary<L, R, SubOp> operator-(const Expr<L>& lhs, const Expr<R>& rhs) { return { lhs.self(), rhs.self() }; }
+        template <typename L>
+        Binary<L, Leaf, SubOp> operator-(const Expr<L>& lhs, const Matrix& rhs) { return { lhs.self(), Leaf(rhs) }; }
+        template <typename R>
+        Binary<Leaf, R, SubOp> operator-(const Matrix& lhs, const Expr<R>& rhs) { return { Leaf(lhs), rhs.self() }; }
+
+        /// Lazy element-wise (Hadamard) product.
+        template <typename L, typename R>
+        Binary<L, R, MulOp> hadamard(const Expr<L>& lhs, const Expr<R>& rhs) { return { lhs.self(), rhs.self() }; }
+        template <typename L>
+        Binary<L, Leaf, MulOp> hadamard(const Expr<L>& lhs, const Matrix& rhs) { return { lhs.self(), Leaf(rhs) }; }
+        template <typename R>
+        Binary<Leaf, R, MulOp> hadamard(const Matrix& lhs, const Expr<R>& rhs) { return { Leaf(lhs), rhs.self() }; }
+
+        template <typename E>
+        ScalarOp<E, MulOp> operator*(const Expr<E>& e, float s) { return { e.self(), s }; }
+        template <typename E>
+        ScalarOp<E, MulOp> operator*(float s, const Expr<E>& e) { return { e.self(), s }; }
+        template <typename E>
+        ScalarOp<E, DivOp> operator/(const Expr<E>& e, float s) { return { e.self(), s }; }
+        template <typename E>
+        ScalarOp<E, MulOp> operator-(const Expr<E>& e) { return { e.self(), -1.0f }; }
+
+    }
+
+    template <typename E>
+    Matrix::Matrix(const expr::Expr<E>& e) : Matrix(e.Rows(), e.Cols()) {
+        for (int i = 0; i < elementCount; i++)
+            data[i] = e[i];
+    }
+
+    template <typename E>
+    Matrix& Matrix::operator=(const expr::Expr<E>& e) {
+        // A resize cannot overwrite storage the expression still reads, so evaluate into fresh storage
+        if (e.Rows() * e.Cols() != elementCount || data == nullptr) {
+            *this = Matrix(e);
+            return *this;
+        }
+
+        rows = e.Rows();
+        cols = e.Cols();
+
+        for (int i = 0; i < elementCount; i++)
+            data[i] = e[i];
+
+        return *this;
+    }
+
+    template <typename E>
+    Matrix& Matrix::operator+=(const expr::Expr<E>& e) {
+        if (rows != e.Rows() || cols != e.Cols())
+            throw std::invalid_argument("Matrices must be of the same dimensions");
+
+        for (int i = 0; i < elementCount; i++)
+            data[i] += e[i];
+
+        return *this;
+    }
+
+    template <typename E>
+    Matrix& Matrix::operator-=(const expr::Expr<E>& e) {
+        if (rows != e.Rows() || cols != e.Cols())
+            throw std::invalid_argument("Matrices must be of the same dimensions");
+
+        for (int i = 0; i < elementCount; i++)
+            data[i] -= e[i];
+
+        return *this;
+    }
+
+    template <typename E>
+    Vector::Vector(const expr::Expr<E>& e) : Matrix(e.Cols() == 1 ? e : throw std::invalid_argument("Vector objects must have only 1 col.")) { }
+
+    template <typename E>
+    Vector& Vector::operator=(const expr::Expr<E>& e) {
+        if (e.Cols() != 1)
+            throw std::invalid_argument("Vector objects must have only 1 row.");
+
+        Matrix::operator=(e);
+
+        return *this;
+    }
+
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef GEMM_HPP
+#define GEMM_HPP
+
+namespace bbdnn {
+
+    /// Low-level compute kernels operating on raw float buffers.
+    namespace kernels {
+
+        /// Register tile height of the GEMM micro-kernel.
+        constexpr int GEMM_MR = 4;
+        /// Register tile width of the GEMM micro-kernel.
+        constexpr int GEMM_NR = 8;
+        /// Rows of A packed per L2-resident block.
+        constexpr int GEMM_MC = 128;
+        /// Depth of the packed panels kept in L1.
+        constexpr int GEMM_KC = 256;
+        /// Columns of B packed per L3-resident block.
+        constexpr int GEMM_NC = 2048;
+
+        /// General matrix multiply: C = alpha * A * B + beta * C.
+        ///
+        /// A is M x K, B is K x N and C is M x N. Element (i, j) of A lives at A[i * rsA + j * csA]
+        /// (likewise for B), so transposed operands are expressed by swapping the strides.
+        /// C is row-major with leading dimension ldc. When beta is 0, C is never read.
+        void gemm(int M, int N, int K, float alpha,
+                  const float* A, int rsA, int csA,
+                  const float* B, int rsB, int csB,
+                  float beta, float* C, int ldc);
+
+    }
+
+}
+
+#endif
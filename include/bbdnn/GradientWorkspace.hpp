@@ -0,0 +1,43 @@
+#ifndef GRADIENTWORKSPACE_HPP
+#define GRADIENTWORKSPACE_HPP
+
+#include <vector>
+#include "bbdnn/Matrix.hpp"
+#include "bbdnn/DenseLayer.hpp"
+
+namespace bbdnn {
+
+    /// Gradient buffers for one network topology, sized once and reused for every example.
+    /// Entries are in layer order: weights[l] and biases[l] belong to connection l.
+    struct GradientWorkspace {
+        /// dLoss/dW for each connection (in x out).
+        std::vector<Matrix> weights;
+        /// dLoss/db for each connection.
+        std::vector<Vector> biases;
+        /// dLoss/dz for each layer; the input layer's entry is unused.
+        std::vector<Vector> sensitivities;
+        /// f'(z) scratch for each layer.
+        std::vector<Vector> derivatives;
+        /// dLoss/dz for each layer and minibatch sample (rows x neurons); sized by resizeBatch, and a batch
+        /// uses its first rows.
+        std::vector<Matrix> batchSensitivities;
+        /// f'(z) scratch for each layer and minibatch sample (rows x neurons).
+        std::vector<Matrix> batchDerivatives;
+
+        /// Construct an empty workspace.
+        GradientWorkspace() = default;
+        /// Construct a zeroed workspace sized for the connections between consecutive layers.
+        explicit GradientWorkspace(const std::vector<DenseLayer>& layers);
+
+        /// Make room in the minibatch buffers for batchSize rows. Storage only grows, so a short last batch
+        /// runs on a row prefix.
+        void resizeBatch(int batchSize);
+        /// Zero the weight and bias gradients.
+        void zero();
+        /// Add another workspace's weight and bias gradients into this one. Throws if the shapes differ.
+        void accumulate(const GradientWorkspace& other);
+    };
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef HALFPRECISION_HPP
+#define HALFPRECISION_HPP
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace bbdnn {
+
+    /// Storage format of the weights read by forward passes.
+    enum class WeightPrecision {
+        /// IEEE single precision, the default.
+        Float32,
+        /// bfloat16: fp32's sign and 8-bit exponent with a 7-bit mantissa. Same range as fp32, about 3 significant digits.
+        BFloat16,
+        /// IEEE half precision: 5-bit exponent and 10-bit mantissa. About 3.3 significant digits, largest value 65504.
+        Float16
+    };
+
+    /// Round a float to the nearest bfloat16 (ties to even). NaNs stay NaN.
+    inline uint16_t floatToBFloat16(float value) {
+        uint32_t bits = std::bit_cast<uint32_t>(value);
+
+        if ((bits & 0x7FFFFFFFu) > 0x7F800000u)
+            return static_cast<uint16_t>((bits >> 16) | 0x40u);
+
+        return static_cast<uint16_t>((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+    }
+
+    /// Widen a bfloat16 to float exactly.
+    inline float bfloat16ToFloat(uint16_t value) {
+        return std::bit_cast<float>(static_cast<uint32_t>(value) << 16);
+    }
+
+    /// Round a float to the nearest IEEE half (ties to even). Values beyond 65504 become infinity and NaNs stay NaN.
+    inline uint16_t floatToHalf(float value) {
+        uint32_t bits = std::bit_cast<uint32_t>(value);
+        uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+        uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+        if (magnitude > 0x7F800000u)
+            return sign | 0x7E00u;
+
+        // 65520 and up round to infinity
+        if (magnitude >= 0x477FF000u)
+            return sign | 0x7C00u;
+
+        // Below 2^-14 the result is subnormal: a count of 2^-24 steps, rounded by the FPU
+        if (magnitude < 0x38800000u)
+            return sign | static_cast<uint16_t>(std::nearbyint(std::bit_cast<float>(magnitude) * 16777216.0f));
+
+        // Rebias the exponent from 127 to 15 and round the mantissa from 23 to 10 bits
+        uint32_t rounded = magnitude + 0xFFFu + ((magnitude >> 13) & 1u);
+        return sign | static_cast<uint16_t>((rounded - 0x38000000u) >> 13);
+    }
+
+    /// Widen an IEEE half to float exactly.
+    inline float halfToFloat(uint16_t value) {
+        uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+        uint32_t exponent = (value >> 10) & 0x1Fu;
+        uint32_t mantissa = value & 0x3FFu;
+
+        if (exponent == 0)
+            return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(static_cast<float>(mantissa) * 5.9604645e-8f));
+
+        if (exponent == 31)
+            return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+
+        return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    }
+
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef INFERENCECONTEXT_HPP
+#define INFERENCECONTEXT_HPP
+
+#include <vector>
+#include "bbdnn/Matrix.hpp"
+#include "bbdnn/DenseLayer.hpp"
+
+namespace bbdnn {
+
+    /// Caller-owned activation state for one forward pass. Each thread keeps its own context,
+    /// so a single network can serve concurrent predictions while its weights stay read-only.
+    struct InferenceContext {
+        /// Activated values for each layer; activated[0] is the input.
+        std::vector<Vector> activated;
+        /// Pre-activation values for each layer; the input layer's entry is unused.
+        std::vector<Vector> unactivated;
+
+        /// Construct an empty context.
+        InferenceContext() = default;
+        /// Construct a zeroed context sized for a network's layers.
+        explicit InferenceContext(const std::vector<DenseLayer>& layers);
+
+        /// Copy an input into the input layer's values. Any view works, such as a Dataset row.
+        void setInput(VectorView input);
+        /// Output layer values from the last forward pass.
+        const Vector& output() const;
+    };
+
+}
+
+#endif
@@ -1,13 +1,39 @@
 #ifndef LAYERCONNECTION_HPP
 #define LAYERCONNECTION_HPP
 
+#include <array>
 #include <iostream>
 #include <cstdint>
+#include <vector>
+#include "bbdnn/AlignedBuffer.hpp"
 #include "bbdnn/Matrix.hpp"
 #include "bbdnn/DenseLayer.hpp"
+#include "bbdnn/HalfPrecision.hpp"
+#include "bbdnn/Optimizers.hpp"
+#include "bbdnn/SparseMatrix.hpp"
 
 namespace bbdnn {
 
+    /// Memory order of the fp32 weights read by single-row forward passes.
+    enum class WeightLayout {
+        /// in x out, the order of the master weights: the forward pass is one AXPY per input and the
+        /// backward pass one dot product per input, both contiguous.
+        RowMajor,
+        /// out x in, each output's weights contiguous and padded to 64 bytes: the forward pass is one dot product per output.
+        ColumnMajor,
+        /// Panels of KernelTable::panelWidth outputs, each stored input by input, so a panel's outputs stay in
+        /// registers while the forward pass streams its weights once.
+        PackedPanels
+    };
+
+    /// What a network is about to be used for, which decides the layouts setWorkload picks.
+    enum class Workload {
+        /// Forward and backward passes on the row-major master weights.
+        Training,
+        /// Forward passes only.
+        Inference
+    };
+
     /// Connection between two dense layers with weights and biases.
     class LayerConnection {
         DenseLayer& inLayer;
@@ -16,6 +42,39 @@ namespace bbdnn {
         Matrix weights;
         Vector biases;
 
+        // Optimizer state shaped like the parameters; only the first stateCount buffers are allocated
+        std::array<Matrix, 2> weightState;
+        std::array<Vector, 2> biasState;
+
+        // 16-bit copy of the weights read by forward passes when precision is not Float32, laid out like
+        // weights and re-narrowed after every change to them. weights is the fp32 master unless released
+        WeightPrecision precision = WeightPrecision::Float32;
+        std::vector<uint16_t> compactWeights;
+        bool masterReleased = false;
+
+        // CSR copy of the master weights, built by updateSparseWeights when their density falls below a crossover
+        // density of SparseMatrix; each flag says whether forward passes of that kind read it instead of the
+        // dense weights. Its pattern is also a pruning mask: training steps keep the weights outside it at zero
+        SparseMatrix sparseWeights;
+        bool sparseSingle = false;
+        bool sparseBatched = false;
+
+        // Copy of the master weights in layout for fp32 single-row forward passes; empty for RowMajor.
+        // ColumnMajor rows are layoutStride floats apart
+        WeightLayout layout = WeightLayout::RowMajor;
+        AlignedBuffer layoutWeights;
+        size_t layoutStride = 0;
+
+        // Round the master weights into compactWeights
+        void narrowWeights();
+        // Rearrange the master weights into layoutWeights
+        void packWeights();
+        // Rebuild every copy forward passes read after the master weights change
+        void updateForwardWeights();
+        void requireMasterWeights() const;
+        // Drop sparseWeights, for weights whose density has not been measured
+        void clearSparseWeights();
+
         // Automatically initializes based on activation Function of outLayer and seed
         void initializeWeights(const uint_fast32_t& randomSeed);
     public:
@@ -25,27 +84,33 @@ namespace bbdnn {
         LayerConnection(DenseLayer& InLayer, DenseLayer& OutLayer, Matrix& Weights, float Biases[]);
         /// Copy-construct a connection.
         LayerConnection(const LayerConnection& other);
+        /// Move-construct a connection, taking its parameter and optimizer state storage.
+        LayerConnection(LayerConnection&& other) noexcept;
         /// Destroy the connection.
         ~LayerConnection();
 
         /// Assign from another connection.
         LayerConnection& operator=(const LayerConnection& other);
 
-        /// Get the output of the out layer.
-        Vector getOutput() const;
+        /// View of the out layer's activated values.
+        VectorView getOutput() const;
 
-        /// Get the weight matrix.
+        /// Get the fp32 weight matrix. Throws if the master weights have been released.
         const Matrix& getWeights() const;
         
         /// Set the weight matrix.
         void setWeights(const Matrix& newMatrix);
+        /// Set the weight matrix, taking its storage (which may be borrowed, see Matrix::borrow).
+        void setWeights(Matrix&& newMatrix);
 
-        /// Get the bias vector.
-        Vector getBiases() const;
+        /// View of the bias vector.
+        VectorView getBiases() const;
         /// Set biases from a raw array.
         void setBiases(float newBiases[], int newBiasesSize);
         /// Set biases from a vector.
         void setBiases(const Vector& newBiases);
+        /// Set biases from a vector, taking its storage (which may be borrowed, see Matrix::borrow).
+        void setBiases(Vector&& newBiases);
 
         /// Get weight at (j, i).
         float weightAt(int j, int i) const;
@@ -54,6 +119,60 @@ namespace bbdnn {
 
         /// Forward propagate through this connection.
         void forwardPropogate();
+        /// Forward propagate caller-owned values: Z = W.inputs + b into unactivated and f(Z) into activated.
+        /// Without storeUnactivated, Z is only kept in registers or in activated and unactivated is left as it was.
+        /// Reads only the weights, biases and activation, so it is safe to call from several threads.
+        void forwardPropogate(const Vector& inputs, Vector& unactivated, Vector& activated, bool storeUnactivated = true) const;
+        /// Forward propagate the in layer's batch values through this connection with a single GEMM.
+        void forwardPropogateBatch();
+        /// Forward propagate batchSize contiguous input rows (batch x inSize) into the out layer's batch values.
+        /// The rows are read in place, so they can come straight from a Dataset.
+        void forwardPropogateBatch(const float* inputs, int batchSize);
+
+        /// Number of weights and biases.
+        int parameterCount() const;
+
+        /// Store the weights read by forward passes in precision. BFloat16 and Float16 keep a 16-bit copy next to
+        /// the fp32 master weights; updates go to the master and are rounded into the copy after every step.
+        void setWeightPrecision(WeightPrecision newPrecision);
+        /// Precision of the weights read by forward passes.
+        WeightPrecision getWeightPrecision() const;
+        /// Free the fp32 master weights of a 16-bit connection for inference-only use. Training and getWeights
+        /// then throw until weights are set again.
+        void releaseMasterWeights();
+        /// Whether the fp32 master weights are held.
+        bool hasMasterWeights() const;
+        /// The weights forward passes use, widened to fp32.
+        Matrix widenedWeights() const;
+        /// Bytes of weights held: the master and every copy forward passes read.
+        size_t weightBytes() const;
+
+        /// Lay out the fp32 weights single-row forward passes read. Non-row-major layouts keep a copy next to the
+        /// row-major master, which batched forward passes and training keep using. 16-bit weights stay row-major.
+        void setWeightLayout(WeightLayout newLayout);
+        /// Layout of the weights read by single-row forward passes.
+        WeightLayout getWeightLayout() const;
+        /// Layout suited to a workload: RowMajor for training, and for inference PackedPanels unless padding the
+        /// outputs to whole panels would waste more than a quarter of them, in which case ColumnMajor.
+        WeightLayout layoutFor(Workload workload) const;
+
+        /// Fraction of the weights that are nonzero.
+        float density() const;
+        /// Measure the weights' density and read them through a CSR copy when it is below
+        /// SparseMatrix::crossoverDensity, or drop the copy. The pruning functions call this; setting weights only
+        /// drops the copy, so loading or mapping a model never scans them. While the copy exists, training
+        /// steps keep the pruned weights at zero and refresh the copy in place.
+        void updateSparseWeights();
+        /// Whether single-row forward passes use the sparse weights (see updateSparseWeights); batched passes
+        /// compare the density against the batched crossover.
+        bool isSparse() const;
+
+        /// Take a gradient descent step in place: W -= learningRate * weightGradient, b -= learningRate * biasGradient.
+        void applyGradients(const Matrix& weightGradient, const Vector& biasGradient, float learningRate);
+        /// Update weights and biases in place with an optimizer rule, using this connection's state buffers.
+        void applyGradients(const Matrix& weightGradient, const Vector& biasGradient, const IOptimizer& optimizer, const OptimizerStep& step);
+        /// Allocate stateCount zeroed optimizer state buffers per parameter and release the rest.
+        void resetOptimizerState(int stateCount);
     };
 
 }
@@ -9,12 +9,20 @@
 #include <math.h>
 #include <random>
 #include <initializer_list>
+#include "bbdnn/MatrixView.hpp"
 
 namespace bbdnn {
 
     struct Vector;
+    struct IMatrixAllocator;
 
-    /// Lightweight dense matrix of floats.
+    namespace expr {
+        template <typename E>
+        struct Expr;
+    }
+
+    /// Lightweight dense matrix of floats. Owned storage starts on a 64-byte boundary and comes from the current
+    /// thread's allocator (see Allocator.hpp), the aligned heap unless an AllocatorScope says otherwise.
     class Matrix {
     private:
         int rows;
@@ -22,7 +30,12 @@ namespace bbdnn {
         int elementCount;
     
         float* data;
+        // False when data points at external storage (see borrow) that must not be freed
+        bool ownsData = true;
+        // Allocator that supplied data, which gets it back on destruction (see Allocator.hpp)
+        IMatrixAllocator* allocator = nullptr;
 
+        void allocateMatrixData(int count);
         void destroyMatrixData();
 
     public:
@@ -32,15 +45,33 @@ namespace bbdnn {
         Matrix(int Rows, int Cols);
         /// Create a matrix filled with a default value.
         Matrix(int Rows, int Cols, float defaultVal);
-        /// Create a matrix from a raw data array.
-        explicit Matrix(int Rows, int Cols, float Data[]);
+        /// Create a matrix by copying Rows * Cols values from a raw array. The caller keeps ownership of Data.
+        explicit Matrix(int Rows, int Cols, const float Data[]);
         /// Copy-construct from another matrix.
         Matrix(const Matrix& other);
+        /// Copy the elements of a view into a new matrix. Explicit, so a copy is never made by accident.
+        explicit Matrix(const MatrixView& view);
+        /// Move-construct, taking other's storage and leaving it empty (0x0).
+        Matrix(Matrix&& other) noexcept;
+        /// Evaluate a lazy expression (see Expr.hpp) in a single pass.
+        template <typename E>
+        Matrix(const expr::Expr<E>& e);
         /// Destroy the matrix and free storage.
         ~Matrix();
 
-        /// Assign from another matrix (deep copy).
+        /// Assign from another matrix (deep copy). Reuses the existing storage when element counts match.
         Matrix& operator=(const Matrix& other);
+        /// Move-assign, taking other's storage and leaving it empty (0x0).
+        Matrix& operator=(Matrix&& other) noexcept;
+        /// Evaluate a lazy expression (see Expr.hpp) into this matrix in a single pass.
+        template <typename E>
+        Matrix& operator=(const expr::Expr<E>& e);
+        /// Add a lazy expression (see Expr.hpp) element-wise in a single pass.
+        template <typename E>
+        Matrix& operator+=(const expr::Expr<E>& e);
+        /// Subtract a lazy expression (see Expr.hpp) element-wise in a single pass.
+        template <typename E>
+        Matrix& operator-=(const expr::Expr<E>& e);
         /// Matrix multiplication.
         Matrix operator*(const Matrix& other) const;
         /// Multiply by scalar.
@@ -70,10 +101,22 @@ namespace bbdnn {
         int Cols() const;
         /// Total element count.
         int size() const;
-        /// Return a newly allocated column array (caller owns).
-        float* getCol(int col) const;
-        /// Return a newly allocated row array (caller owns).
-        float* getRow(int col) const;
+        /// Pointer to the contiguous row-major storage (mutable).
+        float* rawData();
+        /// Pointer to the contiguous row-major storage (const).
+        const float* rawData() const;
+        /// View of the whole matrix, for sub-blocks, row slices and transposes without copying.
+        MatrixView view() const&;
+        /// Viewing a temporary would dangle once the full expression ends.
+        MatrixView view() const&& = delete;
+        /// View of one column (strided).
+        VectorView getCol(int col) const&;
+        /// Viewing a temporary would dangle once the full expression ends.
+        VectorView getCol(int col) const&& = delete;
+        /// View of one row.
+        VectorView getRow(int row) const&;
+        /// Viewing a temporary would dangle once the full expression ends.
+        VectorView getRow(int row) const&& = delete;
         /// Bounds-checked element access (mutable).
         float& at(int row, int col);
         /// Bounds-checked element access (const).
@@ -93,6 +136,14 @@ namespace bbdnn {
         /// Kaiming initializer.
         static Matrix kaimingMatrix(int inCount, int outCount, uint_fast32_t randomSeed);
 
+        /// Whether the matrix owns its storage; false for borrowed storage.
+        bool ownsStorage() const;
+
+        /// Wrap Rows * Cols floats of external storage without copying. The caller keeps ownership and must
+        /// keep the storage alive while the matrix uses it. Assignments of the same size write into the
+        /// borrowed storage; anything that resizes the matrix moves it to storage of its own.
+        static Matrix borrow(int Rows, int Cols, float* Data);
+
         /// Print matrix to stderr.
         void printMatrix() const;
     };
@@ -104,15 +155,27 @@ class Vector : public Matrix {
         Vector();
         /// Construct from a 1-column matrix.
         Vector(const Matrix& other);
+        /// Construct from a 1-column matrix, taking its storage.
+        Vector(Matrix&& other);
+        /// Copy the elements of a view into a new vector. Explicit, so a copy is never made by accident.
+        explicit Vector(const VectorView& view);
         /// Construct a vector with size and default value.
         Vector(int Size, float defaultVal = 0.0f);
         /// Construct from a raw array.
-        Vector(float vals[], int Size);
+        Vector(const float vals[], int Size);
         /// Construct from an initializer list.
         Vector(std::initializer_list<float> vals);
+        /// Evaluate a 1-column lazy expression (see Expr.hpp).
+        template <typename E>
+        Vector(const expr::Expr<E>& e);
 
         /// Assign from a 1-column matrix.
         Vector& operator=(const Matrix& other);
+        /// Assign from a 1-column matrix, taking its storage.
+        Vector& operator=(Matrix&& other);
+        /// Evaluate a 1-column lazy expression (see Expr.hpp) into this vector.
+        template <typename E>
+        Vector& operator=(const expr::Expr<E>& e);
         /// Element access (mutable).
         float& operator[](int ind);
         /// Element access (const).
@@ -0,0 +1,98 @@
+#ifndef MATRIXVIEW_HPP
+#define MATRIXVIEW_HPP
+
+namespace bbdnn {
+
+    class Matrix;
+
+    /// Non-owning, read-only view of count floats spaced stride apart: a vector, a matrix row or a matrix
+    /// column. Views are cheap to copy and never allocate. The viewed storage must outlive the view, and
+    /// resizing the matrix it came from invalidates it.
+    class VectorView {
+        const float* values = nullptr;
+        int count = 0;
+        int step = 1;
+
+    public:
+        /// Create an empty view.
+        VectorView() = default;
+        /// View Count floats starting at Data, Stride floats apart.
+        VectorView(const float* Data, int Count, int Stride = 1);
+        /// View a vector (a single-column matrix). Throws std::invalid_argument for other shapes.
+        VectorView(const Matrix& vector);
+        /// Viewing a temporary would dangle once the full expression ends.
+        VectorView(const Matrix&& vector) = delete;
+
+        /// Number of elements.
+        int size() const { return count; }
+        /// Distance between consecutive elements, in floats.
+        int stride() const { return step; }
+        /// Pointer to the first element.
+        const float* rawData() const { return values; }
+        /// Whether the elements are adjacent in memory.
+        bool isContiguous() const { return step == 1 || count <= 1; }
+
+        /// Element access.
+        float operator[](int i) const { return values[static_cast<long>(i) * step]; }
+        /// Bounds-checked element access.
+        const float& at(int i) const;
+
+        /// View of count elements starting at first.
+        VectorView slice(int first, int count) const;
+    };
+
+    /// Non-owning, read-only view of a rows x cols block of floats, with element (r, c) at
+    /// data[r * rowStride + c * colStride]. Whole matrices, strided sub-blocks, batch slices and transposes are
+    /// all views of the same storage, and the strides are the leading dimension and increment kernels::gemm takes.
+    class MatrixView {
+        const float* values = nullptr;
+        int rowCount = 0;
+        int colCount = 0;
+        int rowStep = 0;
+        int colStep = 1;
+
+    public:
+        /// Create an empty view (0x0).
+        MatrixView() = default;
+        /// View Rows x Cols floats starting at Data, RowStride floats between rows and ColStride between columns.
+        MatrixView(const float* Data, int Rows, int Cols, int RowStride, int ColStride = 1);
+        /// View a whole matrix.
+        MatrixView(const Matrix& matrix);
+        /// Viewing a temporary would dangle once the full expression ends.
+        MatrixView(const Matrix&& matrix) = delete;
+
+        /// Number of rows.
+        int Rows() const { return rowCount; }
+        /// Number of columns.
+        int Cols() const { return colCount; }
+        /// Total element count.
+        int size() const { return rowCount * colCount; }
+        /// Distance between consecutive rows, in floats.
+        int rowStride() const { return rowStep; }
+        /// Distance between consecutive columns, in floats.
+        int colStride() const { return colStep; }
+        /// Pointer to element (0, 0).
+        const float* rawData() const { return values; }
+        /// Whether the elements are row-major with no gaps, as in a Matrix.
+        bool isContiguous() const { return colStep == 1 && (rowStep == colCount || rowCount <= 1); }
+
+        /// Element access by row and column.
+        float operator()(int row, int col) const { return values[static_cast<long>(row) * rowStep + static_cast<long>(col) * colStep]; }
+        /// Bounds-checked element access.
+        const float& at(int row, int col) const;
+
+        /// View of one row.
+        VectorView row(int row) const;
+        /// View of one column.
+        VectorView col(int col) const;
+        /// View of the rows x cols block whose top-left element is (row, col).
+        MatrixView block(int row, int col, int rows, int cols) const;
+        /// View of count consecutive rows starting at first, such as one batch of a row-per-sample matrix.
+        MatrixView rowSlice(int first, int count) const;
+        /// View of the transpose, swapping the strides instead of moving elements.
+        MatrixView transposed() const;
+    };
+
+}
+
+#endif
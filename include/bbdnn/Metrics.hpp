@@ -0,0 +1,132 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace bbdnn {
+
+    /// Summary of one training epoch. Loss is each example's sum of squared residuals (SSR).
+    struct EpochMetrics {
+        /// Zero-based epoch index.
+        int epoch = 0;
+        /// Examples trained on during the epoch.
+        size_t samples = 0;
+        /// Mean SSR over the epoch's examples.
+        float meanLoss = 0.0f;
+        /// Smallest SSR of the epoch.
+        float minLoss = 0.0f;
+        /// Largest SSR of the epoch.
+        float maxLoss = 0.0f;
+        /// Wall time of the epoch in seconds.
+        double seconds = 0.0;
+        /// Examples per second over the epoch.
+        double samplesPerSecond = 0.0;
+    };
+
+    /// Receiver for training metrics. Training passes every example's SSR through record and an epoch
+    /// summary through endEpoch, so metrics memory is whatever the sink chooses to keep.
+    struct IMetricsSink {
+        /// Construct a base sink.
+        IMetricsSink() = default;
+        /// Virtual destructor for interface.
+        virtual ~IMetricsSink() = default;
+
+        /// Receive the SSRs of examples just trained on, in visiting order. Ignored by default.
+        virtual void record(const float* losses, size_t count);
+        /// Receive an epoch's summary. Return false to stop training after this epoch.
+        virtual bool endEpoch(const EpochMetrics& metrics) = 0;
+    };
+
+    /// Folds per-example SSRs into running epoch aggregates in constant memory and forwards both to a sink.
+    /// Used by every NeuralNetwork training mode; custom training loops can use it the same way.
+    class EpochRecorder {
+        IMetricsSink& sink;
+        std::chrono::steady_clock::time_point epochStart;
+        int epoch = 0;
+        size_t samples = 0;
+        double lossSum = 0.0;
+        float minLoss = 0.0f;
+        float maxLoss = 0.0f;
+
+    public:
+        /// Record into sink, starting the first epoch's clock now.
+        explicit EpochRecorder(IMetricsSink& Sink);
+
+        /// Add SSRs to the current epoch and pass them on to the sink.
+        void record(const float* losses, size_t count);
+        /// Add one SSR to the current epoch.
+        void record(float loss);
+
+        /// Close the current epoch, hand its summary to the sink and start the next one.
+        /// Returns false if the sink asked to stop.
+        bool endEpoch();
+
+        /// Number of epochs closed so far.
+        int epochsCompleted() const;
+    };
+
+    /// Keeps the most recent epoch summaries and example SSRs in fixed-size ring buffers.
+    class MetricsHistory : public IMetricsSink {
+        // Allocated once at full capacity; entry i of a ring holds the write with index i modulo its size
+        std::vector<EpochMetrics> epochRing;
+        std::vector<float> lossRing;
+        size_t epochsSeen = 0;
+        size_t lossesSeen = 0;
+
+    public:
+        /// Keep the last EpochCapacity epoch summaries and the last LossCapacity example SSRs (none by default).
+        explicit MetricsHistory(size_t EpochCapacity, size_t LossCapacity = 0);
+
+        void record(const float* losses, size_t count) override;
+        bool endEpoch(const EpochMetrics& metrics) override;
+
+        /// Retained epoch summaries, oldest first.
+        std::vector<EpochMetrics> epochs() const;
+        /// Retained example SSRs, oldest first.
+        std::vector<float> losses() const;
+        /// Most recent epoch summary. Throws if no epoch has finished.
+        const EpochMetrics& last() const;
+
+        /// Epochs seen, including ones that have left the ring.
+        size_t epochCount() const;
+        /// Example SSRs seen, including ones that have left the ring.
+        size_t lossCount() const;
+
+        /// Forget everything recorded.
+        void clear();
+    };
+
+    /// Stops training once an epoch's mean SSR reaches a threshold, optionally passing everything on to another sink.
+    class EarlyStopping : public IMetricsSink {
+        float threshold;
+        IMetricsSink* next;
+        bool triggered = false;
+
+    public:
+        /// Stop when meanLoss <= Threshold. Next, if given, must outlive training.
+        explicit EarlyStopping(float Threshold, IMetricsSink* Next = nullptr);
+
+        void record(const float* losses, size_t count) override;
+        bool endEpoch(const EpochMetrics& metrics) override;
+
+        /// Whether the threshold was reached.
+        bool stopped() const;
+    };
+
+    /// Calls a function with each epoch summary; training stops when it returns false.
+    class MetricsCallback : public IMetricsSink {
+        std::function<bool(const EpochMetrics&)> callback;
+
+    public:
+        /// Wrap a callback.
+        explicit MetricsCallback(std::function<bool(const EpochMetrics&)> Callback);
+
+        bool endEpoch(const EpochMetrics& metrics) override;
+    };
+
+}
+
+#endif
@@ -3,8 +3,18 @@
 
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <random>
+#include "bbdnn/Dataset.hpp"
+#include "bbdnn/DatasetStream.hpp"
 #include "bbdnn/DenseLayer.hpp"
 #include "bbdnn/LayerConnection.hpp"
+#include "bbdnn/GradientWorkspace.hpp"
+#include "bbdnn/InferenceContext.hpp"
+#include "bbdnn/Metrics.hpp"
+#include "bbdnn/Optimizers.hpp"
+#include "bbdnn/ThreadPool.hpp"
+#include "bbdnn/TrainingContext.hpp"
 
 namespace bbdnn {
 
@@ -17,15 +27,66 @@ namespace bbdnn {
 
         uint_fast32_t rngSeed;
 
-        Vector getLayerErrorSensitivity(int layerIndex, const Vector& nextLayerSensitivity);
+        // Draws each epoch's example order in trainMinibatch
+        std::mt19937 shuffleEngine;
+
+        // Update rule used by every training mode; its state buffers live in the connections
+        OptimizerPtr optimizer;
+
+        void stepParameters(const GradientWorkspace& stepGradients, float learningRate);
+
+        // Sized on the first training call and reused afterwards, so training does not allocate per
+        // example and inference-only networks (e.g. mapped models) never pay for it
+        GradientWorkspace gradients;
+
+        GradientWorkspace& gradientWorkspace();
+
+        // Parallel full-batch training: one context per shard, created on first use
+        std::unique_ptr<ThreadPool> pool;
+        std::vector<TrainingContext> contexts;
+
+        void computeBatchGradients(const float* inputRows, const float* expectedRows, float* residuals);
+
+        // Size every batch buffer for rows up front, so a smaller batch later in the run (the short last one)
+        // works on a row prefix instead of reallocating
+        void reserveBatch(int rows);
+
+        // One minibatch step on contiguous input and expected rows, writing each row's squared residual
+        void trainBatch(const float* inputRows, const float* expectedRows, int rows, float learningRate, float* residuals);
+
+        // One pass over a dataset's batches in shuffled order; losses is scratch for one batch's residuals
+        void trainBatches(const Dataset& data, float learningRate, int batchSize, std::vector<size_t>& batchStarts, std::vector<float>& losses, EpochRecorder& recorder);
+
+        // Batched forward passes over a dataset's rows in order, appending residuals to metrics
+        void scoreBatches(const Dataset& data, std::vector<float>& metrics);
+
+        int trainParallel(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, IMetricsSink& sink);
 
     public:
-        /// Construct a network from a list of layers.
-        NeuralNetwork(uint_fast32_t RngSeed, std::vector<DenseLayer> Layers);
+        /// Construct a network from a list of layers. With initializeWeights false the weights are left
+        /// uninitialized, for callers that set every parameter themselves (e.g. model loading).
+        NeuralNetwork(uint_fast32_t RngSeed, std::vector<DenseLayer> Layers, bool initializeWeights = true);
+
+        /// Connections refer to the owned layers, so a copy would alias the source network.
+        NeuralNetwork(const NeuralNetwork& other) = delete;
+        /// Move-construct; layer storage moves with the vector so connections stay valid.
+        NeuralNetwork(NeuralNetwork&& other) noexcept = default;
 
         /// Destroy the network.
         ~NeuralNetwork();
 
+        /// Set the update rule used by train, trainMinibatch and applyGradients (SGD by default).
+        /// Resets the per-parameter optimizer state held by each connection.
+        void setOptimizer(OptimizerPtr newOptimizer);
+        /// Get the update rule.
+        const IOptimizer& getOptimizer() const;
+
+        /// Set the number of threads used by full-batch training. 1 (the default) trains serially.
+        /// Results are reproducible for a fixed thread count; different counts sum gradients in a different order.
+        void setThreadCount(int threads);
+        /// Number of threads used by full-batch training.
+        int getThreadCount() const;
+
         /// Get a vector of LayerConnections objects.
         const std::vector<LayerConnection>& getConnections() const;
 
@@ -36,38 +97,130 @@ namespace bbdnn {
         float getNeuronValue(int l, int i) const;
 
         /// Set the input layer values.
-        void setInput(Vector input);
+        void setInput(VectorView input);
 
-        /// Get the output layer activations.
-        Vector output() const;
+        /// View of the output layer activations.
+        VectorView output() const;
     
         /// Run forward propagation through all layers. Output is stored in output layer.
         void forwardPropogate();
 
+        /// Run forward propagation for a batch with one GEMM per connection.
+        /// Each row of inputBatch is one sample (batch x inputSize); returns a view of the output batch
+        /// (batch x outputSize), valid until the next batched pass.
+        MatrixView forwardPropogate(const Matrix& inputBatch);
+
+        /// Run forward propagation for batchSize contiguous input rows (batch x inputSize), reading them in place.
+        /// Passing dataset.featureRow(i) runs rows i..i+batchSize of a Dataset without copying them.
+        MatrixView forwardPropogate(const float* inputRows, int batchSize);
+
+        /// Backpropagate the current forward pass into the gradient workspace and return the SSR.
+        /// Gradients are scaled by gradientScale and overwrite the workspace, or are added to it when accumulate is set.
+        float computeGradients(const Vector& expected, float gradientScale = 1.0f, bool accumulate = false);
+
+        /// Run forward propagation on a context's values; the network's own layers are untouched.
+        /// Inference-only callers can clear storeUnactivated to skip writing the pre-activation values, which
+        /// predict does; backpropagating from the context then needs them stored.
+        void forwardPropogate(InferenceContext& context, bool storeUnactivated = true) const;
+
+        /// Backpropagate a context's forward pass into its own gradients, as computeGradients does for the network.
+        float computeGradients(TrainingContext& context, const Vector& expected, float gradientScale = 1.0f, bool accumulate = false) const;
+
+        /// Take one optimizer step on every connection's parameters in place from the workspace gradients.
+        void applyGradients(float learningRate);
+
+        /// Gradient workspace filled by computeGradients; empty until the first training call.
+        const GradientWorkspace& getGradients() const;
+
         /// Backpropagate and return weight/bias deltas and SSR.
-        std::tuple<std::vector<Matrix>, std::vector<Vector>, float> backPropagate(Vector expected, float learningRate);
+        std::tuple<std::vector<Matrix>, std::vector<Vector>, float> backPropagate(const Vector& expected, float learningRate);
 
         /// Compute new parameters from delta weights and biases.
         std::pair<std::vector<Matrix>, std::vector<Vector>> takeStep(const std::vector<Matrix>& deltaWeights, const std::vector<Vector>& deltaBiases);
 
-        /// Update network parameters.
+        /// Update network parameters, taking the storage of each new matrix and vector.
         void updateParameters(std::vector<Matrix> newWeights, std::vector<Vector> newBiases);
         
-        /// Train the network and return collected metrics.
+        /// Train the network and return collected metrics. Full-batch training splits the examples across
+        /// getThreadCount() threads, each with its own TrainingContext, and reduces their gradients pairwise.
         std::vector<float> train(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, bool isStochastic = false);
+
+        /// Train the network, streaming every example's SSR and a summary of each epoch to sink instead of
+        /// returning them, so metrics memory does not grow with the epoch count. Stops early when the sink's
+        /// endEpoch returns false; returns the number of epochs run.
+        int train(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, IMetricsSink& sink, bool isStochastic = false);
         
+        /// Train with minibatch SGD and return the squared residual of every example seen, in visiting order.
+        /// Each epoch visits the examples in a fresh random order (shuffled indices, the data is not moved)
+        /// and takes one step per batchSize examples on the batch's mean gradient. Each batch runs through
+        /// the batched forward pass and a matching batched backward pass with one GEMM per connection.
+        std::vector<float> trainMinibatch(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, int batchSize);
+        /// Train with minibatch SGD, reporting to sink as train does; returns the number of epochs run.
+        int trainMinibatch(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, int batchSize, IMetricsSink& sink);
+
+        /// Train with minibatch SGD on a Dataset, feeding each batch to the network straight from its rows.
+        /// Batches are runs of batchSize consecutive rows visited in a fresh random order each epoch, so rows
+        /// are never gathered or copied and a mapped dataset is read a batch at a time; shuffle the rows
+        /// once when writing the file if its order is not already random.
+        std::vector<float> trainMinibatch(const Dataset& trainingData, float learningRate, int epochs, int batchSize);
+        /// Train with minibatch SGD on a Dataset, reporting to sink; returns the number of epochs run.
+        int trainMinibatch(const Dataset& trainingData, float learningRate, int epochs, int batchSize, IMetricsSink& sink);
+
+        /// Train with minibatch SGD on a stream, one chunk at a time, as the Dataset overload does within each chunk.
+        /// Each epoch after the first rewinds the stream; the first starts from its current position.
+        std::vector<float> trainMinibatch(DatasetStream& trainingData, float learningRate, int epochs, int batchSize);
+        /// Train with minibatch SGD on a stream, reporting to sink; returns the number of epochs run.
+        int trainMinibatch(DatasetStream& trainingData, float learningRate, int epochs, int batchSize, IMetricsSink& sink);
+
         /// Evaluate the network and return metrics for each example.
         std::vector<float> evaluate(const std::vector<Vector>& testFeatures, const std::vector<Vector>& testLabels);
 
-        /// Predict output for a single input.
-        Vector predict(const Vector& input);
+        /// Evaluate the network on a Dataset's rows in place and return metrics for each example.
+        std::vector<float> evaluate(const Dataset& testData);
+
+        /// Evaluate the network on the rest of a stream and return metrics for each example.
+        std::vector<float> evaluate(DatasetStream& testData);
+
+        /// Predict output for a single input. Safe to call from several threads at once.
+        Vector predict(const Vector& input) const;
+
+        /// Predict output using caller-owned scratch; returns the context's output layer values.
+        /// Does not allocate, and is safe to call concurrently as long as each thread has its own context.
+        const Vector& predict(const Vector& input, InferenceContext& context) const;
+
+        /// Create a context sized for this network's layers.
+        InferenceContext createInferenceContext() const;
 
         /// Clear cached activations.
         void clear();
 
+        /// Seed used for weight initialization and shuffling.
+        uint_fast32_t seed() const;
+
         /// Number of layers.
         int size() const;
 
+        /// Number of weights and biases across all connections.
+        int parameterCount() const;
+
+        /// Store every connection's weights in precision for forward passes, accumulating in fp32. With
+        /// keepMasterWeights the fp32 weights stay the ones trained (mixed precision); without it they are
+        /// freed for inference-only use, and training throws until parameters are set again.
+        void setWeightPrecision(WeightPrecision precision, bool keepMasterWeights = true);
+
+        /// Precision of the weights read by forward passes.
+        WeightPrecision getWeightPrecision() const;
+
+        /// Bytes of weights held across all connections, masters and every copy forward passes read.
+        size_t weightBytes() const;
+
+        /// Give each connection the weight layout suited to workload (see LayerConnection::layoutFor).
+        void setWorkload(Workload workload);
+
+        /// Switch each connection to or from CSR weights by its density (see LayerConnection::updateSparseWeights).
+        /// The pruning functions and loadModel call this; it scans every weight, so MappedModel does not.
+        void updateSparseWeights();
+
         /// Input layer size.
         int inputSize() const;
 
@@ -0,0 +1,212 @@
+#ifndef OPTIMIZERS_HPP
+#define OPTIMIZERS_HPP
+
+#include <cstddef>
+#include <memory>
+#include <concepts>
+#include <utility>
+
+namespace bbdnn {
+
+    /// Identifies the built-in update rules so kernels can specialize on them.
+    enum class OptimizerKind {
+        Custom,
+        SGD,
+        Momentum,
+        Nesterov,
+        RMSProp,
+        Adam,
+        AdamW
+    };
+
+    /// Scalars for one update step. Each rule reads only the fields it uses.
+    struct OptimizerStep {
+        /// Step size.
+        float learningRate = 0.0f;
+        /// Momentum coefficient, RMSProp decay rate or Adam beta1.
+        float decay1 = 0.0f;
+        /// Adam beta2.
+        float decay2 = 0.0f;
+        /// Denominator guard for RMSProp and Adam.
+        float epsilon = 0.0f;
+        /// Decoupled weight decay (AdamW).
+        float weightDecay = 0.0f;
+        /// Adam first moment bias correction, 1 / (1 - beta1^t).
+        float correction1 = 1.0f;
+        /// Adam second moment bias correction, 1 / (1 - beta2^t).
+        float correction2 = 1.0f;
+    };
+
+    /// Parameter update rule interface.
+    ///
+    /// Per-parameter state lives next to the parameters (see LayerConnection); the optimizer itself only
+    /// holds hyperparameters and step-wide counters. The built-in rules update parameters, gradients and
+    /// state in one fused SIMD pass with no temporaries.
+    struct IOptimizer {
+        /// Construct a base optimizer.
+        IOptimizer() = default;
+        /// Virtual destructor for interface.
+        virtual ~IOptimizer() = default;
+
+        /// Number of state buffers the rule keeps per parameter (0, 1 or 2).
+        virtual int stateCount() const = 0;
+        /// Advance to the next step and return its scalars. Called once per step before any update.
+        virtual OptimizerStep beginStep(float learningRate) = 0;
+        /// Update n parameters in place from their gradients. state0 and state1 hold the first stateCount()
+        /// buffers and are null otherwise. The default runs the built-in fused kernel for kind().
+        virtual void update(const OptimizerStep& step, float* params, const float* grads, float* state0, float* state1, size_t n) const;
+        /// Forget step-wide counters, e.g. Adam's step count.
+        virtual void reset();
+
+        /// Which built-in rule this is, or Custom for user-defined optimizers.
+        virtual OptimizerKind kind() const;
+
+        /// Clone this optimizer.
+        virtual std::unique_ptr<IOptimizer> clone() const = 0;
+    };
+
+    /// Owning pointer to an optimizer implementation
+    typedef std::unique_ptr<IOptimizer> OptimizerPtr;
+
+    /// Plain gradient descent: w -= lr * g.
+    struct SGDOptimizer : public IOptimizer {
+        /// Construct an SGD optimizer.
+        SGDOptimizer() = default;
+
+        /// No state.
+        int stateCount() const override;
+        /// Step scalars.
+        OptimizerStep beginStep(float learningRate) override;
+        /// Built-in optimizer kind.
+        OptimizerKind kind() const override;
+        /// Clone this optimizer.
+        OptimizerPtr clone() const override;
+    };
+
+    /// Heavy-ball momentum: v = mu * v + g, w -= lr * v.
+    struct MomentumOptimizer : public IOptimizer {
+        /// Velocity decay.
+        float momentum;
+
+        /// Construct a momentum optimizer.
+        MomentumOptimizer(float Momentum);
+
+        /// One velocity buffer.
+        int stateCount() const override;
+        /// Step scalars.
+        OptimizerStep beginStep(float learningRate) override;
+        /// Built-in optimizer kind.
+        OptimizerKind kind() const override;
+        /// Clone this optimizer.
+        OptimizerPtr clone() const override;
+    };
+
+    /// Nesterov momentum: v = mu * v + g, w -= lr * (g + mu * v).
+    struct NesterovOptimizer : public IOptimizer {
+        /// Velocity decay.
+        float momentum;
+
+        /// Construct a Nesterov optimizer.
+        NesterovOptimizer(float Momentum);
+
+        /// One velocity buffer.
+        int stateCount() const override;
+        /// Step scalars.
+        OptimizerStep beginStep(float learningRate) override;
+        /// Built-in optimizer kind.
+        OptimizerKind kind() const override;
+        /// Clone this optimizer.
+        OptimizerPtr clone() const override;
+    };
+
+    /// RMSProp: s = rho * s + (1 - rho) * g^2, w -= lr * g / (sqrt(s) + eps).
+    struct RMSPropOptimizer : public IOptimizer {
+        /// Decay of the squared gradient average.
+        float rho;
+        /// Denominator guard.
+        float epsilon;
+
+        /// Construct an RMSProp optimizer.
+        RMSPropOptimizer(float Rho, float Epsilon);
+
+        /// One squared gradient average.
+        int stateCount() const override;
+        /// Step scalars.
+        OptimizerStep beginStep(float learningRate) override;
+        /// Built-in optimizer kind.
+        OptimizerKind kind() const override;
+        /// Clone this optimizer.
+        OptimizerPtr clone() const override;
+    };
+
+    /// Adam with bias-corrected first and second moments.
+    struct AdamOptimizer : public IOptimizer {
+        /// First moment decay.
+        float beta1;
+        /// Second moment decay.
+        float beta2;
+        /// Denominator guard.
+        float epsilon;
+        /// Steps taken so far.
+        int steps = 0;
+
+        /// Construct an Adam optimizer.
+        AdamOptimizer(float Beta1, float Beta2, float Epsilon);
+
+        /// First and second moments.
+        int stateCount() const override;
+        /// Advance the step count and return the bias corrections.
+        OptimizerStep beginStep(float learningRate) override;
+        /// Reset the step count.
+        void reset() override;
+        /// Built-in optimizer kind.
+        OptimizerKind kind() const override;
+        /// Clone this optimizer.
+        OptimizerPtr clone() const override;
+    };
+
+    /// Adam with decoupled weight decay: w -= lr * (Adam direction + lambda * w).
+    struct AdamWOptimizer : public AdamOptimizer {
+        /// Decoupled weight decay (lambda).
+        float weightDecay;
+
+        /// Construct an AdamW optimizer.
+        AdamWOptimizer(float Beta1, float Beta2, float Epsilon, float WeightDecay);
+
+        /// Adam scalars plus weight decay.
+        OptimizerStep beginStep(float learningRate) override;
+        /// Built-in optimizer kind.
+        OptimizerKind kind() const override;
+        /// Clone this optimizer.
+        OptimizerPtr clone() const override;
+    };
+
+    /// Concept for optimizer implementations.
+    template<typename T>
+    concept OptimizerDerived = std::derived_from<T, IOptimizer>;
+
+    /// make_unique wrapper for cleaner optimizer construction.
+    template <OptimizerDerived OptimizerType, typename... Args>
+    OptimizerPtr make_optimizer(Args&&... args) {
+        return std::make_unique<OptimizerType>(std::forward<Args>(args)...);
+    }
+
+    /// Optimizer factory helpers.
+    namespace Optimizer {
+        /// Create a plain SGD optimizer.
+        OptimizerPtr SGD();
+        /// Create a momentum optimizer.
+        OptimizerPtr Momentum(float momentum = 0.9f);
+        /// Create a Nesterov momentum optimizer.
+        OptimizerPtr Nesterov(float momentum = 0.9f);
+        /// Create an RMSProp optimizer.
+        OptimizerPtr RMSProp(float rho = 0.9f, float epsilon = 1e-8f);
+        /// Create an Adam optimizer.
+        OptimizerPtr Adam(float beta1 = 0.9f, float beta2 = 0.999f, float epsilon = 1e-8f);
+        /// Create an AdamW optimizer.
+        OptimizerPtr AdamW(float beta1 = 0.9f, float beta2 = 0.999f, float epsilon = 1e-8f, float weightDecay = 0.01f);
+    }
+
+}
+
+#endif
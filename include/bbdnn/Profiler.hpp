@@ -0,0 +1,247 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bbdnn {
+
+    /// Hot-path instrumentation, compiled in only when the library is built with BBDNN_ENABLE_PROFILING
+    /// (the CMake option of the same name). Otherwise the recording macros expand to nothing, and the
+    /// functions below still link but report no data.
+    namespace profiling {
+
+        /// Stage of the training or inference hot path a timing belongs to.
+        enum class Phase {
+            /// Z = W.A + b: bias broadcast and the forward GEMM.
+            Forward,
+            /// A = f(Z).
+            Activation,
+            /// Output error and loss: dE/dA * f'(Z) for the output layer.
+            Loss,
+            /// f'(Z) of a hidden layer, for its sensitivity (W^T . delta) * f'(Z).
+            Sensitivity,
+            /// Weight gradient outer product (or X^T . Delta for a batch) and bias gradient, with W^T . delta
+            /// for the layer below computed in the same sweep over W.
+            WeightGradient,
+            /// Optimizer step on one connection's parameters.
+            Update,
+            /// Summing per-thread gradients in parallel training.
+            Reduction
+        };
+
+        /// Number of Phase values.
+        constexpr int PHASE_COUNT = 7;
+
+        /// Human-readable name of a phase.
+        const char* phaseName(Phase phase);
+
+        /// Totals for one phase of one layer. Layer l is the connection feeding layer l + 1; -1 is network-wide.
+        /// Only sampled calls are measured (see setSamplePeriod): calls is exact, and the other totals weight each
+        /// sample by the calls since the previous one, which is exact for FLOPs and bytes whenever every call of
+        /// the phase has the same shape.
+        struct PhaseStats {
+            /// Phase the totals belong to.
+            Phase phase;
+            /// Connection index, or -1 for network-wide work.
+            int layer;
+            /// Times the phase ran.
+            uint64_t calls = 0;
+            /// Calls that were measured.
+            uint64_t sampledCalls = 0;
+            /// Wall time spent in the phase.
+            uint64_t nanoseconds = 0;
+            /// Floating-point operations performed, counting a fused multiply-add as two.
+            uint64_t flops = 0;
+            /// Bytes of operands read and written, assuming no cache reuse between calls.
+            uint64_t bytes = 0;
+            /// Matrix heap allocations made while the phase ran.
+            uint64_t allocations = 0;
+        };
+
+        /// Whether the library was built with profiling.
+        bool enabled();
+
+        /// Forget all recorded totals and trace events. Call while no instrumented code is running.
+        void reset();
+
+        /// Default of setSamplePeriod.
+        constexpr uint32_t DEFAULT_SAMPLE_PERIOD = 64;
+
+        /// Measure one call in every period of each phase and layer, starting with the first; the others only
+        /// count themselves, for about 1.5 ns each. Calls longer than about 5 us are measured every time, as the
+        /// clock reads are negligible next to them. Reading the clock costs tens of nanoseconds, as much as a
+        /// whole phase of a narrow layer, so measuring every call (period 1, exact per-phase totals) can slow
+        /// per-example training of a 64-32 network by a quarter; at the default period it stays under 2%.
+        /// Takes effect at each phase's next sample.
+        void setSamplePeriod(uint32_t period);
+        /// Current sampling period.
+        uint32_t samplePeriod();
+
+        /// Also time every call and keep it as a trace event (off by default), regardless of the sampling
+        /// period. At most maxEvents events are kept per thread; later ones are counted in the totals only.
+        void setTracing(bool on, size_t maxEvents = 1 << 20);
+        /// Whether trace events are being kept.
+        bool isTracing();
+
+        /// Totals per (phase, layer) summed over every thread, ordered by layer then phase.
+        /// Call while no instrumented code is running.
+        std::vector<PhaseStats> summary();
+
+        /// Matrix heap allocations made since the last reset, inside or outside any phase.
+        uint64_t allocationCount();
+
+        /// Print the summary as a table with time shares, GFLOP/s and GB/s.
+        void printSummary(std::ostream& out);
+
+        /// Write the kept trace events as Chrome trace-event JSON, viewable in Perfetto or chrome://tracing.
+        void writeChromeTrace(const std::string& path);
+
+        // State behind the recording macros. The common path of a scope is inline, so a call that is not
+        // timed costs a handful of instructions; registration, slot growth and sampling live in Profiler.cpp
+        namespace detail {
+
+            struct TraceEvent {
+                Phase phase;
+                int layer;
+                uint64_t start;
+                uint64_t duration;
+                uint64_t flops;
+                uint64_t bytes;
+            };
+
+            // Totals of one (phase, layer), each sample weighted by the calls it stands for. countdown is the
+            // number of calls left until the next sample and interval what it was last reset to, so
+            // interval - countdown calls are not yet in totals.calls
+            struct Slot {
+                PhaseStats totals;
+                uint32_t countdown = 1;
+                uint32_t interval = 1;
+            };
+
+            // Everything one thread records. Only its owner writes to it; readers run while training is idle.
+            // Times are in ticks of the cycle counter and converted to nanoseconds when read
+            struct ThreadLog {
+                int threadId = 0;
+                int currentLayer = -1;
+                uint64_t allocations = 0;
+                // Slot PHASE_COUNT * (layer + 1) + phase, grown on first use of a layer
+                std::vector<Slot> stats;
+                std::vector<TraceEvent> events;
+            };
+
+            extern constinit thread_local ThreadLog* currentLog;
+            extern std::atomic<bool> tracing;
+
+            ThreadLog& registerThread();
+            void growSlots(ThreadLog& log, size_t index);
+
+            inline ThreadLog& threadLog() {
+                return currentLog ? *currentLog : registerThread();
+            }
+
+            inline size_t slot(ThreadLog& log, Phase phase, int layer) {
+                size_t index = static_cast<size_t>(PHASE_COUNT) * (layer + 1) + static_cast<size_t>(phase);
+
+                if (index >= log.stats.size())
+                    growSlots(log, index);
+
+                return index;
+            }
+
+        }
+
+        /// Counts the enclosing block as one call of a phase on the current layer (see LayerScope), and
+        /// measures it when the call is sampled.
+        class Scope {
+            // Null unless this call is sampled
+            detail::ThreadLog* log = nullptr;
+            // Index of the (phase, layer) totals; nested scopes may grow the table, so no pointer is kept
+            size_t index;
+            uint64_t flops;
+            uint64_t bytes;
+            uint64_t allocationsAtStart;
+            uint64_t start;
+            // Calls this sample stands for
+            uint64_t weight;
+
+            void end();
+
+        public:
+            /// Count a call of a phase and decide whether it is sampled.
+            explicit Scope(Phase Stage) {
+                detail::ThreadLog& current = detail::threadLog();
+                index = detail::slot(current, Stage, current.currentLayer);
+
+                if (--current.stats[index].countdown == 0 || detail::tracing.load(std::memory_order_relaxed))
+                    log = &current;
+            }
+
+            /// Whether this call is measured. BBDNN_PROFILE_SCOPE only evaluates its counts when it is.
+            bool sampled() const { return log != nullptr; }
+            /// Record a sampled call that performs flops operations and moves bytes, and start its clock.
+            void begin(uint64_t Flops, uint64_t Bytes);
+
+            /// Add a sampled call's measurements to the totals.
+            ~Scope() {
+                if (log)
+                    end();
+            }
+
+            Scope(const Scope& other) = delete;
+            Scope& operator=(const Scope& other) = delete;
+        };
+
+        /// Attributes the scopes opened in the enclosing block to a layer, restoring the previous one on exit.
+        class LayerScope {
+            detail::ThreadLog* log;
+            int previous;
+
+        public:
+            /// Make layer the current layer of this thread.
+            explicit LayerScope(int layer) : log(&detail::threadLog()), previous(log->currentLayer) {
+                log->currentLayer = layer;
+            }
+
+            /// Restore the previous layer.
+            ~LayerScope() {
+                log->currentLayer = previous;
+            }
+
+            LayerScope(const LayerScope& other) = delete;
+            LayerScope& operator=(const LayerScope& other) = delete;
+        };
+
+        /// Count one heap allocation against the current thread.
+        void countAllocation();
+
+    }
+
+}
+
+#define BBDNN_PROFILE_CONCAT_INNER(a, b) a##b
+#define BBDNN_PROFILE_CONCAT(a, b) BBDNN_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef BBDNN_ENABLE_PROFILING
+/// Count the rest of the block as one call of a phase, measuring it when sampled. flops and bytes are only
+/// evaluated for sampled calls. Expands to a declaration and a statement, so use it directly in a block.
+#define BBDNN_PROFILE_SCOPE(phase, flops, bytes) \
+    ::bbdnn::profiling::Scope BBDNN_PROFILE_CONCAT(bbdnnProfileScope, __LINE__)(phase); \
+    if (BBDNN_PROFILE_CONCAT(bbdnnProfileScope, __LINE__).sampled()) \
+        BBDNN_PROFILE_CONCAT(bbdnnProfileScope, __LINE__).begin(static_cast<uint64_t>(flops), static_cast<uint64_t>(bytes))
+/// Attribute the rest of the block to a layer.
+#define BBDNN_PROFILE_LAYER(layer) \
+    ::bbdnn::profiling::LayerScope BBDNN_PROFILE_CONCAT(bbdnnProfileLayer, __LINE__)(layer)
+/// Count a heap allocation.
+#define BBDNN_PROFILE_ALLOCATION() ::bbdnn::profiling::countAllocation()
+#else
+#define BBDNN_PROFILE_SCOPE(phase, flops, bytes) ((void)0)
+#define BBDNN_PROFILE_LAYER(layer) ((void)0)
+#define BBDNN_PROFILE_ALLOCATION() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef PRUNING_HPP
+#define PRUNING_HPP
+
+#include <cstddef>
+#include <utility>
+#include "bbdnn/NeuralNetwork.hpp"
+
+namespace bbdnn {
+
+    /// Outcome of a pruning pass.
+    struct PruningReport {
+        /// Weights removed by the pass: zeroed, or dropped along with their neurons.
+        size_t prunedWeights = 0;
+        /// Nonzero weights left across all connections.
+        size_t remainingWeights = 0;
+        /// Hidden neurons removed.
+        int prunedNeurons = 0;
+        /// Connections whose single-row forward pass now reads CSR weights.
+        int sparseConnections = 0;
+    };
+
+    /// Zero every weight with |w| < threshold. Connections whose density falls below the crossover
+    /// (SparseMatrix::crossoverDensity) switch to sparse forward passes, and fine-tuning them keeps the pruned
+    /// weights at zero. Denser connections train every weight again, so prune them once training is finished,
+    /// or again after fine-tuning.
+    PruningReport pruneWeights(NeuralNetwork& network, float threshold);
+
+    /// Zero the smallest sparsity fraction (in [0, 1]) of each connection's weights by magnitude.
+    PruningReport pruneToSparsity(NeuralNetwork& network, float sparsity);
+
+    /// Structured pruning: return a copy of network without the hidden neurons whose outgoing weights have an
+    /// L2 norm below threshold, shrinking their layers and the connections on either side. Neurons whose
+    /// incoming weights are all zero output a constant, so they are removed too and their contribution is
+    /// folded into the next layer's biases exactly. Every layer keeps at least one neuron.
+    std::pair<NeuralNetwork, PruningReport> pruneNeurons(const NeuralNetwork& network, float threshold);
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef QUANTIZATION_HPP
+#define QUANTIZATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bbdnn/Activations.hpp"
+#include "bbdnn/Dataset.hpp"
+#include "bbdnn/Matrix.hpp"
+#include "bbdnn/NeuralNetwork.hpp"
+
+namespace bbdnn {
+
+    /// Settings for post-training quantization.
+    struct QuantizationOptions {
+        /// Percentile of |activation| over the calibration rows that maps to 127. 100 uses the largest
+        /// value seen; a lower value clips rare outliers in exchange for finer steps everywhere else.
+        float percentile = 100.0f;
+        /// Most calibration rows used, taken from the start of the dataset.
+        size_t maxCalibrationRows = 2048;
+    };
+
+    /// Caller-owned scratch for one int8 forward pass. Like InferenceContext, each thread keeps its own.
+    struct QuantizedContext {
+        /// Quantized input of the current connection and output of the previous one, each padded to a multiple of 64.
+        std::vector<int8_t> current;
+        /// Quantized output of the current connection, becoming the next connection's input.
+        std::vector<int8_t> next;
+        /// int32 dot products of the current connection.
+        std::vector<int32_t> accumulators;
+        /// Output layer values from the last forward pass.
+        Vector output;
+
+        /// Construct an empty context.
+        QuantizedContext() = default;
+    };
+
+    /// Int8 inference model made from a trained NeuralNetwork by post-training quantization.
+    ///
+    /// Each connection keeps its weights as int8 with one symmetric scale per output neuron, transposed so
+    /// every output is a contiguous dot product, and quantizes its input with a single symmetric scale
+    /// calibrated from sample data. A forward pass runs the int8 x int8 -> int32 GEMV from the kernel table
+    /// (VNNI or maddubs where available), then rescales, adds the bias, applies the activation and quantizes
+    /// for the next connection in one blocked pass over the outputs. Biases and the output layer stay fp32.
+    class QuantizedNetwork {
+        struct Connection {
+            int inputSize = 0;
+            int outputSize = 0;
+            // inputSize rounded up to a multiple of 64; the padding weights are zero
+            int paddedInputSize = 0;
+            // outputSize x paddedInputSize, row o holding the weights into output o
+            std::vector<int8_t> weights;
+            // inputScale * weight scale of each output, turning an int32 dot product back into fp32
+            std::vector<float> outputScales;
+            std::vector<float> biases;
+            // fp32 input = int8 input * inputScale
+            float inputScale = 1.0f;
+            ActivationPtr activation;
+        };
+
+        std::vector<Connection> connections;
+
+        // Entries a context needs in current and next (the widest padded layer) and in accumulators (the
+        // widest connection output)
+        size_t scratchSize = 0;
+        size_t accumulatorSize = 0;
+
+        QuantizedNetwork() = default;
+
+        // Forward pass on a raw input row of inputSize() values
+        const Vector& run(const float* input, QuantizedContext& context) const;
+
+    public:
+        /// Move-construct a quantized network.
+        QuantizedNetwork(QuantizedNetwork&& other) noexcept = default;
+        /// Move-assign a quantized network.
+        QuantizedNetwork& operator=(QuantizedNetwork&& other) noexcept = default;
+
+        /// Quantize a network, calibrating each connection's input range on calibration's feature rows.
+        static QuantizedNetwork quantize(const NeuralNetwork& network, const Dataset& calibration, const QuantizationOptions& options = {});
+
+        /// Predict output for a single input. Safe to call from several threads at once.
+        Vector predict(const Vector& input) const;
+
+        /// Predict output using caller-owned scratch; returns the context's output values. An empty context is
+        /// sized on first use; throws std::invalid_argument for a context sized for a different network.
+        /// Does not allocate once the context has been used, and is safe to call concurrently with one context per thread.
+        const Vector& predict(const Vector& input, QuantizedContext& context) const;
+
+        /// Create a context sized for this network.
+        QuantizedContext createContext() const;
+
+        /// Evaluate on a Dataset's rows and return each example's sum of squared residuals, as NeuralNetwork::evaluate does.
+        std::vector<float> evaluate(const Dataset& testData) const;
+
+        /// Number of connections.
+        int size() const;
+
+        /// Input layer size.
+        int inputSize() const;
+
+        /// Output layer size.
+        int outputSize() const;
+
+        /// Scale of connection l's quantized input: a stored value q stands for q * scale.
+        float inputScale(int l) const;
+
+        /// Bytes held by weights, scales and biases, including padding.
+        size_t memoryBytes() const;
+    };
+
+    /// Accuracy and size of an int8 model next to the fp32 network it was made from.
+    struct QuantizationReport {
+        /// Examples compared.
+        size_t samples = 0;
+        /// Mean SSR of the fp32 network, the NeuralNetwork::evaluate metric.
+        float fp32MeanLoss = 0.0f;
+        /// Mean SSR of the int8 network.
+        float int8MeanLoss = 0.0f;
+        /// Largest absolute difference between an fp32 and an int8 output value.
+        float maxOutputError = 0.0f;
+        /// Mean absolute difference between fp32 and int8 output values.
+        float meanOutputError = 0.0f;
+        /// Bytes of fp32 weights and biases.
+        size_t fp32Bytes = 0;
+        /// Bytes of the int8 model (QuantizedNetwork::memoryBytes).
+        size_t int8Bytes = 0;
+    };
+
+    /// Run both networks on testData's rows and compare their outputs, losses and parameter memory.
+    QuantizationReport compareQuantized(const NeuralNetwork& network, const QuantizedNetwork& quantized, const Dataset& testData);
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "bbdnn/NeuralNetwork.hpp"
+
+namespace bbdnn {
+
+    /// Version written by saveModel; loaders reject any other version.
+    constexpr uint32_t MODEL_FORMAT_VERSION = 1;
+    /// Alignment of every weight and bias blob in a model file, in bytes.
+    constexpr size_t MODEL_BLOB_ALIGNMENT = 64;
+
+    /// Write a network's topology and parameters to a binary model file.
+    ///
+    /// Layout (little-endian):
+    /// - 64-byte header: magic "BBDNNMDL", uint32 version, uint32 layer count, uint64 RNG seed, uint64 file size.
+    /// - One 16-byte record per layer: int32 size, int32 ActivationKind, float p0, float p1
+    ///   (LeakyReLU alpha in p0, Logistic L and K in p0 and p1).
+    /// - One 16-byte record per connection: uint64 weights offset, uint64 biases offset.
+    /// - Row-major (in x out) weights and biases as raw floats, each blob starting on a 64-byte boundary.
+    ///
+    /// Throws if a layer uses a Custom activation, which cannot be recorded.
+    void saveModel(const NeuralNetwork& network, const std::string& path);
+
+    /// Read a model file into a network that owns copies of its parameters. Connections pruned below the sparse
+    /// crossover read CSR weights, as after pruning.
+    NeuralNetwork loadModel(const std::string& path);
+
+    /// A network whose weights and biases point straight into a memory mapping of a model file.
+    ///
+    /// Loading only validates the header and tables; parameters are paged in on first use and processes
+    /// mapping the same file share the page cache. The mapping is private, so training a mapped network
+    /// copies the touched pages and never writes back to the file. Weights are not scanned for sparsity;
+    /// call network().updateSparseWeights() to serve a pruned model from CSR weights.
+    class MappedModel {
+        // Declared before the network so it is released after it
+        std::shared_ptr<void> mapping;
+        std::unique_ptr<NeuralNetwork> model;
+
+    public:
+        /// Map a model file and build a network over it.
+        explicit MappedModel(const std::string& path);
+
+        MappedModel(const MappedModel& other) = delete;
+        MappedModel& operator=(const MappedModel& other) = delete;
+        /// Move-construct, taking the mapping and network.
+        MappedModel(MappedModel&& other) noexcept = default;
+        /// Move-assign, taking the mapping and network.
+        MappedModel& operator=(MappedModel&& other) noexcept;
+
+        /// The mapped network.
+        NeuralNetwork& network();
+        /// The mapped network (const).
+        const NeuralNetwork& network() const;
+    };
+
+}
+
+#endif
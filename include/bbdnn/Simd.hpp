@@ -0,0 +1,102 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "bbdnn/Activations.hpp"
+#include "bbdnn/HalfPrecision.hpp"
+#include "bbdnn/Optimizers.hpp"
+
+namespace bbdnn {
+
+    namespace kernels {
+
+        /// Instruction set a kernel table was compiled for.
+        enum class SimdLevel {
+            Scalar,
+            SSE42,
+            AVX2,
+            AVX512,
+            NEON
+        };
+
+        /// Table of element-wise kernels for one instruction set. All kernels accept aliased in/out buffers.
+        struct KernelTable {
+            /// Instruction set of this table.
+            SimdLevel level;
+
+            /// out[i] = a[i] + b[i].
+            void (*add)(const float* a, const float* b, float* out, size_t n);
+            /// out[i] = a[i] - b[i].
+            void (*sub)(const float* a, const float* b, float* out, size_t n);
+            /// out[i] = a[i] * b[i].
+            void (*mul)(const float* a, const float* b, float* out, size_t n);
+            /// out[i] = a[i] * s.
+            void (*scale)(const float* a, float s, float* out, size_t n);
+            /// out[i] = a[i] / s.
+            void (*divide)(const float* a, float s, float* out, size_t n);
+            /// y[i] += a * x[i].
+            void (*axpy)(float a, const float* x, float* y, size_t n);
+            /// Sum of a[0..n) using 16 interleaved accumulators, bit-identical across instruction sets.
+            float (*sum)(const float* a, size_t n);
+
+            /// out[i] = f(in[i]) for a built-in activation kind (not Custom). p0 and p1 carry the
+            /// activation's parameters: LeakyReLU alpha in p0, Logistic L and K in p0 and p1.
+            void (*activate)(ActivationKind kind, float p0, float p1, const float* in, float* out, size_t n);
+            /// out[i] = f'(in[i]) for a built-in activation kind, with the same parameters as activate.
+            void (*activateDerivative)(ActivationKind kind, float p0, float p1, const float* in, float* out, size_t n);
+
+            /// Fused in-place update of n parameters for a built-in optimizer kind (not Custom), reading and
+            /// writing the rule's state buffers in the same pass. Unused state pointers may be null.
+            void (*optimize)(OptimizerKind kind, const OptimizerStep& step, float* params, const float* grads, float* state0, float* state1, size_t n);
+
+            /// out[i] = in[i] widened from 16-bit precision (BFloat16 or Float16) to fp32.
+            void (*widen)(WeightPrecision precision, const uint16_t* in, float* out, size_t n);
+            /// out[i] = in[i] rounded to 16-bit precision (BFloat16 or Float16), to nearest even.
+            void (*narrow)(WeightPrecision precision, const float* in, uint16_t* out, size_t n);
+            /// y += x^T W for a rows x n row-major W stored in 16-bit precision, widened to fp32 as it is loaded.
+            void (*gemvWiden)(WeightPrecision precision, const float* x, const uint16_t* w, float* y, size_t rows, size_t n);
+
+            /// y[r] += dot(x, w + r * stride) over n values, for each of rows rows of w.
+            void (*gemvRows)(const float* x, const float* w, size_t stride, float* y, size_t rows, size_t n);
+            /// y += x^T W for a rows x n matrix W packed in panels of panelWidth columns: panel p holds columns
+            /// p * panelWidth onward as rows contiguous runs of panelWidth values, zero past column n.
+            void (*gemvPanels)(const float* x, const float* panels, float* y, size_t rows, size_t n);
+            /// Columns per panel of gemvPanels, four registers wide.
+            size_t panelWidth;
+            /// Fused dense layer on one input: z = x^T W + b and a = f(z) for a built-in activation kind (not Custom),
+            /// with W packed as for gemvPanels and p0, p1 as for activate. Each panel's sums get the bias, are stored
+            /// and activated while still in registers. z may be null to skip storing it.
+            void (*denseForward)(ActivationKind kind, float p0, float p1, const float* x, const float* panels, const float* bias,
+                                 float* z, float* a, size_t rows, size_t n);
+            /// Fused backward pass of a dense layer over batch examples, reading each weight of the rows x n row-major W
+            /// once: gradient = scale * X^T Delta (added to gradient when accumulate is set) and, unless sensitivity is
+            /// null, sensitivity = (Delta W^T) * derivatives elementwise. X, derivatives and sensitivity are batch x rows,
+            /// Delta is batch x n and gradient rows x n, all row-major.
+            void (*denseBackward)(const float* x, const float* delta, const float* w, const float* derivatives, float scale,
+                                  bool accumulate, float* gradient, float* sensitivity, size_t batch, size_t rows, size_t n);
+
+            /// out[r] = sum of x[i] * w[r * k + i] over i < k, for each of rows contiguous rows of w, exact in int32.
+            /// k must be a multiple of 64, and every value of x and w must lie in [-127, 127].
+            void (*gemvInt8)(const int8_t* x, const int8_t* w, int32_t* out, size_t rows, size_t k);
+            /// Instruction sequence gemvInt8 uses, e.g. "avx2-maddubs" or "avx512-vnni".
+            const char* gemvInt8Name;
+        };
+
+        /// Widest instruction set supported by both this build and the running CPU.
+        SimdLevel detectSimdLevel();
+        /// Whether kernels for a level were compiled in and can run on this CPU.
+        bool isSimdLevelAvailable(SimdLevel level);
+        /// Human-readable name of a level.
+        const char* simdLevelName(SimdLevel level);
+
+        /// Kernel table for the detected level, selected once on first use.
+        const KernelTable& kernelTable();
+        /// Kernel table for a specific level. Throws if the level is unavailable.
+        const KernelTable& kernelTable(SimdLevel level);
+
+    }
+
+}
+
+#endif
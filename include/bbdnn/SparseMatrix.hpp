@@ -0,0 +1,77 @@
+#ifndef SPARSEMATRIX_HPP
+#define SPARSEMATRIX_HPP
+
+#include <cstddef>
+#include <vector>
+#include "bbdnn/Matrix.hpp"
+
+namespace bbdnn {
+
+    /// Default density below which single-row forward passes read CSR weights instead of dense ones.
+    constexpr float SPARSE_SINGLE_CROSSOVER = 0.1f;
+    /// Default density below which batched forward passes read CSR weights instead of dense ones.
+    constexpr float SPARSE_BATCHED_CROSSOVER = 0.15f;
+
+    /// Compressed sparse row (CSR) matrix of floats holding the nonzero entries of a dense Matrix.
+    ///
+    /// Rows are stored in order, each as a run of (column, value) pairs. For a connection's weights
+    /// (in x out) a row is the fan-out of one input, so y += x^T S visits each nonzero once and skips
+    /// inputs that are zero, as ReLU outputs often are.
+    class SparseMatrix {
+        int rows = 0;
+        int cols = 0;
+        // rows + 1 offsets into columns and values; row r holds entries rowStarts[r] .. rowStarts[r + 1]
+        std::vector<int> rowStarts;
+        std::vector<int> columns;
+        std::vector<float> values;
+
+    public:
+        /// Create an empty matrix (0x0).
+        SparseMatrix() = default;
+        /// Compress the nonzero entries of a dense matrix.
+        explicit SparseMatrix(const Matrix& dense);
+
+        /// Number of rows.
+        int Rows() const;
+        /// Number of columns.
+        int Cols() const;
+        /// Number of stored (nonzero) entries.
+        int nonZeros() const;
+        /// Fraction of entries stored: nonZeros() / (Rows() * Cols()).
+        float density() const;
+        /// Whether the matrix holds no rows.
+        bool empty() const;
+
+        /// Expand back to a dense matrix.
+        Matrix toDense() const;
+
+        /// y += x^T S for x of Rows() values and y of Cols() values.
+        void multiplyAdd(const float* x, float* y) const;
+
+        /// Y += X S for batch rows: X is batch x Rows() with row stride ldx, Y is batch x Cols() with row stride ldy.
+        void multiplyAdd(const float* X, int ldx, float* Y, int ldy, int batch) const;
+
+        /// Zero the entries of dense (Rows() x Cols()) outside the stored pattern and copy the rest into the
+        /// stored values, so the pattern acts as a pruning mask while dense is trained.
+        void applyPattern(Matrix& dense);
+
+        /// Bytes held by offsets, column indices and values.
+        size_t memoryBytes() const;
+
+        /// Density below which forward passes read CSR weights, for one row (batchSize 1) or for a batch.
+        /// SPARSE_SINGLE_CROSSOVER and SPARSE_BATCHED_CROSSOVER unless changed, so which kernel runs, and
+        /// with it the exact results, does not depend on timing.
+        static float crossoverDensity(int batchSize);
+
+        /// Set the crossover densities; 0 disables a sparse path and 1 always takes it.
+        static void setCrossoverDensity(float single, float batched);
+
+        /// Time multiplyAdd against the dense GEMM on random 512x512 patterns of rising density and use the
+        /// highest densities where it still wins as the crossovers. Opt-in: takes about a second, and timing
+        /// noise can move the result between runs.
+        static void measureCrossoverDensity();
+    };
+
+}
+
+#endif
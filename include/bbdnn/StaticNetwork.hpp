@@ -0,0 +1,328 @@
+#ifndef STATICNETWORK_HPP
+#define STATICNETWORK_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "bbdnn/Activations.hpp"
+#include "bbdnn/NeuralNetwork.hpp"
+
+namespace bbdnn {
+
+    /// Activations resolved at compile time for StaticNetwork. Each mirrors the scalar math of the
+    /// IActivation with the same name and is inlined into the forward and backward passes.
+    namespace StaticActivation {
+
+        /// f(x) = x.
+        struct Linear {
+            static constexpr ActivationKind kind = ActivationKind::Linear;
+
+            float operator()(float x) const { return x; }
+            float derive(float) const { return 1.0f; }
+            void copyParameters(const IActivation&) { }
+        };
+
+        /// f(x) = max(0, x).
+        struct ReLU {
+            static constexpr ActivationKind kind = ActivationKind::ReLU;
+
+            float operator()(float x) const { return x > 0 ? x : 0; }
+            float derive(float x) const { return x > 0 ? 1.0f : 0.0f; }
+            void copyParameters(const IActivation&) { }
+        };
+
+        /// Leaky ReLU with configurable negative slope.
+        struct LeakyReLU {
+            static constexpr ActivationKind kind = ActivationKind::LeakyReLU;
+
+            /// Slope for negative inputs.
+            float alpha = 0.01f;
+
+            float operator()(float x) const { return x > 0 ? x : alpha * x; }
+            float derive(float x) const { return x > 0 ? 1.0f : alpha; }
+            void copyParameters(const IActivation& source) { alpha = static_cast<const LeakyReLUActivation&>(source).alpha; }
+        };
+
+        /// Sigmoid.
+        struct Sigmoid {
+            static constexpr ActivationKind kind = ActivationKind::Sigmoid;
+
+            float operator()(float x) const { return 1.0f / (1.0f + std::exp(-x)); }
+            float derive(float x) const { float s = (*this)(x); return s * (1 - s); }
+            void copyParameters(const IActivation&) { }
+        };
+
+        /// Logistic with configurable L and K.
+        struct Logistic {
+            static constexpr ActivationKind kind = ActivationKind::Logistic;
+
+            /// Maximum value of the curve.
+            float l = 1.0f;
+            /// Steepness of the curve.
+            float k = 1.0f;
+
+            float operator()(float x) const { return l / (1 + std::exp(-k * x)); }
+            float derive(float x) const { float v = (*this)(x); return v * (1 - v); }
+            void copyParameters(const IActivation& source) {
+                const auto& logistic = static_cast<const LogisticActivation&>(source);
+                l = logistic.l;
+                k = logistic.k;
+            }
+        };
+
+        /// Hyperbolic tangent.
+        struct Tanh {
+            static constexpr ActivationKind kind = ActivationKind::Tanh;
+
+            float operator()(float x) const { return std::tanh(x); }
+            float derive(float x) const { float t = std::tanh(x); return 1 - t * t; }
+            void copyParameters(const IActivation&) { }
+        };
+
+    }
+
+    /// Compile-time layer description: neuron count and activation type.
+    template <int N, typename Act>
+    struct StaticLayer {
+        static_assert(N > 0, "Layer size must be positive");
+
+        /// Number of neurons.
+        static constexpr int size = N;
+        /// Activation type from StaticActivation.
+        using Activation = Act;
+    };
+
+    /// Fixed-size weights and biases between two static layers. Weights are (in x out), matching LayerConnection.
+    template <int In, int Out>
+    struct StaticConnection {
+        /// Row-major (In x Out) weights; weights[i * Out + j] connects input i to output j.
+        std::array<float, In * Out> weights {};
+        /// Output biases.
+        std::array<float, Out> biases {};
+    };
+
+    /// Feed-forward network whose topology is fixed at compile time, e.g.
+    /// StaticNetwork<StaticLayer<2, StaticActivation::Linear>, StaticLayer<8, StaticActivation::Tanh>, StaticLayer<1, StaticActivation::Sigmoid>>.
+    ///
+    /// Parameters live in std::array storage and every loop has compile-time bounds, so the forward
+    /// and backward passes are unrolled and inlined with no virtual calls or heap allocations.
+    template <typename... Layers>
+    class StaticNetwork {
+        static constexpr int layerCount = sizeof...(Layers);
+        static_assert(layerCount >= 2, "Static network must contain at least 2 layers");
+
+        static constexpr std::array<int, layerCount> layerSizes { Layers::size... };
+
+        template <size_t I>
+        using Values = std::array<float, layerSizes[I]>;
+
+        template <size_t I>
+        using ConnectionAt = StaticConnection<layerSizes[I], layerSizes[I + 1]>;
+
+        template <typename Seq>
+        struct Storage;
+
+        template <size_t... I>
+        struct Storage<std::index_sequence<I...>> {
+            using Connections = std::tuple<ConnectionAt<I>...>;
+        };
+
+        template <typename Seq>
+        struct LayerStorage;
+
+        template <size_t... I>
+        struct LayerStorage<std::index_sequence<I...>> {
+            using Values = std::tuple<StaticNetwork::Values<I>...>;
+        };
+
+        using Connections = typename Storage<std::make_index_sequence<layerCount - 1>>::Connections;
+        using LayerValues = typename LayerStorage<std::make_index_sequence<layerCount>>::Values;
+
+        Connections connections;
+        std::tuple<typename Layers::Activation...> activations;
+
+        // Per-layer state kept for trainStep
+        LayerValues activated {};
+        LayerValues unactivated {};
+
+        // Z = A.W + b and A' = f(Z) for connection I
+        template <size_t I>
+        void propagate(const Values<I>& in, Values<I + 1>& z, Values<I + 1>& a) const {
+            constexpr int inSize = layerSizes[I];
+            constexpr int outSize = layerSizes[I + 1];
+            const ConnectionAt<I>& connection = std::get<I>(connections);
+            const auto& activation = std::get<I + 1>(activations);
+
+            z = connection.biases;
+            for (int i = 0; i < inSize; i++)
+                for (int j = 0; j < outSize; j++)
+                    z[j] += in[i] * connection.weights[i * outSize + j];
+
+            for (int j = 0; j < outSize; j++)
+                a[j] = activation(z[j]);
+        }
+
+        template <size_t I>
+        Values<layerCount - 1> predictFrom(const Values<I>& in) const {
+            if constexpr (I == layerCount - 1) {
+                return in;
+            }
+            else {
+                Values<I + 1> z;
+                Values<I + 1> a;
+                propagate<I>(in, z, a);
+                return predictFrom<I + 1>(a);
+            }
+        }
+
+        template <size_t I>
+        void forwardFrom() {
+            if constexpr (I < layerCount - 1) {
+                propagate<I>(std::get<I>(activated), std::get<I + 1>(unactivated), std::get<I + 1>(activated));
+                forwardFrom<I + 1>();
+            }
+        }
+
+        // Update connection I from the sensitivity of layer I + 1, first propagating it to layer I
+        // with the pre-update weights (as backPropagate does before takeStep)
+        template <size_t I>
+        void backwardFrom(const Values<I + 1>& delta, float learningRate) {
+            constexpr int inSize = layerSizes[I];
+            constexpr int outSize = layerSizes[I + 1];
+            ConnectionAt<I>& connection = std::get<I>(connections);
+            const Values<I>& in = std::get<I>(activated);
+
+            Values<I> previousDelta {};
+            if constexpr (I > 0) {
+                const auto& activation = std::get<I>(activations);
+                const Values<I>& z = std::get<I>(unactivated);
+
+                for (int i = 0; i < inSize; i++) {
+                    float sensitivity = 0;
+                    for (int j = 0; j < outSize; j++)
+                        sensitivity += delta[j] * connection.weights[i * outSize + j];
+
+                    previousDelta[i] = sensitivity * activation.derive(z[i]);
+                }
+            }
+
+            for (int i = 0; i < inSize; i++)
+                for (int j = 0; j < outSize; j++)
+                    connection.weights[i * outSize + j] -= learningRate * in[i] * delta[j];
+
+            for (int j = 0; j < outSize; j++)
+                connection.biases[j] -= learningRate * delta[j];
+
+            if constexpr (I > 0)
+                backwardFrom<I - 1>(previousDelta, learningRate);
+        }
+
+        template <size_t I>
+        void loadFrom(const NeuralNetwork& network) {
+            if constexpr (I < layerCount) {
+                const DenseLayer& layer = network.getLayer(I);
+                auto& activation = std::get<I>(activations);
+                using Act = std::tuple_element_t<I, std::tuple<typename Layers::Activation...>>;
+
+                if (layer.size() != layerSizes[I])
+                    throw std::invalid_argument("Network layer size does not match the static layer size.");
+
+                if (layer.getActivationFunction()->kind() != Act::kind)
+                    throw std::invalid_argument("Network activation does not match the static layer activation.");
+
+                activation.copyParameters(*layer.getActivationFunction());
+
+                if constexpr (I < layerCount - 1) {
+                    const LayerConnection& source = network.getConnections()[I];
+                    ConnectionAt<I>& connection = std::get<I>(connections);
+
+                    const float* weights = source.getWeights().rawData();
+                    std::copy(weights, weights + connection.weights.size(), connection.weights.begin());
+
+                    for (int j = 0; j < layerSizes[I + 1]; j++)
+                        connection.biases[j] = source.biasAt(j);
+                }
+
+                loadFrom<I + 1>(network);
+            }
+        }
+
+    public:
+        /// Input values.
+        using Input = Values<0>;
+        /// Output values.
+        using Output = Values<layerCount - 1>;
+
+        /// Construct with zeroed parameters and default activation parameters.
+        StaticNetwork() = default;
+
+        /// Construct from the parameters of a dynamic network with the same topology.
+        explicit StaticNetwork(const NeuralNetwork& network) {
+            load(network);
+        }
+
+        /// Copy weights, biases and activation parameters from a dynamic network. Throws if the topology differs.
+        void load(const NeuralNetwork& network) {
+            if (network.size() != layerCount)
+                throw std::invalid_argument("Network layer count does not match the static network.");
+
+            loadFrom<0>(network);
+        }
+
+        /// Connection I (between layers I and I + 1).
+        template <size_t I>
+        const ConnectionAt<I>& getConnection() const {
+            return std::get<I>(connections);
+        }
+
+        /// Connection I (between layers I and I + 1) for writing.
+        template <size_t I>
+        ConnectionAt<I>& getConnection() {
+            return std::get<I>(connections);
+        }
+
+        /// Predict output for a single input without touching training state.
+        Output predict(const Input& input) const {
+            return predictFrom<0>(input);
+        }
+
+        /// One SGD step on a single example, matching NeuralNetwork::train with isStochastic = true.
+        /// Returns the squared residual of the prediction made before the update.
+        float trainStep(const Input& input, const Output& expected, float learningRate) {
+            constexpr size_t last = layerCount - 1;
+
+            std::get<0>(activated) = input;
+            forwardFrom<0>();
+
+            const Output& predicted = std::get<last>(activated);
+            const Output& z = std::get<last>(unactivated);
+            const auto& activation = std::get<last>(activations);
+
+            float residualSquared = 0;
+            Output delta;
+            for (int i = 0; i < layerSizes[last]; i++) {
+                float residual = expected[i] - predicted[i];
+                residualSquared += residual * residual;
+                delta[i] = -2 * residual * activation.derive(z[i]);
+            }
+
+            backwardFrom<last - 1>(delta, learningRate);
+
+            return residualSquared;
+        }
+
+        /// Number of layers.
+        static constexpr int size() { return layerCount; }
+        /// Input layer size.
+        static constexpr int inputSize() { return layerSizes[0]; }
+        /// Output layer size.
+        static constexpr int outputSize() { return layerSizes[layerCount - 1]; }
+    };
+
+}
+
+#endif
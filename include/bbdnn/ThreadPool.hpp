@@ -0,0 +1,54 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bbdnn {
+
+    /// Fixed set of worker threads that run indexed tasks in parallel.
+    class ThreadPool {
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+
+        // Current job; workers pick up a new one whenever generation changes
+        const std::function<void(int)>* job = nullptr;
+        int jobCount = 0;
+        std::atomic<int> nextTask { 0 };
+        int busyWorkers = 0;
+        uint64_t generation = 0;
+        bool stopping = false;
+        std::exception_ptr failure;
+
+        void workerLoop();
+        void runTasks();
+
+    public:
+        /// Construct a pool that runs tasks on threadCount threads, including the caller of run().
+        explicit ThreadPool(int threadCount);
+        /// Join all workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+
+        /// Run task(0) ... task(taskCount - 1) across the pool and return once all have finished.
+        /// Tasks may run in any order; the first exception thrown by a task is rethrown here.
+        void run(int taskCount, const std::function<void(int)>& task);
+
+        /// Number of threads, including the caller of run().
+        int size() const;
+    };
+
+}
+
+#endif
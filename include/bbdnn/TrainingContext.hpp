@@ -0,0 +1,25 @@
+#ifndef TRAININGCONTEXT_HPP
+#define TRAININGCONTEXT_HPP
+
+#include <vector>
+#include "bbdnn/DenseLayer.hpp"
+#include "bbdnn/GradientWorkspace.hpp"
+#include "bbdnn/InferenceContext.hpp"
+
+namespace bbdnn {
+
+    /// Activation state and gradient accumulators for one training thread. A network can run
+    /// forward and backward passes on any number of contexts at once while its weights stay read-only.
+    struct TrainingContext : InferenceContext {
+        /// Gradients accumulated by this context.
+        GradientWorkspace gradients;
+
+        /// Construct an empty context.
+        TrainingContext() = default;
+        /// Construct a zeroed context sized for a network's layers.
+        explicit TrainingContext(const std::vector<DenseLayer>& layers);
+    };
+
+}
+
+#endif
@@ -3,9 +3,17 @@
 // An umbrella header to include the entire library
 
 #include "bbdnn/Matrix.hpp"
+#include "bbdnn/MatrixView.hpp"
+#include "bbdnn/Expr.hpp"
+#include "bbdnn/Allocator.hpp"
 #include "bbdnn/Activations.hpp"
 #include "bbdnn/DenseLayer.hpp"
 #include "bbdnn/LayerConnection.hpp"
 #include "bbdnn/NeuralNetwork.hpp"
+#include "bbdnn/StaticNetwork.hpp"
+#include "bbdnn/Serialization.hpp"
+#include "bbdnn/Profiler.hpp"
+#include "bbdnn/Quantization.hpp"
+#include "bbdnn/Pruning.hpp"
 
 #endif
@@ -1,7 +1,26 @@
 #include "bbdnn/Activations.hpp"
+#include "bbdnn/Simd.hpp"
 
 namespace bbdnn {
 
+    void IActivation::apply(const float* in, float* out, size_t n) const {
+        for (size_t i = 0; i < n; i++)
+            out[i] = (*this)(in[i]);
+    }
+
+    void IActivation::deriveInto(const float* in, float* out, size_t n) const {
+        for (size_t i = 0; i < n; i++)
+            out[i] = derive(in[i]);
+    }
+
+    ActivationKind IActivation::kind() const {
+        return ActivationKind::Custom;
+    }
+
+    std::array<float, 2> IActivation::kernelParameters() const {
+        return { 0.0f, 0.0f };
+    }
+
     float LinearActivation::operator()(float x) const {
         return x;
     }
@@ -11,6 +30,18 @@ namespace bbdnn {
         return 1;
     }
 
+    void LinearActivation::apply(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activate(ActivationKind::Linear, 0.0f, 0.0f, in, out, n);
+    }
+
+    void LinearActivation::deriveInto(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activateDerivative(ActivationKind::Linear, 0.0f, 0.0f, in, out, n);
+    }
+
+    ActivationKind LinearActivation::kind() const {
+        return ActivationKind::Linear;
+    }
+
     ActivationPtr LinearActivation::clone() const {
         return std::make_unique<LinearActivation>(*this);
     }
@@ -23,6 +54,18 @@ namespace bbdnn {
         return x > 0 ? 1 : 0;
     }
 
+    void ReLUActivation::apply(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activate(ActivationKind::ReLU, 0.0f, 0.0f, in, out, n);
+    }
+
+    void ReLUActivation::deriveInto(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activateDerivative(ActivationKind::ReLU, 0.0f, 0.0f, in, out, n);
+    }
+
+    ActivationKind ReLUActivation::kind() const {
+        return ActivationKind::ReLU;
+    }
+
     ActivationPtr ReLUActivation::clone() const {
         return std::make_unique<ReLUActivation>(*this);
     }
@@ -37,6 +80,22 @@ namespace bbdnn {
         return x > 0 ? 1 : alpha;
     }
 
+    void LeakyReLUActivation::apply(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activate(ActivationKind::LeakyReLU, alpha, 0.0f, in, out, n);
+    }
+
+    void LeakyReLUActivation::deriveInto(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activateDerivative(ActivationKind::LeakyReLU, alpha, 0.0f, in, out, n);
+    }
+
+    ActivationKind LeakyReLUActivation::kind() const {
+        return ActivationKind::LeakyReLU;
+    }
+
+    std::array<float, 2> LeakyReLUActivation::kernelParameters() const {
+        return { alpha, 0.0f };
+    }
+
     ActivationPtr LeakyReLUActivation::clone() const {
         return std::make_unique<LeakyReLUActivation>(*this);
     }
@@ -50,6 +109,18 @@ namespace bbdnn {
         return sig * (1 - sig);
     }
 
+    void SigmoidActivation::apply(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activate(ActivationKind::Sigmoid, 0.0f, 0.0f, in, out, n);
+    }
+
+    void SigmoidActivation::deriveInto(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activateDerivative(ActivationKind::Sigmoid, 0.0f, 0.0f, in, out, n);
+    }
+
+    ActivationKind SigmoidActivation::kind() const {
+        return ActivationKind::Sigmoid;
+    }
+
     ActivationPtr SigmoidActivation::clone() const {
         return std::make_unique<SigmoidActivation>(*this);
     }
@@ -66,6 +137,22 @@ namespace bbdnn {
         return logVal * (1 - logVal);
     }
 
+    void LogisticActivation::apply(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activate(ActivationKind::Logistic, l, k, in, out, n);
+    }
+
+    void LogisticActivation::deriveInto(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activateDerivative(ActivationKind::Logistic, l, k, in, out, n);
+    }
+
+    ActivationKind LogisticActivation::kind() const {
+        return ActivationKind::Logistic;
+    }
+
+    std::array<float, 2> LogisticActivation::kernelParameters() const {
+        return { l, k };
+    }
+
     ActivationPtr LogisticActivation::clone() const {
         return std::make_unique<LogisticActivation>(*this);
     }
@@ -79,6 +166,18 @@ namespace bbdnn {
         return 1 - t * t;
     }
 
+    void TanhActivation::apply(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activate(ActivationKind::Tanh, 0.0f, 0.0f, in, out, n);
+    }
+
+    void TanhActivation::deriveInto(const float* in, float* out, size_t n) const {
+        kernels::kernelTable().activateDerivative(ActivationKind::Tanh, 0.0f, 0.0f, in, out, n);
+    }
+
+    ActivationKind TanhActivation::kind() const {
+        return ActivationKind::Tanh;
+    }
+
     ActivationPtr TanhActivation::clone() const {
         return std::make_unique<TanhActivation>(*this);
     }
@@ -0,0 +1,74 @@
+#include "bbdnn/AlignedBuffer.hpp"
+#include <algorithm>
+#include <new>
+#include <utility>
+
+namespace bbdnn {
+
+    namespace {
+        constexpr std::align_val_t BUFFER_ALIGNMENT { 64 };
+
+        float* allocateValues(size_t count) {
+            return count == 0 ? nullptr : static_cast<float*>(::operator new(count * sizeof(float), BUFFER_ALIGNMENT));
+        }
+
+        void freeValues(float* values) {
+            if (values)
+                ::operator delete(values, BUFFER_ALIGNMENT);
+        }
+    }
+
+    AlignedBuffer::AlignedBuffer(size_t count) : values(allocateValues(count)), count(count) {
+        std::fill(values, values + count, 0.0f);
+    }
+
+    AlignedBuffer::AlignedBuffer(const AlignedBuffer& other) : values(allocateValues(other.count)), count(other.count) {
+        std::copy(other.values, other.values + count, values);
+    }
+
+    AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) noexcept : values(other.values), count(other.count) {
+        other.values = nullptr;
+        other.count = 0;
+    }
+
+    AlignedBuffer::~AlignedBuffer() {
+        freeValues(values);
+    }
+
+    AlignedBuffer& AlignedBuffer::operator=(const AlignedBuffer& other) {
+        if (this == &other)
+            return *this;
+
+        if (count != other.count) {
+            freeValues(values);
+            values = allocateValues(other.count);
+            count = other.count;
+        }
+
+        std::copy(other.values, other.values + count, values);
+        return *this;
+    }
+
+    AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other) noexcept {
+        std::swap(values, other.values);
+        std::swap(count, other.count);
+        return *this;
+    }
+
+    float* AlignedBuffer::data() {
+        return values;
+    }
+
+    const float* AlignedBuffer::data() const {
+        return values;
+    }
+
+    size_t AlignedBuffer::size() const {
+        return count;
+    }
+
+    bool AlignedBuffer::empty() const {
+        return count == 0;
+    }
+
+}
@@ -0,0 +1,270 @@
+#include "bbdnn/Allocator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <new>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    namespace {
+
+        constexpr std::align_val_t ALIGNMENT { MATRIX_ALIGNMENT };
+
+        /// Floats in one cache line. Arena and pool buffers are whole lines, so each one starts aligned.
+        constexpr size_t LINE_FLOATS = MATRIX_ALIGNMENT / sizeof(float);
+
+        size_t linesFor(size_t count) {
+            return (count + LINE_FLOATS - 1) / LINE_FLOATS;
+        }
+
+        float* allocateAligned(size_t count) {
+            return static_cast<float*>(::operator new(count * sizeof(float), ALIGNMENT));
+        }
+
+        void freeAligned(float* values) {
+            ::operator delete(values, ALIGNMENT);
+        }
+
+        void countAllocation(AllocatorStats& stats, size_t bytes) {
+            stats.bytesInUse += bytes;
+            stats.peakBytes = std::max(stats.peakBytes, stats.bytesInUse);
+            stats.liveAllocations++;
+            stats.totalAllocations++;
+        }
+
+        // Pool class of a buffer of lines cache lines: exact up to 8, then the top three bits rounded up
+        size_t poolClass(size_t lines) {
+            if (lines <= 8)
+                return lines;
+
+            size_t step = size_t(1) << (std::bit_width(lines) - 3);
+            return (lines + step - 1) & ~(step - 1);
+        }
+
+        // Any thread may free a heap matrix, so the counters are atomic
+        class HeapAllocator final : public IMatrixAllocator {
+            std::atomic<size_t> bytesInUse { 0 };
+            std::atomic<size_t> peakBytes { 0 };
+            std::atomic<size_t> liveAllocations { 0 };
+            std::atomic<uint64_t> totalAllocations { 0 };
+
+        public:
+            constexpr HeapAllocator() = default;
+
+            float* allocate(size_t count) override {
+                if (count == 0)
+                    return nullptr;
+
+                float* values = allocateAligned(count);
+
+                size_t inUse = bytesInUse.fetch_add(count * sizeof(float), std::memory_order_relaxed) + count * sizeof(float);
+                size_t peak = peakBytes.load(std::memory_order_relaxed);
+                while (inUse > peak && !peakBytes.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) { }
+
+                liveAllocations.fetch_add(1, std::memory_order_relaxed);
+                totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+                return values;
+            }
+
+            void deallocate(float* data, size_t count) override {
+                if (data == nullptr)
+                    return;
+
+                freeAligned(data);
+                bytesInUse.fetch_sub(count * sizeof(float), std::memory_order_relaxed);
+                liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            AllocatorStats stats() const override {
+                AllocatorStats result;
+                result.bytesInUse = bytesInUse.load(std::memory_order_relaxed);
+                result.peakBytes = peakBytes.load(std::memory_order_relaxed);
+                result.liveAllocations = liveAllocations.load(std::memory_order_relaxed);
+                result.totalAllocations = totalAllocations.load(std::memory_order_relaxed);
+
+                return result;
+            }
+        };
+
+        // Constant-initialized, so matrices built during static initialization in other files can use it
+        constinit HeapAllocator heap;
+        constinit std::atomic<IMatrixAllocator*> defaultAllocator { &heap };
+
+        // Innermost AllocatorScope of this thread; null outside any scope
+        thread_local IMatrixAllocator* scopedAllocator = nullptr;
+
+    }
+
+    MatrixArena::MatrixArena(size_t initialBytes) : firstBlockBytes(std::max(initialBytes, MATRIX_ALIGNMENT)) { }
+
+    MatrixArena::~MatrixArena() {
+        releaseBlocks();
+    }
+
+    void MatrixArena::addBlock(size_t minimumCount) {
+        // The first block has the requested size; later ones at least double the reservation
+        size_t count = blocks.empty() ? firstBlockBytes / sizeof(float) : capacity() / sizeof(float);
+        count = linesFor(std::max(count, minimumCount)) * LINE_FLOATS;
+
+        blocks.push_back({ allocateAligned(count), count });
+        top = 0;
+    }
+
+    void MatrixArena::releaseBlocks() {
+        for (const Block& block : blocks)
+            freeAligned(block.values);
+
+        blocks.clear();
+        top = 0;
+    }
+
+    float* MatrixArena::allocate(size_t count) {
+        if (count == 0)
+            return nullptr;
+
+        size_t rounded = linesFor(count) * LINE_FLOATS;
+
+        if (blocks.empty() || top + rounded > blocks.back().capacity)
+            addBlock(rounded);
+
+        float* values = blocks.back().values + top;
+        top += rounded;
+        countAllocation(counters, rounded * sizeof(float));
+
+        return values;
+    }
+
+    void MatrixArena::deallocate(float* data, size_t count) {
+        if (data == nullptr)
+            return;
+
+        size_t rounded = linesFor(count) * LINE_FLOATS;
+        counters.liveAllocations--;
+
+        // Temporaries usually die in reverse order of creation, so the newest buffer can be handed out again
+        if (top >= rounded && data == blocks.back().values + (top - rounded)) {
+            top -= rounded;
+            counters.bytesInUse -= rounded * sizeof(float);
+        }
+    }
+
+    AllocatorStats MatrixArena::stats() const {
+        return counters;
+    }
+
+    void MatrixArena::reset() {
+        if (counters.liveAllocations != 0)
+            throw std::logic_error("Cannot reset a MatrixArena while matrices still use its storage.");
+
+        // Merge a chain of blocks into one that holds the whole pass
+        if (blocks.size() > 1) {
+            size_t total = capacity() / sizeof(float);
+            releaseBlocks();
+            addBlock(total);
+        }
+
+        top = 0;
+        counters.bytesInUse = 0;
+    }
+
+    size_t MatrixArena::capacity() const {
+        size_t count = 0;
+        for (const Block& block : blocks)
+            count += block.capacity;
+
+        return count * sizeof(float);
+    }
+
+    MatrixPool::~MatrixPool() {
+        for (auto& [lines, buffers] : freeLists)
+            for (float* values : buffers)
+                freeAligned(values);
+    }
+
+    float* MatrixPool::allocate(size_t count) {
+        if (count == 0)
+            return nullptr;
+
+        size_t lines = poolClass(linesFor(count));
+        size_t bytes = lines * MATRIX_ALIGNMENT;
+        float* values = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            auto list = freeLists.find(lines);
+            if (list != freeLists.end() && !list->second.empty()) {
+                values = list->second.back();
+                list->second.pop_back();
+                cached -= bytes;
+            }
+
+            countAllocation(counters, bytes);
+        }
+
+        return values != nullptr ? values : allocateAligned(lines * LINE_FLOATS);
+    }
+
+    void MatrixPool::deallocate(float* data, size_t count) {
+        if (data == nullptr)
+            return;
+
+        size_t lines = poolClass(linesFor(count));
+        size_t bytes = lines * MATRIX_ALIGNMENT;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        freeLists[lines].push_back(data);
+        cached += bytes;
+        counters.bytesInUse -= bytes;
+        counters.liveAllocations--;
+    }
+
+    AllocatorStats MatrixPool::stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return counters;
+    }
+
+    size_t MatrixPool::cachedBytes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cached;
+    }
+
+    void MatrixPool::trim() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto& [lines, buffers] : freeLists)
+            for (float* values : buffers)
+                freeAligned(values);
+
+        freeLists.clear();
+        cached = 0;
+    }
+
+    AllocatorScope::AllocatorScope(IMatrixAllocator& allocator) : previous(scopedAllocator) {
+        scopedAllocator = &allocator;
+    }
+
+    AllocatorScope::~AllocatorScope() {
+        scopedAllocator = previous;
+    }
+
+    IMatrixAllocator& currentAllocator() {
+        return scopedAllocator != nullptr ? *scopedAllocator : *defaultAllocator.load(std::memory_order_acquire);
+    }
+
+    void setDefaultAllocator(IMatrixAllocator* allocator) {
+        defaultAllocator.store(allocator != nullptr ? allocator : &heap, std::memory_order_release);
+    }
+
+    IMatrixAllocator& heapAllocator() {
+        return heap;
+    }
+
+    MatrixArena& threadArena() {
+        thread_local MatrixArena arena;
+        return arena;
+    }
+
+}
@@ -0,0 +1,222 @@
+#include "bbdnn/Dataset.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    namespace {
+
+        constexpr char DATASET_MAGIC[8] = { 'B', 'B', 'D', 'N', 'N', 'D', 'A', 'T' };
+        constexpr uint64_t DATASET_BLOB_ALIGNMENT = 64;
+
+        struct DatasetHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t featureCount;
+            uint32_t labelCount;
+            uint32_t reserved0;
+            uint64_t rowCount;
+            uint64_t featuresOffset;
+            uint64_t labelsOffset;
+            uint64_t fileSize;
+            char reserved[8];
+        };
+
+        static_assert(sizeof(DatasetHeader) == 64, "Dataset file header must have a fixed layout");
+
+        uint64_t alignBlob(uint64_t offset) {
+            return (offset + DATASET_BLOB_ALIGNMENT - 1) / DATASET_BLOB_ALIGNMENT * DATASET_BLOB_ALIGNMENT;
+        }
+
+        void requireLittleEndian() {
+            if constexpr (std::endian::native != std::endian::little)
+                throw std::runtime_error("Dataset files are only supported on little-endian hosts.");
+        }
+
+        // Check that a blob of count floats at offset is aligned and inside the file
+        void requireBlob(uint64_t offset, uint64_t count, uint64_t size) {
+            if (offset % DATASET_BLOB_ALIGNMENT != 0)
+                throw std::invalid_argument("Dataset file blob is not 64-byte aligned.");
+
+            if (offset > size || count > (size - offset) / sizeof(float))
+                throw std::invalid_argument("Dataset file blob extends past the end of the file.");
+        }
+
+    }
+
+    Dataset::Dataset(int featureSize, int labelSize)
+        : featureCount(featureSize), labelCount(labelSize) {
+        if (featureSize <= 0 || labelSize <= 0)
+            throw std::invalid_argument("Dataset feature and label sizes must be positive.");
+    }
+
+    Dataset::Dataset(const std::vector<Vector>& features, const std::vector<Vector>& labels)
+        : Dataset(features.empty() ? 1 : features[0].size(), labels.empty() ? 1 : labels[0].size()) {
+        if (features.size() != labels.size())
+            throw std::invalid_argument("Features and labels must be of same count.");
+
+        reserve(features.size());
+
+        for (size_t i = 0; i < features.size(); i++)
+            append(features[i], labels[i]);
+    }
+
+    Dataset Dataset::map(const std::string& path) {
+        requireLittleEndian();
+
+        io::MappedFile file = io::mapFile(path);
+        const char* base = static_cast<const char*>(file.data.get());
+
+        DatasetHeader header;
+        if (file.size < sizeof(DatasetHeader))
+            throw std::invalid_argument("Dataset file is too small to hold a header.");
+
+        std::memcpy(&header, base, sizeof(DatasetHeader));
+
+        if (std::memcmp(header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC)) != 0)
+            throw std::invalid_argument("File is not a bbdnn dataset.");
+
+        if (header.version != DATASET_FORMAT_VERSION)
+            throw std::invalid_argument("Unsupported dataset file version.");
+
+        if (header.fileSize != file.size)
+            throw std::invalid_argument("Dataset file size does not match its header.");
+
+        if (header.featureCount == 0 || header.labelCount == 0 || header.featureCount > INT32_MAX || header.labelCount > INT32_MAX)
+            throw std::invalid_argument("Dataset file has invalid feature or label sizes.");
+
+        if (header.rowCount > file.size / sizeof(float) / std::max(header.featureCount, header.labelCount))
+            throw std::invalid_argument("Dataset file has an invalid row count.");
+
+        requireBlob(header.featuresOffset, header.rowCount * header.featureCount, file.size);
+        requireBlob(header.labelsOffset, header.rowCount * header.labelCount, file.size);
+
+        Dataset dataset(static_cast<int>(header.featureCount), static_cast<int>(header.labelCount));
+        dataset.rowCount = static_cast<size_t>(header.rowCount);
+        dataset.mappedFeatures = reinterpret_cast<const float*>(base + header.featuresOffset);
+        dataset.mappedLabels = reinterpret_cast<const float*>(base + header.labelsOffset);
+        dataset.mapping = std::move(file.data);
+
+        return dataset;
+    }
+
+    void Dataset::save(const std::string& path) const {
+        requireLittleEndian();
+
+        uint64_t featureBytes = static_cast<uint64_t>(rowCount) * featureCount * sizeof(float);
+        uint64_t labelBytes = static_cast<uint64_t>(rowCount) * labelCount * sizeof(float);
+
+        DatasetHeader header {};
+        std::memcpy(header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+        header.version = DATASET_FORMAT_VERSION;
+        header.featureCount = static_cast<uint32_t>(featureCount);
+        header.labelCount = static_cast<uint32_t>(labelCount);
+        header.rowCount = rowCount;
+        header.featuresOffset = alignBlob(sizeof(DatasetHeader));
+        header.labelsOffset = alignBlob(header.featuresOffset + featureBytes);
+        header.fileSize = header.labelsOffset + labelBytes;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Could not open dataset file for writing: " + path);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        const char padding[DATASET_BLOB_ALIGNMENT] = {};
+        auto writeBlob = [&](uint64_t blobOffset, const float* values, uint64_t bytes) {
+            file.write(padding, static_cast<std::streamsize>(blobOffset - static_cast<uint64_t>(file.tellp())));
+            file.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(bytes));
+        };
+
+        writeBlob(header.featuresOffset, featureData(), featureBytes);
+        writeBlob(header.labelsOffset, labelData(), labelBytes);
+
+        if (!file)
+            throw std::runtime_error("Could not write dataset file: " + path);
+    }
+
+    void Dataset::reserve(size_t rows) {
+        featureStorage.reserve(rows * featureCount);
+        labelStorage.reserve(rows * labelCount);
+    }
+
+    void Dataset::append(const float* features, const float* labels) {
+        if (mapping)
+            throw std::logic_error("Cannot append to a mapped dataset.");
+
+        featureStorage.insert(featureStorage.end(), features, features + featureCount);
+        labelStorage.insert(labelStorage.end(), labels, labels + labelCount);
+        rowCount++;
+    }
+
+    void Dataset::append(const Vector& features, const Vector& labels) {
+        if (features.size() != featureCount || labels.size() != labelCount)
+            throw std::invalid_argument("Example sizes must match the dataset's feature and label sizes.");
+
+        append(features.rawData(), labels.rawData());
+    }
+
+    void Dataset::clear() {
+        featureStorage.clear();
+        labelStorage.clear();
+        mapping.reset();
+        mappedFeatures = nullptr;
+        mappedLabels = nullptr;
+        rowCount = 0;
+    }
+
+    size_t Dataset::size() const {
+        return rowCount;
+    }
+
+    bool Dataset::empty() const {
+        return rowCount == 0;
+    }
+
+    int Dataset::featureSize() const {
+        return featureCount;
+    }
+
+    int Dataset::labelSize() const {
+        return labelCount;
+    }
+
+    bool Dataset::isMapped() const {
+        return mapping != nullptr;
+    }
+
+    const float* Dataset::featureRow(size_t i) const {
+        return featureData() + i * featureCount;
+    }
+
+    const float* Dataset::labelRow(size_t i) const {
+        return labelData() + i * labelCount;
+    }
+
+    MatrixView Dataset::featureRows(size_t first, int count) const {
+        if (count < 0 || first > rowCount || static_cast<size_t>(count) > rowCount - first)
+            throw std::invalid_argument("Batch exceeds the dataset's rows.");
+
+        return MatrixView(featureRow(first), count, featureCount, featureCount);
+    }
+
+    MatrixView Dataset::labelRows(size_t first, int count) const {
+        if (count < 0 || first > rowCount || static_cast<size_t>(count) > rowCount - first)
+            throw std::invalid_argument("Batch exceeds the dataset's rows.");
+
+        return MatrixView(labelRow(first), count, labelCount, labelCount);
+    }
+
+    const float* Dataset::featureData() const {
+        return mapping ? mappedFeatures : featureStorage.data();
+    }
+
+    const float* Dataset::labelData() const {
+        return mapping ? mappedLabels : labelStorage.data();
+    }
+
+}
@@ -0,0 +1,387 @@
+#include "bbdnn/DatasetStream.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    namespace {
+
+        // Parse comma-separated floats into values; returns false on a malformed field
+        bool parseCsvLine(const std::string& line, std::vector<float>& values) {
+            values.clear();
+
+            const char* cursor = line.data();
+            const char* end = line.data() + line.size();
+
+            while (cursor <= end) {
+                const char* fieldEnd = std::find(cursor, end, ',');
+
+                const char* first = cursor;
+                const char* last = fieldEnd;
+                while (first < last && (*first == ' ' || *first == '\t'))
+                    first++;
+                while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r'))
+                    last--;
+
+                // from_chars rejects a leading '+', which some writers emit
+                if (first < last && *first == '+')
+                    first++;
+
+                float value;
+                std::from_chars_result result = std::from_chars(first, last, value);
+                if (result.ec != std::errc() || result.ptr != last)
+                    return false;
+
+                values.push_back(value);
+                cursor = fieldEnd + 1;
+            }
+
+            return true;
+        }
+
+        bool isBlank(const std::string& line) {
+            return line.find_first_not_of(" \t\r") == std::string::npos;
+        }
+
+        uint32_t readBigEndian32(const unsigned char* bytes) {
+            return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+        }
+
+        size_t idxElementSize(int typeCode) {
+            switch (typeCode) {
+                case 0x08: case 0x09: return 1;
+                case 0x0B: return 2;
+                case 0x0C: case 0x0D: return 4;
+                case 0x0E: return 8;
+                default: return 0;
+            }
+        }
+
+        // Decode one big-endian IDX element to float
+        float decodeIdx(int typeCode, const unsigned char* bytes) {
+            switch (typeCode) {
+                case 0x08: return static_cast<float>(bytes[0]);
+                case 0x09: return static_cast<float>(static_cast<int8_t>(bytes[0]));
+                case 0x0B: return static_cast<float>(static_cast<int16_t>((bytes[0] << 8) | bytes[1]));
+                case 0x0C: return static_cast<float>(static_cast<int32_t>(readBigEndian32(bytes)));
+                case 0x0D: {
+                    uint32_t bits = readBigEndian32(bytes);
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return value;
+                }
+                default: {
+                    uint64_t bits = (uint64_t(readBigEndian32(bytes)) << 32) | readBigEndian32(bytes + 4);
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return static_cast<float>(value);
+                }
+            }
+        }
+
+    }
+
+    // ---- CSV ----
+
+    CsvChunkReader::CsvChunkReader(const std::string& Path, int LabelCount, bool hasHeader)
+        : file(Path), path(Path), labelCount(LabelCount) {
+        if (!file)
+            throw std::runtime_error("Could not open CSV file: " + path);
+
+        if (labelCount <= 0)
+            throw std::invalid_argument("CSV label count must be positive.");
+
+        if (hasHeader && std::getline(file, line))
+            lineNumber++;
+
+        dataStart = file.tellg();
+        firstLineNumber = lineNumber;
+
+        // Size the rows from the first example, then come back to it
+        while (std::getline(file, line)) {
+            lineNumber++;
+
+            if (isBlank(line))
+                continue;
+
+            if (!parseCsvLine(line, row))
+                throw std::invalid_argument("Malformed CSV value on line " + std::to_string(lineNumber) + " of " + path);
+
+            featureCount = static_cast<int>(row.size()) - labelCount;
+            break;
+        }
+
+        if (featureCount <= 0)
+            throw std::invalid_argument("CSV file must have more columns than labels: " + path);
+
+        rewind();
+    }
+
+    int CsvChunkReader::featureSize() const {
+        return featureCount;
+    }
+
+    int CsvChunkReader::labelSize() const {
+        return labelCount;
+    }
+
+    void CsvChunkReader::readChunk(Dataset& chunk, size_t maxRows) {
+        chunk.clear();
+
+        while (chunk.size() < maxRows && std::getline(file, line)) {
+            lineNumber++;
+
+            if (isBlank(line))
+                continue;
+
+            if (!parseCsvLine(line, row))
+                throw std::invalid_argument("Malformed CSV value on line " + std::to_string(lineNumber) + " of " + path);
+
+            if (static_cast<int>(row.size()) != featureCount + labelCount)
+                throw std::invalid_argument("Wrong column count on line " + std::to_string(lineNumber) + " of " + path);
+
+            chunk.append(row.data(), row.data() + featureCount);
+        }
+
+        if (file.bad())
+            throw std::runtime_error("Could not read CSV file: " + path);
+    }
+
+    void CsvChunkReader::rewind() {
+        file.clear();
+        file.seekg(dataStart);
+        lineNumber = firstLineNumber;
+    }
+
+    // ---- IDX ----
+
+    void IdxChunkReader::open(IdxFile& file, const std::string& path) {
+        file.path = path;
+        file.stream.open(path, std::ios::binary);
+        if (!file.stream)
+            throw std::runtime_error("Could not open IDX file: " + path);
+
+        unsigned char magic[4];
+        if (!file.stream.read(reinterpret_cast<char*>(magic), sizeof(magic)) || magic[0] != 0 || magic[1] != 0)
+            throw std::invalid_argument("File is not an IDX file: " + path);
+
+        file.typeCode = magic[2];
+        file.elementSize = idxElementSize(file.typeCode);
+        file.dimensions = magic[3];
+
+        if (file.elementSize == 0 || file.dimensions == 0)
+            throw std::invalid_argument("IDX file has an unsupported type or no dimensions: " + path);
+
+        file.rowSize = 1;
+
+        for (int d = 0; d < file.dimensions; d++) {
+            unsigned char bytes[4];
+            if (!file.stream.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+                throw std::invalid_argument("IDX file header is truncated: " + path);
+
+            if (d == 0)
+                file.count = readBigEndian32(bytes);
+            else
+                file.rowSize *= readBigEndian32(bytes);
+        }
+
+        if (file.rowSize == 0 || file.rowSize > INT32_MAX)
+            throw std::invalid_argument("IDX file has an invalid row size: " + path);
+
+        file.dataStart = file.stream.tellg();
+    }
+
+    void IdxChunkReader::readValues(IdxFile& file, size_t rows, float scale, float* out) {
+        size_t values = rows * file.rowSize;
+        file.buffer.resize(values * file.elementSize);
+
+        if (!file.stream.read(file.buffer.data(), static_cast<std::streamsize>(file.buffer.size())))
+            throw std::runtime_error("IDX file is truncated: " + file.path);
+
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(file.buffer.data());
+        for (size_t i = 0; i < values; i++)
+            out[i] = decodeIdx(file.typeCode, bytes + i * file.elementSize) * scale;
+    }
+
+    IdxChunkReader::IdxChunkReader(const std::string& imagesPath, const std::string& labelsPath, int ClassCount, float FeatureScale)
+        : classCount(ClassCount), featureScale(FeatureScale) {
+        open(images, imagesPath);
+        open(labels, labelsPath);
+
+        if (images.count != labels.count)
+            throw std::invalid_argument("IDX image and label files hold different numbers of examples.");
+
+        if (labels.dimensions == 1 && classCount <= 0)
+            throw std::invalid_argument("Class count must be positive for IDX class-index labels.");
+
+        featureRow.resize(images.rowSize);
+        labelRow.resize(labelSize());
+    }
+
+    int IdxChunkReader::featureSize() const {
+        return static_cast<int>(images.rowSize);
+    }
+
+    int IdxChunkReader::labelSize() const {
+        return labels.dimensions == 1 ? classCount : static_cast<int>(labels.rowSize);
+    }
+
+    void IdxChunkReader::readChunk(Dataset& chunk, size_t maxRows) {
+        chunk.clear();
+
+        size_t rows = std::min(maxRows, images.count - position);
+        chunk.reserve(rows);
+
+        for (size_t r = 0; r < rows; r++) {
+            readValues(images, 1, featureScale, featureRow.data());
+
+            if (labels.dimensions == 1) {
+                float classIndex;
+                readValues(labels, 1, 1.0f, &classIndex);
+
+                if (classIndex < 0 || classIndex >= static_cast<float>(classCount))
+                    throw std::invalid_argument("IDX label is outside the class count: " + labels.path);
+
+                std::fill(labelRow.begin(), labelRow.end(), 0.0f);
+                labelRow[static_cast<size_t>(classIndex)] = 1.0f;
+            }
+            else {
+                readValues(labels, 1, 1.0f, labelRow.data());
+            }
+
+            chunk.append(featureRow.data(), labelRow.data());
+        }
+
+        position += rows;
+    }
+
+    void IdxChunkReader::rewind() {
+        for (IdxFile* file : { &images, &labels }) {
+            file->stream.clear();
+            file->stream.seekg(file->dataStart);
+        }
+
+        position = 0;
+    }
+
+    // ---- Stream ----
+
+    DatasetStream::DatasetStream(std::unique_ptr<IChunkReader> Reader, size_t ChunkRows)
+        : reader(std::move(Reader)), chunkRows(ChunkRows),
+          filling(reader ? reader->featureSize() : 1, reader ? reader->labelSize() : 1),
+          ready(filling) {
+        if (!reader)
+            throw std::invalid_argument("Dataset stream needs a reader.");
+
+        if (chunkRows == 0)
+            throw std::invalid_argument("Chunk size must be positive.");
+
+        start();
+    }
+
+    DatasetStream::~DatasetStream() {
+        stop();
+    }
+
+    std::unique_ptr<DatasetStream> DatasetStream::csv(const std::string& path, int labelCount, size_t chunkRows, bool hasHeader) {
+        return std::make_unique<DatasetStream>(std::make_unique<CsvChunkReader>(path, labelCount, hasHeader), chunkRows);
+    }
+
+    std::unique_ptr<DatasetStream> DatasetStream::idx(const std::string& imagesPath, const std::string& labelsPath, int classCount, size_t chunkRows, float featureScale) {
+        return std::make_unique<DatasetStream>(std::make_unique<IdxChunkReader>(imagesPath, labelsPath, classCount, featureScale), chunkRows);
+    }
+
+    void DatasetStream::prefetch() {
+        try {
+            while (true) {
+                // Read outside the lock so the caller can take the ready chunk meanwhile
+                reader->readChunk(filling, chunkRows);
+
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this] { return !hasReady || stopping; });
+
+                if (stopping)
+                    return;
+
+                if (filling.empty()) {
+                    finished = true;
+                    changed.notify_all();
+                    return;
+                }
+
+                std::swap(filling, ready);
+                hasReady = true;
+                changed.notify_all();
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            error = std::current_exception();
+            finished = true;
+            changed.notify_all();
+        }
+    }
+
+    void DatasetStream::start() {
+        hasReady = false;
+        finished = false;
+        stopping = false;
+        error = nullptr;
+
+        prefetcher = std::thread(&DatasetStream::prefetch, this);
+    }
+
+    void DatasetStream::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        changed.notify_all();
+
+        if (prefetcher.joinable())
+            prefetcher.join();
+    }
+
+    bool DatasetStream::next(Dataset& chunk) {
+        if (chunk.featureSize() != featureSize() || chunk.labelSize() != labelSize())
+            throw std::invalid_argument("Chunk sizes must match the stream's feature and label sizes.");
+
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return hasReady || finished; });
+
+        if (hasReady) {
+            std::swap(chunk, ready);
+            hasReady = false;
+            changed.notify_all();
+            return true;
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+
+        return false;
+    }
+
+    void DatasetStream::rewind() {
+        stop();
+        reader->rewind();
+        start();
+    }
+
+    int DatasetStream::featureSize() const {
+        return reader->featureSize();
+    }
+
+    int DatasetStream::labelSize() const {
+        return reader->labelSize();
+    }
+
+    size_t DatasetStream::chunkSize() const {
+        return chunkRows;
+    }
+
+}
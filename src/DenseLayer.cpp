@@ -1,4 +1,5 @@
 #include "bbdnn/DenseLayer.hpp"
+#include <algorithm>
 
 namespace bbdnn {
 
@@ -7,10 +8,15 @@ namespace bbdnn {
             throw std::invalid_argument("Activation function pointer cannot be null.");
     }
 
-    DenseLayer::DenseLayer(const DenseLayer& other) : neuronCount(other.neuronCount), activatedValues(other.activatedValues), unactivatedValues(other.unactivatedValues) {
+    DenseLayer::DenseLayer(const DenseLayer& other) : neuronCount(other.neuronCount), activatedValues(other.activatedValues), unactivatedValues(other.unactivatedValues),
+        activatedBatch(other.activatedBatch), unactivatedBatch(other.unactivatedBatch), batchRows(other.batchRows) {
         activation = std::move(other.activation->clone());
     }
 
+    DenseLayer::DenseLayer(DenseLayer&& other) noexcept = default;
+
+    DenseLayer& DenseLayer::operator=(DenseLayer&& other) noexcept = default;
+
     DenseLayer& DenseLayer::operator=(DenseLayer& other) {
         if (this == &other)
             return *this;
@@ -18,6 +24,9 @@ namespace bbdnn {
         neuronCount = other.neuronCount;
         activatedValues = other.activatedValues;
         unactivatedValues = other.unactivatedValues;
+        activatedBatch = other.activatedBatch;
+        unactivatedBatch = other.unactivatedBatch;
+        batchRows = other.batchRows;
         activation = std::move(other.activation->clone());
 
         return *this;
@@ -29,11 +38,11 @@ namespace bbdnn {
         return activation;
     }
 
-    Vector DenseLayer::getActivatedVector() const {
+    VectorView DenseLayer::getActivatedVector() const {
         return activatedValues;
     }
 
-    Vector DenseLayer::getUnactivatedVector() const {
+    VectorView DenseLayer::getUnactivatedVector() const {
         return unactivatedValues;
     }
 
@@ -45,6 +54,22 @@ namespace bbdnn {
         return unactivatedValues[i];
     }
 
+    const Vector& DenseLayer::getActivatedValues() const {
+        return activatedValues;
+    }
+
+    Vector& DenseLayer::getActivatedValues() {
+        return activatedValues;
+    }
+
+    const Vector& DenseLayer::getUnactivatedValues() const {
+        return unactivatedValues;
+    }
+
+    Vector& DenseLayer::getUnactivatedValues() {
+        return unactivatedValues;
+    }
+
     int DenseLayer::size() const {
         return neuronCount;
     }
@@ -53,7 +78,7 @@ namespace bbdnn {
         activation = std::move(func);
     }
 
-    void DenseLayer::setActivatedValues(const Vector& newVals) {
+    void DenseLayer::setActivatedValues(VectorView newVals) {
         if (newVals.size() != this->neuronCount)
             throw std::invalid_argument("Input vector size must be equal to layer size");
 
@@ -62,7 +87,7 @@ namespace bbdnn {
         }
     }
 
-    void DenseLayer::setUnactivatedValues(const Vector& newVals) {
+    void DenseLayer::setUnactivatedValues(VectorView newVals) {
         if (newVals.size() != this->neuronCount)
             throw std::invalid_argument("Input vector size must be equal to layer size");
 
@@ -71,4 +96,45 @@ namespace bbdnn {
         }
     }
 
+    void DenseLayer::resizeBatch(int batchSize) {
+        if (batchSize <= 0)
+            throw std::invalid_argument("Batch size must be positive");
+
+        batchRows = batchSize;
+
+        if (activatedBatch.Rows() >= batchSize)
+            return;
+
+        activatedBatch = Matrix(batchSize, neuronCount);
+        unactivatedBatch = Matrix(batchSize, neuronCount);
+    }
+
+    int DenseLayer::batchSize() const {
+        return batchRows;
+    }
+
+    const Matrix& DenseLayer::getActivatedBatch() const {
+        return activatedBatch;
+    }
+
+    Matrix& DenseLayer::getActivatedBatch() {
+        return activatedBatch;
+    }
+
+    const Matrix& DenseLayer::getUnactivatedBatch() const {
+        return unactivatedBatch;
+    }
+
+    Matrix& DenseLayer::getUnactivatedBatch() {
+        return unactivatedBatch;
+    }
+
+    void DenseLayer::setActivatedBatch(const Matrix& newVals) {
+        if (newVals.Cols() != this->neuronCount)
+            throw std::invalid_argument("Input batch column count must be equal to layer size");
+
+        resizeBatch(newVals.Rows());
+        std::copy(newVals.rawData(), newVals.rawData() + newVals.size(), activatedBatch.rawData());
+    }
+
 }
@@ -0,0 +1,297 @@
+#include "bbdnn/Gemm.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace bbdnn::kernels {
+
+    namespace {
+
+        // Below this many multiply-adds packing costs more than it saves
+        constexpr long SMALL_GEMM_FLOPS = 32 * 32 * 32;
+
+        // Per-thread packing and scratch buffers, grown once and then reused
+        thread_local std::vector<float> packedA;
+        thread_local std::vector<float> packedB;
+        thread_local std::vector<float> scratch;
+
+        float* growBuffer(std::vector<float>& buffer, size_t count) {
+            if (buffer.size() < count)
+                buffer.resize(count);
+
+            return buffer.data();
+        }
+
+        // C = beta * C, treating beta == 0 as an overwrite so C is never read
+        void scaleC(int M, int N, float beta, float* C, int ldc) {
+            if (beta == 1.0f)
+                return;
+
+            for (int i = 0; i < M; i++) {
+                float* row = C + (long)i * ldc;
+
+                if (beta == 0.0f)
+                    for (int j = 0; j < N; j++)
+                        row[j] = 0.0f;
+                else
+                    for (int j = 0; j < N; j++)
+                        row[j] *= beta;
+            }
+        }
+
+        // K == 1: C = alpha * a * b^T + beta * C
+        void gemmOuter(int M, int N, float alpha, const float* A, int rsA, const float* B, int csB,
+                       float beta, float* C, int ldc) {
+            const float* b = B;
+            if (csB != 1) {
+                float* packed = growBuffer(scratch, N);
+                for (int j = 0; j < N; j++)
+                    packed[j] = B[(long)j * csB];
+                b = packed;
+            }
+
+            for (int i = 0; i < M; i++) {
+                float a = alpha * A[(long)i * rsA];
+                float* row = C + (long)i * ldc;
+
+                if (beta == 0.0f)
+                    for (int j = 0; j < N; j++)
+                        row[j] = a * b[j];
+                else if (beta == 1.0f)
+                    for (int j = 0; j < N; j++)
+                        row[j] += a * b[j];
+                else
+                    for (int j = 0; j < N; j++)
+                        row[j] = beta * row[j] + a * b[j];
+            }
+        }
+
+        float dot(int K, const float* a, const float* b, int incB) {
+            float acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+            int k = 0;
+
+            if (incB == 1) {
+                for (; k + 4 <= K; k += 4) {
+                    acc0 += a[k] * b[k];
+                    acc1 += a[k + 1] * b[k + 1];
+                    acc2 += a[k + 2] * b[k + 2];
+                    acc3 += a[k + 3] * b[k + 3];
+                }
+            }
+
+            for (; k < K; k++)
+                acc0 += a[k] * b[(long)k * incB];
+
+            return (acc0 + acc1) + (acc2 + acc3);
+        }
+
+        // y = alpha * op * x + beta * y where op is an M x K strided matrix and y has stride incY
+        void gemv(int M, int K, float alpha, const float* A, int rsA, int csA, const float* x, int incX,
+                  float beta, float* y, int incY) {
+            if (csA == 1) {
+                // Rows are contiguous: one dot product per output
+                for (int i = 0; i < M; i++) {
+                    float value = alpha * dot(K, A + (long)i * rsA, x, incX);
+                    float& out = y[(long)i * incY];
+                    out = beta == 0.0f ? value : beta * out + value;
+                }
+                return;
+            }
+
+            // Columns are contiguous (or neither is): accumulate one AXPY per input
+            float* acc = growBuffer(scratch, M);
+            for (int i = 0; i < M; i++)
+                acc[i] = 0.0f;
+
+            for (int k = 0; k < K; k++) {
+                float xk = x[(long)k * incX];
+                const float* col = A + (long)k * csA;
+
+                if (rsA == 1)
+                    for (int i = 0; i < M; i++)
+                        acc[i] += xk * col[i];
+                else
+                    for (int i = 0; i < M; i++)
+                        acc[i] += xk * col[(long)i * rsA];
+            }
+
+            for (int i = 0; i < M; i++) {
+                float& out = y[(long)i * incY];
+                out = beta == 0.0f ? alpha * acc[i] : beta * out + alpha * acc[i];
+            }
+        }
+
+        // Unpacked loop for tiny products, ordered so the innermost walk over B and C is contiguous
+        void gemmSmall(int M, int N, int K, float alpha, const float* A, int rsA, int csA,
+                       const float* B, int rsB, int csB, float beta, float* C, int ldc) {
+            scaleC(M, N, beta, C, ldc);
+
+            for (int i = 0; i < M; i++) {
+                float* row = C + (long)i * ldc;
+
+                for (int k = 0; k < K; k++) {
+                    float a = alpha * A[(long)i * rsA + (long)k * csA];
+                    const float* bRow = B + (long)k * rsB;
+
+                    if (csB == 1)
+                        for (int j = 0; j < N; j++)
+                            row[j] += a * bRow[j];
+                    else
+                        for (int j = 0; j < N; j++)
+                            row[j] += a * bRow[(long)j * csB];
+                }
+            }
+        }
+
+        // Pack an mc x kc block of A into MR-row panels, zero-padding the ragged last panel
+        void packBlockA(int mc, int kc, const float* A, int rsA, int csA, float* out) {
+            for (int p = 0; p < mc; p += GEMM_MR) {
+                int mr = mc - p < GEMM_MR ? mc - p : GEMM_MR;
+
+                for (int k = 0; k < kc; k++) {
+                    for (int r = 0; r < mr; r++)
+                        out[r] = A[(long)(p + r) * rsA + (long)k * csA];
+                    for (int r = mr; r < GEMM_MR; r++)
+                        out[r] = 0.0f;
+
+                    out += GEMM_MR;
+                }
+            }
+        }
+
+        // Pack a kc x nc block of B into NR-column panels, zero-padding the ragged last panel
+        void packBlockB(int kc, int nc, const float* B, int rsB, int csB, float* out) {
+            for (int q = 0; q < nc; q += GEMM_NR) {
+                int nr = nc - q < GEMM_NR ? nc - q : GEMM_NR;
+
+                for (int k = 0; k < kc; k++) {
+                    const float* bRow = B + (long)k * rsB + (long)q * csB;
+
+                    if (csB == 1 && nr == GEMM_NR)
+                        for (int c = 0; c < GEMM_NR; c++)
+                            out[c] = bRow[c];
+                    else {
+                        for (int c = 0; c < nr; c++)
+                            out[c] = bRow[(long)c * csB];
+                        for (int c = nr; c < GEMM_NR; c++)
+                            out[c] = 0.0f;
+                    }
+
+                    out += GEMM_NR;
+                }
+            }
+        }
+
+        // MR x NR register tile: accumulates kc rank-1 updates from packed panels, then writes the valid mr x nr corner
+        void microKernel(int kc, const float* pa, const float* pb, float alpha, float beta,
+                         float* C, int ldc, int mr, int nr) {
+            float acc[GEMM_MR][GEMM_NR] = {};
+
+            for (int k = 0; k < kc; k++) {
+                for (int r = 0; r < GEMM_MR; r++) {
+                    float a = pa[r];
+                    for (int c = 0; c < GEMM_NR; c++)
+                        acc[r][c] += a * pb[c];
+                }
+
+                pa += GEMM_MR;
+                pb += GEMM_NR;
+            }
+
+            for (int r = 0; r < mr; r++) {
+                float* row = C + (long)r * ldc;
+
+                if (beta == 0.0f)
+                    for (int c = 0; c < nr; c++)
+                        row[c] = alpha * acc[r][c];
+                else if (beta == 1.0f)
+                    for (int c = 0; c < nr; c++)
+                        row[c] += alpha * acc[r][c];
+                else
+                    for (int c = 0; c < nr; c++)
+                        row[c] = beta * row[c] + alpha * acc[r][c];
+            }
+        }
+
+        // Goto-style blocking: NC columns of B stay in L3, a KC x NC packed slab streams through L2,
+        // MC x KC blocks of A sit in L2 and each micro-kernel call keeps a KC x NR sliver of B in L1
+        void gemmBlocked(int M, int N, int K, float alpha, const float* A, int rsA, int csA,
+                         const float* B, int rsB, int csB, float beta, float* C, int ldc) {
+            int kcMax = K < GEMM_KC ? K : GEMM_KC;
+            int ncMax = N < GEMM_NC ? N : GEMM_NC;
+            int mcMax = M < GEMM_MC ? M : GEMM_MC;
+
+            float* pa = growBuffer(packedA, (size_t)(mcMax + GEMM_MR) * kcMax);
+            float* pb = growBuffer(packedB, (size_t)(ncMax + GEMM_NR) * kcMax);
+
+            for (int jc = 0; jc < N; jc += GEMM_NC) {
+                int nc = N - jc < GEMM_NC ? N - jc : GEMM_NC;
+
+                for (int pc = 0; pc < K; pc += GEMM_KC) {
+                    int kc = K - pc < GEMM_KC ? K - pc : GEMM_KC;
+                    // Only the first slice of K applies beta; later slices accumulate
+                    float blockBeta = pc == 0 ? beta : 1.0f;
+
+                    packBlockB(kc, nc, B + (long)pc * rsB + (long)jc * csB, rsB, csB, pb);
+
+                    for (int ic = 0; ic < M; ic += GEMM_MC) {
+                        int mc = M - ic < GEMM_MC ? M - ic : GEMM_MC;
+
+                        packBlockA(mc, kc, A + (long)ic * rsA + (long)pc * csA, rsA, csA, pa);
+
+                        for (int jr = 0; jr < nc; jr += GEMM_NR) {
+                            int nr = nc - jr < GEMM_NR ? nc - jr : GEMM_NR;
+                            const float* panelB = pb + (long)jr * kc;
+
+                            for (int ir = 0; ir < mc; ir += GEMM_MR) {
+                                int mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+                                float* tile = C + (long)(ic + ir) * ldc + jc + jr;
+
+                                microKernel(kc, pa + (long)ir * kc, panelB, alpha, blockBeta, tile, ldc, mr, nr);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    }
+
+    void gemm(int M, int N, int K, float alpha,
+              const float* A, int rsA, int csA,
+              const float* B, int rsB, int csB,
+              float beta, float* C, int ldc) {
+        if (M <= 0 || N <= 0)
+            return;
+
+        if (K <= 0 || alpha == 0.0f) {
+            scaleC(M, N, beta, C, ldc);
+            return;
+        }
+
+        // Outer product, e.g. the rank-1 weight gradient a * delta^T
+        if (K == 1) {
+            gemmOuter(M, N, alpha, A, rsA, B, csB, beta, C, ldc);
+            return;
+        }
+
+        // Matrix-vector: C is a single column
+        if (N == 1) {
+            gemv(M, K, alpha, A, rsA, csA, B, rsB, beta, C, ldc);
+            return;
+        }
+
+        // Vector-matrix: C is a single row, computed as B^T * a
+        if (M == 1) {
+            gemv(N, K, alpha, B, csB, rsB, A, csA, beta, C, 1);
+            return;
+        }
+
+        if ((long)M * N * K <= SMALL_GEMM_FLOPS) {
+            gemmSmall(M, N, K, alpha, A, rsA, csA, B, rsB, csB, beta, C, ldc);
+            return;
+        }
+
+        gemmBlocked(M, N, K, alpha, A, rsA, csA, B, rsB, csB, beta, C, ldc);
+    }
+
+}
@@ -0,0 +1,68 @@
+#include "bbdnn/GradientWorkspace.hpp"
+#include "bbdnn/Simd.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    GradientWorkspace::GradientWorkspace(const std::vector<DenseLayer>& layers) {
+        size_t layerCount = layers.size();
+
+        weights.reserve(layerCount - 1);
+        biases.reserve(layerCount - 1);
+        sensitivities.reserve(layerCount);
+        derivatives.reserve(layerCount);
+
+        for (size_t l = 0; l < layerCount; l++) {
+            int neurons = layers[l].size();
+
+            sensitivities.emplace_back(neurons, 0.0f);
+            derivatives.emplace_back(neurons, 0.0f);
+
+            if (l + 1 < layerCount) {
+                weights.emplace_back(neurons, layers[l + 1].size(), 0.0f);
+                biases.emplace_back(layers[l + 1].size(), 0.0f);
+            }
+        }
+    }
+
+    void GradientWorkspace::resizeBatch(int batchSize) {
+        if (batchSize <= 0)
+            throw std::invalid_argument("Batch size must be positive");
+
+        if (!batchSensitivities.empty() && batchSensitivities.front().Rows() >= batchSize)
+            return;
+
+        batchSensitivities.clear();
+        batchDerivatives.clear();
+
+        for (const Vector& layer : sensitivities) {
+            batchSensitivities.emplace_back(batchSize, layer.size());
+            batchDerivatives.emplace_back(batchSize, layer.size());
+        }
+    }
+
+    void GradientWorkspace::zero() {
+        for (Matrix& gradient : weights)
+            std::fill(gradient.rawData(), gradient.rawData() + gradient.size(), 0.0f);
+
+        for (Vector& gradient : biases)
+            std::fill(gradient.rawData(), gradient.rawData() + gradient.size(), 0.0f);
+    }
+
+    void GradientWorkspace::accumulate(const GradientWorkspace& other) {
+        if (other.weights.size() != weights.size() || other.biases.size() != biases.size())
+            throw std::invalid_argument("Gradient workspaces must belong to the same topology.");
+
+        const kernels::KernelTable& k = kernels::kernelTable();
+
+        for (size_t l = 0; l < weights.size(); l++) {
+            if (other.weights[l].size() != weights[l].size() || other.biases[l].size() != biases[l].size())
+                throw std::invalid_argument("Gradient workspaces must belong to the same topology.");
+
+            k.add(weights[l].rawData(), other.weights[l].rawData(), weights[l].rawData(), weights[l].size());
+            k.add(biases[l].rawData(), other.biases[l].rawData(), biases[l].rawData(), biases[l].size());
+        }
+    }
+
+}
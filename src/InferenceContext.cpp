@@ -0,0 +1,36 @@
+#include "bbdnn/InferenceContext.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    InferenceContext::InferenceContext(const std::vector<DenseLayer>& layers) {
+        activated.reserve(layers.size());
+        unactivated.reserve(layers.size());
+
+        for (const DenseLayer& layer : layers) {
+            activated.emplace_back(layer.size(), 0.0f);
+            unactivated.emplace_back(layer.size(), 0.0f);
+        }
+    }
+
+    void InferenceContext::setInput(VectorView input) {
+        Vector& values = activated.front();
+
+        if (input.size() != values.size())
+            throw std::invalid_argument("Input vector size must be equal to layer size");
+
+        if (input.isContiguous()) {
+            std::copy(input.rawData(), input.rawData() + input.size(), values.rawData());
+            return;
+        }
+
+        for (int i = 0; i < input.size(); i++)
+            values.rawData()[i] = input[i];
+    }
+
+    const Vector& InferenceContext::output() const {
+        return activated.back();
+    }
+
+}
@@ -1,7 +1,32 @@
 #include "bbdnn/LayerConnection.hpp"
+#include "bbdnn/Gemm.hpp"
+#include "bbdnn/Profiler.hpp"
+#include "bbdnn/Simd.hpp"
+#include <algorithm>
+#include <stdexcept>
 
 namespace bbdnn {
 
+    namespace {
+        // Widened weight panels for batched 16-bit forward passes, grown once per thread and reused
+        thread_local std::vector<float> widenedPanel;
+
+        // Whether weights of this density take the sparse path: a crossover of 0 never does and 1 always does
+        bool belowCrossover(float density, float crossover) {
+            return crossover >= 1.0f || density < crossover;
+        }
+
+        // ColumnMajor rows are padded to a multiple of this many floats (64 bytes)
+        constexpr size_t LAYOUT_PAD_FLOATS = 16;
+
+#ifdef BBDNN_ENABLE_PROFILING
+        // Weight bytes read per forward pass, for the profiler's byte counts
+        long bytesPerWeight(WeightPrecision precision) {
+            return precision == WeightPrecision::Float32 ? sizeof(float) : sizeof(uint16_t);
+        }
+#endif
+    }
+
     LayerConnection::LayerConnection(DenseLayer& InLayer, DenseLayer& OutLayer, bool autoInitializeWeights, 
         uint_fast32_t randomSeed) : inLayer(InLayer), outLayer(OutLayer), biases(outLayer.size(), 0.0f) {
         // Create based on activation function
@@ -14,14 +39,30 @@ namespace bbdnn {
     LayerConnection::LayerConnection(DenseLayer& InLayer, DenseLayer& OutLayer, Matrix& Weights, float Biases[]) : inLayer(InLayer), outLayer(OutLayer), weights(Weights), biases(Biases, outLayer.size()) {
     }
 
-    LayerConnection::LayerConnection(const LayerConnection& other) : inLayer(other.inLayer), outLayer(other.outLayer), weights(other.weights), biases(other.biases) {
+    LayerConnection::LayerConnection(const LayerConnection& other) : inLayer(other.inLayer), outLayer(other.outLayer), weights(other.weights), biases(other.biases),
+        weightState(other.weightState), biasState(other.biasState), precision(other.precision), compactWeights(other.compactWeights),
+        masterReleased(other.masterReleased), sparseWeights(other.sparseWeights), sparseSingle(other.sparseSingle), sparseBatched(other.sparseBatched),
+        layout(other.layout), layoutWeights(other.layoutWeights), layoutStride(other.layoutStride) {
     }
 
+    LayerConnection::LayerConnection(LayerConnection&& other) noexcept = default;
+
     LayerConnection& LayerConnection::operator=(const LayerConnection& other) {
         inLayer = other.inLayer;
         outLayer = other.outLayer;
         weights = other.weights;
         biases = other.biases;
+        weightState = other.weightState;
+        biasState = other.biasState;
+        precision = other.precision;
+        compactWeights = other.compactWeights;
+        masterReleased = other.masterReleased;
+        sparseWeights = other.sparseWeights;
+        sparseSingle = other.sparseSingle;
+        sparseBatched = other.sparseBatched;
+        layout = other.layout;
+        layoutWeights = other.layoutWeights;
+        layoutStride = other.layoutStride;
 
         return *this;
     }
@@ -29,17 +70,31 @@ namespace bbdnn {
     LayerConnection::~LayerConnection() {}
 
     const Matrix& LayerConnection::getWeights() const {
+        requireMasterWeights();
         return weights;
     }
 
     void LayerConnection::setWeights(const Matrix& newMatrix) {
-        if (newMatrix.Rows() != weights.Rows() || newMatrix.Cols() != weights.Cols())
+        if (newMatrix.Rows() != inLayer.size() || newMatrix.Cols() != outLayer.size())
             throw std::invalid_argument("The given Matrix's dimensions do not the specifications for the layer connection.");
 
         weights = newMatrix;
+        masterReleased = false;
+        updateForwardWeights();
+        clearSparseWeights();
     }
 
-    Vector LayerConnection::getBiases() const {
+    void LayerConnection::setWeights(Matrix&& newMatrix) {
+        if (newMatrix.Rows() != inLayer.size() || newMatrix.Cols() != outLayer.size())
+            throw std::invalid_argument("The given Matrix's dimensions do not the specifications for the layer connection.");
+
+        weights = std::move(newMatrix);
+        masterReleased = false;
+        updateForwardWeights();
+        clearSparseWeights();
+    }
+
+    VectorView LayerConnection::getBiases() const {
         return biases;
     }
 
@@ -58,6 +113,13 @@ namespace bbdnn {
         biases = newBiases;
     }
 
+    void LayerConnection::setBiases(Vector&& newBiases) {
+        if (newBiases.size() != outLayer.size())
+            throw std::invalid_argument("The given biases array is not the appropriate size for the layer connection.");
+
+        biases = std::move(newBiases);
+    }
+
     void LayerConnection::initializeWeights(const uint_fast32_t& randomSeed) {
         // Use Kaiming initialization for ReLU and LeakyReLU
         const auto& activationFunc = outLayer.getActivationFunction();
@@ -75,6 +137,11 @@ namespace bbdnn {
     }
 
     float LayerConnection::weightAt(int j, int i) const {
+        if (masterReleased) {
+            uint16_t value = compactWeights[(long)i * outLayer.size() + j];
+            return precision == WeightPrecision::BFloat16 ? bfloat16ToFloat(value) : halfToFloat(value);
+        }
+
         return weights.at(i,j);
     }
 
@@ -83,33 +150,357 @@ namespace bbdnn {
     }
 
     void LayerConnection::forwardPropogate() {
+        forwardPropogate(inLayer.getActivatedValues(), outLayer.getUnactivatedValues(), outLayer.getActivatedValues());
+    }
+
+    void LayerConnection::forwardPropogate(const Vector& inputs, Vector& unactivated, Vector& activated, bool storeUnactivated) const {
+        int inSize = inLayer.size();
+        int outSize = outLayer.size();
+
+        if (inputs.size() != inSize || (storeUnactivated && unactivated.size() != outSize) || activated.size() != outSize)
+            throw std::invalid_argument("Value vectors must match the sizes of the connected layers.");
+
+        const IActivation& activation = *outLayer.getActivationFunction();
+
+        // Packed panels with a built-in activation: one pass that adds the bias and activates in registers
+        if (!sparseSingle && precision == WeightPrecision::Float32 && layout == WeightLayout::PackedPanels &&
+            activation.kind() != ActivationKind::Custom) {
+            BBDNN_PROFILE_SCOPE(profiling::Phase::Forward, 2L * inSize * outSize + outSize,
+                                (long)layoutWeights.size() * sizeof(float) + (inSize + (storeUnactivated ? 3L : 2L) * outSize) * sizeof(float));
+
+            std::array<float, 2> parameters = activation.kernelParameters();
+            kernels::kernelTable().denseForward(activation.kind(), parameters[0], parameters[1], inputs.rawData(), layoutWeights.data(),
+                                                biases.rawData(), storeUnactivated ? unactivated.rawData() : nullptr,
+                                                activated.rawData(), inSize, outSize);
+            return;
+        }
+
+        // Calculate Z = W.P + b ; where P is outut of prev. layer, or A^(l-1). When Z is not kept it is
+        // accumulated in activated and activated in place
+        float* z = storeUnactivated ? unactivated.rawData() : activated.rawData();
+
+        {
+            BBDNN_PROFILE_SCOPE(profiling::Phase::Forward, 2L * inSize * outSize,
+                                (long)inSize * outSize * bytesPerWeight(precision) + (inSize + 3L * outSize) * sizeof(float));
+
+            std::copy(biases.rawData(), biases.rawData() + outSize, z);
+
+            if (sparseSingle)
+                sparseWeights.multiplyAdd(inputs.rawData(), z);
+            else if (precision != WeightPrecision::Float32)
+                kernels::kernelTable().gemvWiden(precision, inputs.rawData(), compactWeights.data(), z, inSize, outSize);
+            else if (layout == WeightLayout::ColumnMajor)
+                kernels::kernelTable().gemvRows(inputs.rawData(), layoutWeights.data(), layoutStride, z, outSize, inSize);
+            else if (layout == WeightLayout::PackedPanels)
+                kernels::kernelTable().gemvPanels(inputs.rawData(), layoutWeights.data(), z, inSize, outSize);
+            else
+                kernels::gemm(1, outSize, inSize, 1.0f,
+                              inputs.rawData(), inSize, 1,
+                              weights.rawData(), outSize, 1,
+                              1.0f, z, outSize);
+        }
+
+        // Get A = σ(Z) for the whole layer in one call
+        BBDNN_PROFILE_SCOPE(profiling::Phase::Activation, outSize, 2L * outSize * sizeof(float));
+        activation.apply(z, activated.rawData(), outSize);
+    }
+
+    void LayerConnection::forwardPropogateBatch() {
+        forwardPropogateBatch(inLayer.getActivatedBatch().rawData(), inLayer.batchSize());
+    }
+
+    void LayerConnection::forwardPropogateBatch(const float* inputs, int batchSize) {
+        int inSize = inLayer.size();
         int outSize = outLayer.size();
 
-        // Get the dot product of the layers; gets z_i at layer l
-        Vector products = weights.applyMatrix(inLayer.getActivatedVector());
-    
-        Vector activated(outSize);
-        Vector unactivated(outSize);
-    
-        // Calculate value of a_i at layer l
-        for (int i = 0; i < outSize; i++)
+        outLayer.resizeBatch(batchSize);
+        Matrix& unactivated = outLayer.getUnactivatedBatch();
+        Matrix& activated = outLayer.getActivatedBatch();
+
+        // Broadcast the biases into every row, then Z += X . W for the whole batch in one GEMM
+        float* z = unactivated.rawData();
+
         {
-            // Calculate Z = W.P + b ; where P is outut of prev. layer, or A^(l-1)
-            double nueronVal = products[i] + biases[i];
+            BBDNN_PROFILE_SCOPE(profiling::Phase::Forward, 2L * batchSize * outSize * inSize,
+                                (long)inSize * outSize * bytesPerWeight(precision) + (long)batchSize * (inSize + 3L * outSize) * sizeof(float));
+
+            const float* b = biases.rawData();
+            for (int r = 0; r < batchSize; r++)
+                std::copy(b, b + outSize, z + (long)r * outSize);
+
+            if (batchSize == 1 ? sparseSingle : sparseBatched) {
+                sparseWeights.multiplyAdd(inputs, inSize, z, outSize, batchSize);
+            }
+            else if (precision == WeightPrecision::Float32) {
+                kernels::gemm(batchSize, outSize, inSize, 1.0f,
+                              inputs, inSize, 1,
+                              weights.rawData(), outSize, 1,
+                              1.0f, z, outSize);
+            }
+            else if (batchSize == 1) {
+                kernels::kernelTable().gemvWiden(precision, inputs, compactWeights.data(), z, inSize, outSize);
+            }
+            else {
+                // Widen one GEMM depth block of weight rows at a time and run the fp32 GEMM on it, so the
+                // 16-bit weights are read once per batch and the GEMM packs the panel while it is still in cache
+                const kernels::KernelTable& k = kernels::kernelTable();
+                int panelRows = std::min(kernels::GEMM_KC, inSize);
+
+                if (widenedPanel.size() < static_cast<size_t>(panelRows) * outSize)
+                    widenedPanel.resize(static_cast<size_t>(panelRows) * outSize);
+
+                for (int first = 0; first < inSize; first += panelRows) {
+                    int rows = std::min(panelRows, inSize - first);
+                    k.widen(precision, compactWeights.data() + (long)first * outSize, widenedPanel.data(), static_cast<size_t>(rows) * outSize);
+
+                    kernels::gemm(batchSize, outSize, rows, 1.0f,
+                                  inputs + first, inSize, 1,
+                                  widenedPanel.data(), outSize, 1,
+                                  1.0f, z, outSize);
+                }
+            }
+        }
+
+        // Get A = σ(Z)
+        BBDNN_PROFILE_SCOPE(profiling::Phase::Activation, (long)batchSize * outSize, 2L * batchSize * outSize * sizeof(float));
+        outLayer.getActivationFunction()->apply(z, activated.rawData(), static_cast<size_t>(batchSize) * outSize);
+    }
+
+    int LayerConnection::parameterCount() const {
+        return inLayer.size() * outLayer.size() + biases.size();
+    }
+
+    void LayerConnection::narrowWeights() {
+        if (precision == WeightPrecision::Float32) {
+            std::vector<uint16_t>().swap(compactWeights);
+            return;
+        }
+
+        compactWeights.resize(weights.size());
+        kernels::kernelTable().narrow(precision, weights.rawData(), compactWeights.data(), compactWeights.size());
+    }
+
+    void LayerConnection::updateSparseWeights() {
+        requireMasterWeights();
+
+        float currentDensity = density();
+
+        sparseSingle = belowCrossover(currentDensity, SparseMatrix::crossoverDensity(1));
+        sparseBatched = belowCrossover(currentDensity, SparseMatrix::crossoverDensity(2));
+
+        sparseWeights = sparseSingle || sparseBatched ? SparseMatrix(weights) : SparseMatrix();
+    }
+
+    void LayerConnection::clearSparseWeights() {
+        sparseWeights = SparseMatrix();
+        sparseSingle = false;
+        sparseBatched = false;
+    }
+
+    float LayerConnection::density() const {
+        long total = (long)inLayer.size() * outLayer.size();
+        if (total == 0)
+            return 0.0f;
+
+        long nonZeros;
+        if (!masterReleased)
+            nonZeros = std::count_if(weights.rawData(), weights.rawData() + total, [](float w) { return w != 0.0f; });
+        else
+            nonZeros = std::count_if(compactWeights.begin(), compactWeights.end(), [](uint16_t w) { return (w & 0x7FFFu) != 0; });
+
+        return static_cast<float>(nonZeros) / static_cast<float>(total);
+    }
 
-            unactivated[i] = nueronVal;
+    bool LayerConnection::isSparse() const {
+        return sparseSingle;
+    }
+
+    void LayerConnection::packWeights() {
+        if (layout == WeightLayout::RowMajor || precision != WeightPrecision::Float32) {
+            layoutWeights = AlignedBuffer();
+            return;
+        }
+
+        int inSize = inLayer.size();
+        int outSize = outLayer.size();
+        const float* w = weights.rawData();
+
+        // Padding is written once when the buffer is allocated and stays zero through repacks
+        if (layout == WeightLayout::ColumnMajor) {
+            layoutStride = (static_cast<size_t>(inSize) + LAYOUT_PAD_FLOATS - 1) / LAYOUT_PAD_FLOATS * LAYOUT_PAD_FLOATS;
+
+            if (layoutWeights.size() != layoutStride * outSize)
+                layoutWeights = AlignedBuffer(layoutStride * outSize);
+
+            float* columns = layoutWeights.data();
+            for (int i = 0; i < inSize; i++)
+                for (int o = 0; o < outSize; o++)
+                    columns[o * layoutStride + i] = w[(long)i * outSize + o];
+        }
+        else {
+            size_t panelWidth = kernels::kernelTable().panelWidth;
+            size_t panelCount = (outSize + panelWidth - 1) / panelWidth;
+            layoutStride = panelWidth;
+
+            if (layoutWeights.size() != panelCount * panelWidth * inSize)
+                layoutWeights = AlignedBuffer(panelCount * panelWidth * inSize);
+
+            float* panels = layoutWeights.data();
+            for (size_t first = 0; first < static_cast<size_t>(outSize); first += panelWidth) {
+                size_t count = std::min(panelWidth, outSize - first);
+                float* panel = panels + first * inSize;
+
+                for (int i = 0; i < inSize; i++)
+                    std::copy(w + (long)i * outSize + first, w + (long)i * outSize + first + count, panel + i * panelWidth);
+            }
+        }
+    }
+
+    void LayerConnection::updateForwardWeights() {
+        narrowWeights();
+        packWeights();
+    }
+
+    void LayerConnection::setWeightLayout(WeightLayout newLayout) {
+        if (newLayout == layout)
+            return;
+
+        layout = newLayout;
+        packWeights();
+    }
+
+    WeightLayout LayerConnection::getWeightLayout() const {
+        return layout;
+    }
+
+    WeightLayout LayerConnection::layoutFor(Workload workload) const {
+        if (workload == Workload::Training)
+            return WeightLayout::RowMajor;
+
+        size_t panelWidth = kernels::kernelTable().panelWidth;
+        size_t outSize = outLayer.size();
+        size_t padded = (outSize + panelWidth - 1) / panelWidth * panelWidth;
+
+        return 4 * padded <= 5 * outSize ? WeightLayout::PackedPanels : WeightLayout::ColumnMajor;
+    }
+
+    void LayerConnection::requireMasterWeights() const {
+        if (masterReleased)
+            throw std::logic_error("The fp32 master weights of this connection were released; it can only run inference.");
+    }
+
+    void LayerConnection::setWeightPrecision(WeightPrecision newPrecision) {
+        if (newPrecision == precision)
+            return;
+
+        // Without a master, the only lossless change is widening back to fp32
+        if (masterReleased) {
+            if (newPrecision != WeightPrecision::Float32)
+                throw std::logic_error("Changing between 16-bit precisions needs the fp32 master weights.");
+
+            weights = widenedWeights();
+            masterReleased = false;
+        }
+
+        precision = newPrecision;
+        updateForwardWeights();
+    }
+
+    WeightPrecision LayerConnection::getWeightPrecision() const {
+        return precision;
+    }
+
+    void LayerConnection::releaseMasterWeights() {
+        if (precision == WeightPrecision::Float32)
+            throw std::logic_error("Only connections with 16-bit weights can release their fp32 master weights.");
+
+        weights = Matrix();
+        masterReleased = true;
+
+        for (int s = 0; s < static_cast<int>(weightState.size()); s++) {
+            weightState[s] = Matrix();
+            biasState[s] = Vector();
+        }
+    }
+
+    bool LayerConnection::hasMasterWeights() const {
+        return !masterReleased;
+    }
+
+    Matrix LayerConnection::widenedWeights() const {
+        if (precision == WeightPrecision::Float32)
+            return weights;
+
+        Matrix widened(inLayer.size(), outLayer.size());
+        kernels::kernelTable().widen(precision, compactWeights.data(), widened.rawData(), compactWeights.size());
+
+        return widened;
+    }
+
+    size_t LayerConnection::weightBytes() const {
+        return static_cast<size_t>(weights.size()) * sizeof(float) + compactWeights.size() * sizeof(uint16_t) + sparseWeights.memoryBytes() +
+               layoutWeights.size() * sizeof(float);
+    }
+
+    void LayerConnection::applyGradients(const Matrix& weightGradient, const Vector& biasGradient, float learningRate) {
+        requireMasterWeights();
+
+        if (weightGradient.Rows() != weights.Rows() || weightGradient.Cols() != weights.Cols())
+            throw std::invalid_argument("The given weight gradient's dimensions do not match the layer connection.");
+
+        if (biasGradient.size() != biases.size())
+            throw std::invalid_argument("The given bias gradient is not the appropriate size for the layer connection.");
+
+        const kernels::KernelTable& k = kernels::kernelTable();
+        k.axpy(-learningRate, weightGradient.rawData(), weights.rawData(), weights.size());
+        k.axpy(-learningRate, biasGradient.rawData(), biases.rawData(), biases.size());
+
+        // Pruned weights stay pruned, and the sparse copy takes the new values of the rest
+        if (!sparseWeights.empty())
+            sparseWeights.applyPattern(weights);
+
+        updateForwardWeights();
+    }
+
+    void LayerConnection::applyGradients(const Matrix& weightGradient, const Vector& biasGradient, const IOptimizer& optimizer, const OptimizerStep& step) {
+        requireMasterWeights();
+
+        if (weightGradient.Rows() != weights.Rows() || weightGradient.Cols() != weights.Cols())
+            throw std::invalid_argument("The given weight gradient's dimensions do not match the layer connection.");
+
+        if (biasGradient.size() != biases.size())
+            throw std::invalid_argument("The given bias gradient is not the appropriate size for the layer connection.");
+
+        int stateCount = optimizer.stateCount();
+        if (stateCount > 0 && weightState[stateCount - 1].size() != weights.size())
+            throw std::invalid_argument("Optimizer state has not been sized for this optimizer.");
+
+        optimizer.update(step, weights.rawData(), weightGradient.rawData(),
+                         stateCount > 0 ? weightState[0].rawData() : nullptr,
+                         stateCount > 1 ? weightState[1].rawData() : nullptr, weights.size());
+
+        optimizer.update(step, biases.rawData(), biasGradient.rawData(),
+                         stateCount > 0 ? biasState[0].rawData() : nullptr,
+                         stateCount > 1 ? biasState[1].rawData() : nullptr, biases.size());
+
+        // Pruned weights stay pruned, and the sparse copy takes the new values of the rest
+        if (!sparseWeights.empty())
+            sparseWeights.applyPattern(weights);
+
+        updateForwardWeights();
+    }
 
-            // Get A = σ(Z)
-            nueronVal = (*outLayer.getActivationFunction())(nueronVal);
+    void LayerConnection::resetOptimizerState(int stateCount) {
+        if (stateCount < 0 || stateCount > static_cast<int>(weightState.size()))
+            throw std::invalid_argument("Optimizers may keep at most 2 state buffers per parameter.");
 
-            activated[i] = nueronVal;
+        for (int s = 0; s < static_cast<int>(weightState.size()); s++) {
+            weightState[s] = s < stateCount && !masterReleased ? Matrix(inLayer.size(), outLayer.size(), 0.0f) : Matrix();
+            biasState[s] = s < stateCount ? Vector(biases.size(), 0.0f) : Vector();
         }
-    
-        outLayer.setActivatedValues(activated);
-        outLayer.setUnactivatedValues(unactivated);
     }
 
-    Vector LayerConnection::getOutput() const {
+    VectorView LayerConnection::getOutput() const {
         return outLayer.getActivatedVector();
     }
 
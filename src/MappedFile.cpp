@@ -0,0 +1,60 @@
+#include "MappedFile.hpp"
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BBDNN_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bbdnn::io {
+
+    MappedFile mapFile(const std::string& path) {
+        MappedFile file;
+
+#ifdef BBDNN_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Could not open file: " + path);
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not stat file or file is empty: " + path);
+        }
+
+        size_t size = static_cast<size_t>(info.st_size);
+        void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (address == MAP_FAILED)
+            throw std::runtime_error("Could not map file: " + path);
+
+        file.data = std::shared_ptr<void>(address, [size](void* p) { ::munmap(p, size); });
+        file.size = size;
+#else
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream)
+            throw std::runtime_error("Could not open file: " + path);
+
+        size_t size = static_cast<size_t>(stream.tellg());
+        if (size == 0)
+            throw std::runtime_error("Could not stat file or file is empty: " + path);
+
+        void* buffer = ::operator new(size, std::align_val_t(64));
+        file.data = std::shared_ptr<void>(buffer, [](void* p) { ::operator delete(p, std::align_val_t(64)); });
+        file.size = size;
+
+        stream.seekg(0);
+        if (!stream.read(static_cast<char*>(buffer), size))
+            throw std::runtime_error("Could not read file: " + path);
+#endif
+
+        return file;
+    }
+
+}
@@ -0,0 +1,27 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+// Private, writable mapping of a whole file shared by the model and dataset loaders. Platforms
+// without mmap read the file into a 64-byte-aligned buffer instead, so callers see the same thing.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace bbdnn::io {
+
+    /// A mapped file; the mapping lives as long as any copy of data does.
+    struct MappedFile {
+        /// Start of the mapping, 64-byte aligned.
+        std::shared_ptr<void> data;
+        /// File size in bytes.
+        size_t size = 0;
+    };
+
+    /// Map a whole file with MAP_PRIVATE: reads share the page cache and writes copy the touched
+    /// pages without reaching the file. Throws if the file cannot be opened or is empty.
+    MappedFile mapFile(const std::string& path);
+
+}
+
+#endif
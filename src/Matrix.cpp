@@ -1,4 +1,9 @@
 #include "bbdnn/Matrix.hpp"
+#include "bbdnn/Allocator.hpp"
+#include "bbdnn/Gemm.hpp"
+#include "bbdnn/Profiler.hpp"
+#include "bbdnn/Simd.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 namespace bbdnn {
@@ -6,23 +11,48 @@ namespace bbdnn {
     Matrix::Matrix() : rows(0), cols(0), elementCount(0), data(nullptr) { }
 
     Matrix::Matrix(int Rows, int Cols) : rows(Rows), cols(Cols), elementCount(Rows * Cols) {
-        data = new float[elementCount];
+        allocateMatrixData(elementCount);
     }
 
     Matrix::Matrix(int Rows, int Cols, float defaultVal) : rows(Rows), cols(Cols), elementCount(Rows * Cols) {
-        data = new float[elementCount];
+        allocateMatrixData(elementCount);
 
         for (int i = 0; i < elementCount; i++)
             data[i] = defaultVal;
     }
 
-    Matrix::Matrix(int Rows, int Cols, float Data[]) : rows(Rows), cols(Cols), elementCount(Rows * Cols), data(Data) { }
+    Matrix::Matrix(int Rows, int Cols, const float Data[]) : rows(Rows), cols(Cols), elementCount(Rows * Cols) {
+        allocateMatrixData(elementCount);
+
+        std::copy(Data, Data + elementCount, data);
+    }
 
     Matrix::Matrix(const Matrix& other) : rows(other.rows), cols(other.cols), elementCount(other.elementCount) {
-        data = new float[elementCount];
+        allocateMatrixData(elementCount);
 
-        for (int i = 0; i < elementCount; i++)
-            data[i] = other.data[i];
+        std::copy(other.data, other.data + elementCount, data);
+    }
+
+    Matrix::Matrix(const MatrixView& view) : rows(view.Rows()), cols(view.Cols()), elementCount(view.size()) {
+        allocateMatrixData(elementCount);
+
+        if (view.isContiguous()) {
+            std::copy(view.rawData(), view.rawData() + elementCount, data);
+            return;
+        }
+
+        for (int i = 0; i < rows; i++)
+            for (int j = 0; j < cols; j++)
+                data[i * cols + j] = view(i, j);
+    }
+
+    Matrix::Matrix(Matrix&& other) noexcept : rows(other.rows), cols(other.cols), elementCount(other.elementCount), data(other.data), ownsData(other.ownsData), allocator(other.allocator) {
+        other.rows = 0;
+        other.cols = 0;
+        other.elementCount = 0;
+        other.data = nullptr;
+        other.ownsData = true;
+        other.allocator = nullptr;
     }
 
     Matrix::~Matrix() {
@@ -32,25 +62,62 @@ namespace bbdnn {
         destroyMatrixData();
     }
 
+    // Every owned Matrix buffer comes from here, so profiling builds can count them
+    void Matrix::allocateMatrixData(int count) {
+        BBDNN_PROFILE_ALLOCATION();
+
+        allocator = &currentAllocator();
+        data = allocator->allocate(static_cast<size_t>(count));
+        ownsData = true;
+    }
+
     void Matrix::destroyMatrixData() {
-        delete[] data;
+        if (ownsData && allocator != nullptr)
+            allocator->deallocate(data, static_cast<size_t>(elementCount));
+
         data = nullptr;
+        ownsData = true;
+        allocator = nullptr;
     }
 
     Matrix& Matrix::operator=(const Matrix& other) {
         if (this == &other)
             return *this;
-    
-        destroyMatrixData();
+
+        // Same element count: overwrite in place instead of reallocating
+        if (elementCount != other.elementCount || data == nullptr) {
+            destroyMatrixData();
+            allocateMatrixData(other.elementCount);
+        }
 
         rows = other.rows;
         cols = other.cols;
         elementCount = other.elementCount;
 
-        data = new float[elementCount];
+        std::copy(other.data, other.data + elementCount, data);
 
-        for (int i = 0; i < elementCount; i++)
-            data[i] = other.data[i];
+        return *this;
+    }
+
+    Matrix& Matrix::operator=(Matrix&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        destroyMatrixData();
+
+        rows = other.rows;
+        cols = other.cols;
+        elementCount = other.elementCount;
+        data = other.data;
+        ownsData = other.ownsData;
+        allocator = other.allocator;
+
+        other.rows = 0;
+        other.cols = 0;
+        other.elementCount = 0;
+        other.data = nullptr;
+        other.ownsData = true;
+        other.allocator = nullptr;
 
         return *this;
     }
@@ -59,12 +126,13 @@ namespace bbdnn {
         if (cols != other.rows)
             throw std::invalid_argument("Matrix column does not match other's row.");
 
-        Matrix product(rows, other.cols, 0.0f);
-    
-        for (int r = 0; r < rows; r++)
-            for (int c = 0; c < other.cols; c++)
-                for (int i = 0; i < cols; i++)
-                    product.at(r,c) += this->at(r, i) * other.at(i, c);
+        Matrix product(rows, other.cols);
+
+        // beta = 0 overwrites the uninitialized product without reading it
+        kernels::gemm(rows, other.cols, cols, 1.0f,
+                      data, cols, 1,
+                      other.data, other.cols, 1,
+                      0.0f, product.data, product.cols);
 
         return product;
     }
@@ -72,8 +140,7 @@ namespace bbdnn {
     Matrix Matrix::operator*(float scalar) const {
         Matrix product(rows, cols);
     
-        for (int i = 0; i < elementCount; i++)
-            product.data[i] = data[i] * scalar;
+        kernels::kernelTable().scale(data, scalar, product.data, elementCount);
 
         return product;
     }
@@ -84,9 +151,8 @@ namespace bbdnn {
 
         Matrix result(rows, cols);
     
-        for (int i = 0; i < elementCount; i++)
-            result.data[i] = data[i] + other.data[i];
-        
+        kernels::kernelTable().add(data, other.data, result.data, elementCount);
+
         return result;
     }
 
@@ -96,18 +162,15 @@ namespace bbdnn {
 
         Matrix result(rows, cols);
     
-        for (int i = 0; i < elementCount; i++) {
-            result.data[i] = data[i] - other.data[i];
-        }
-    
+        kernels::kernelTable().sub(data, other.data, result.data, elementCount);
+
         return result;
     }
 
     Matrix Matrix::operator/(float scalar) const {
         Matrix quotient(rows, cols);
     
-        for (int i = 0; i < elementCount; i++)
-            quotient.data[i] = data[i] / scalar;
+        kernels::kernelTable().divide(data, scalar, quotient.data, elementCount);
 
         return quotient;
     }
@@ -116,22 +179,19 @@ namespace bbdnn {
         if (rows != other.rows || cols != other.cols)
             throw std::invalid_argument("Matrices must be of the same dimensions");
 
-        for (int i = 0; i < elementCount; i++)
-            data[i] += other.data[i];
+        kernels::kernelTable().add(data, other.data, data, elementCount);
 
         return *this;
     }
 
     Matrix& Matrix::operator*=(float scalar) {
-        for (int i = 0; i < elementCount; i++)
-            data[i] *= scalar;
+        kernels::kernelTable().scale(data, scalar, data, elementCount);
 
         return *this;
     }
 
     Matrix& Matrix::operator/=(float scalar) {
-        for (int i = 0; i < elementCount; i++)
-            data[i] /= scalar;
+        kernels::kernelTable().divide(data, scalar, data, elementCount);
 
         return *this;
     }
@@ -152,14 +212,7 @@ namespace bbdnn {
     }
 
     float Matrix::sum() const {
-        float acc = 0;
-
-        for (int i = 0; i < elementCount; i++)
-        {
-            acc += data[i];
-        }
-    
-        return acc;
+        return kernels::kernelTable().sum(data, elementCount);
     }
 
     Matrix Matrix::transposed() const {
@@ -178,8 +231,7 @@ namespace bbdnn {
     
         Matrix result(rows, cols);
 
-        for (int i = 0; i < elementCount; i++)
-            result.data[i] = other.data[i] * data[i];
+        kernels::kernelTable().mul(data, other.data, result.data, elementCount);
     
         return result;
     }
@@ -191,11 +243,13 @@ namespace bbdnn {
         if (inputs.Rows() != rows)
             throw std::invalid_argument("Input Length does not match Matrix rows");
 
-        Vector res(cols, 0.0f);
+        Vector res(cols);
 
-        for (int i = 0; i < rows; i++)
-            for (int c = 0; c < cols; c++)
-                res[c] += inputs.at(i, 0) * at(i, c);
+        // res^T = inputs^T * M, a vector-matrix product walking M one contiguous row at a time
+        kernels::gemm(1, cols, rows, 1.0f,
+                      inputs.data, rows, 1,
+                      data, cols, 1,
+                      0.0f, res.data, cols);
 
         return res;
     }
@@ -204,6 +258,14 @@ namespace bbdnn {
         return elementCount;
     }
 
+    float* Matrix::rawData() {
+        return data;
+    }
+
+    const float* Matrix::rawData() const {
+        return data;
+    }
+
     int Matrix::Rows() const {
         return rows;
     }
@@ -212,22 +274,16 @@ namespace bbdnn {
         return cols;
     }
 
-    float* Matrix::getRow(int row) const {
-        float* rowData = new float[cols];
-
-        for (int i = 0; i < cols; i++)
-            rowData[i] = at(row, i);
-    
-        return rowData;
+    MatrixView Matrix::view() const& {
+        return MatrixView(*this);
     }
 
-    float* Matrix::getCol(int col) const {
-        float* column = new float[rows];
+    VectorView Matrix::getRow(int row) const& {
+        return view().row(row);
+    }
 
-        for (int i = 0; i < rows; i++)
-            column[i] = at(i, col);
-    
-        return column;
+    VectorView Matrix::getCol(int col) const& {
+        return view().col(col);
     }
 
     float& Matrix::at(int row, int col) {
@@ -288,6 +344,21 @@ namespace bbdnn {
         return result;
     }
 
+    bool Matrix::ownsStorage() const {
+        return ownsData;
+    }
+
+    Matrix Matrix::borrow(int Rows, int Cols, float* Data) {
+        Matrix result;
+        result.rows = Rows;
+        result.cols = Cols;
+        result.elementCount = Rows * Cols;
+        result.data = Data;
+        result.ownsData = false;
+
+        return result;
+    }
+
     void Matrix::printMatrix() const {
         for (int i = 0; i < rows; i++)
         {
@@ -305,9 +376,14 @@ namespace bbdnn {
             throw std::invalid_argument("Vector objects must have only 1 col.");
     }
 
+    // Checked before the move so a rejected matrix keeps its storage
+    Vector::Vector(Matrix&& other) : Matrix(other.Cols() == 1 ? std::move(other) : throw std::invalid_argument("Vector objects must have only 1 col.")) { }
+
+    Vector::Vector(const VectorView& view) : Matrix(MatrixView(view.rawData(), view.size(), 1, view.stride())) { }
+
     Vector::Vector(int Size, float defaultVal) : Matrix(Size, 1, defaultVal) {}
 
-    Vector::Vector(float vals[], int Size): Matrix(Size, 1) {
+    Vector::Vector(const float vals[], int Size): Matrix(Size, 1) {
         for (int i = 0; i < Size; i++)
             (*this)[i] = vals[i];
     }
@@ -329,6 +405,15 @@ namespace bbdnn {
         return *this;
     }
 
+    Vector& Vector::operator=(Matrix&& other) {
+        if (other.Cols() != 1)
+            throw std::invalid_argument("Vector objects must have only 1 row.");
+    
+        Matrix::operator=(std::move(other));
+
+        return *this;
+    }
+
     float& Vector::operator[](int ind) {
         return at(ind, 0);
     }
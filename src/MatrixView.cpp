@@ -0,0 +1,83 @@
+#include "bbdnn/MatrixView.hpp"
+#include "bbdnn/Matrix.hpp"
+#include <stdexcept>
+
+namespace bbdnn {
+
+    namespace {
+        // Whether first .. first + count lies within 0 .. size
+        bool inRange(int first, int count, int size) {
+            return first >= 0 && count >= 0 && first <= size - count;
+        }
+    }
+
+    VectorView::VectorView(const float* Data, int Count, int Stride) : values(Data), count(Count), step(Stride) {
+        if (Count < 0)
+            throw std::invalid_argument("View size must be non-negative.");
+    }
+
+    VectorView::VectorView(const Matrix& vector) : values(vector.rawData()), count(vector.size()) {
+        if (vector.Cols() != 1 && vector.size() != 0)
+            throw std::invalid_argument("Vector views need a matrix with only 1 col.");
+    }
+
+    const float& VectorView::at(int i) const {
+        if (i < 0 || i >= count)
+            throw std::runtime_error("Out of bounds");
+
+        return values[static_cast<long>(i) * step];
+    }
+
+    VectorView VectorView::slice(int first, int Count) const {
+        if (!inRange(first, Count, count))
+            throw std::invalid_argument("Slice exceeds the view's elements.");
+
+        return VectorView(values + static_cast<long>(first) * step, Count, step);
+    }
+
+    MatrixView::MatrixView(const float* Data, int Rows, int Cols, int RowStride, int ColStride)
+        : values(Data), rowCount(Rows), colCount(Cols), rowStep(RowStride), colStep(ColStride) {
+        if (Rows < 0 || Cols < 0)
+            throw std::invalid_argument("View dimensions must be non-negative.");
+    }
+
+    MatrixView::MatrixView(const Matrix& matrix)
+        : values(matrix.rawData()), rowCount(matrix.Rows()), colCount(matrix.Cols()), rowStep(matrix.Cols()) { }
+
+    const float& MatrixView::at(int row, int col) const {
+        if (row < 0 || row >= rowCount || col < 0 || col >= colCount)
+            throw std::runtime_error("Out of bounds");
+
+        return values[static_cast<long>(row) * rowStep + static_cast<long>(col) * colStep];
+    }
+
+    VectorView MatrixView::row(int row) const {
+        if (!inRange(row, 1, rowCount))
+            throw std::invalid_argument("Row index exceeds the view's rows.");
+
+        return VectorView(values + static_cast<long>(row) * rowStep, colCount, colStep);
+    }
+
+    VectorView MatrixView::col(int col) const {
+        if (!inRange(col, 1, colCount))
+            throw std::invalid_argument("Column index exceeds the view's cols.");
+
+        return VectorView(values + static_cast<long>(col) * colStep, rowCount, rowStep);
+    }
+
+    MatrixView MatrixView::block(int row, int col, int rows, int cols) const {
+        if (!inRange(row, rows, rowCount) || !inRange(col, cols, colCount))
+            throw std::invalid_argument("Block exceeds the view's dimensions.");
+
+        return MatrixView(values + static_cast<long>(row) * rowStep + static_cast<long>(col) * colStep, rows, cols, rowStep, colStep);
+    }
+
+    MatrixView MatrixView::rowSlice(int first, int count) const {
+        return block(first, 0, count, colCount);
+    }
+
+    MatrixView MatrixView::transposed() const {
+        return MatrixView(values, colCount, rowCount, colStep, rowStep);
+    }
+
+}
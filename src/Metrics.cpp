@@ -0,0 +1,175 @@
+#include "bbdnn/Metrics.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace bbdnn {
+
+    namespace {
+        // Copy the retained entries of a ring that has had seen writes, oldest first
+        template <typename T>
+        std::vector<T> unroll(const std::vector<T>& ring, size_t seen) {
+            size_t capacity = ring.size();
+            if (capacity == 0)
+                return {};
+
+            size_t retained = std::min(seen, capacity);
+            size_t oldest = seen > capacity ? seen % capacity : 0;
+
+            std::vector<T> ordered(retained);
+            for (size_t i = 0; i < retained; i++)
+                ordered[i] = ring[(oldest + i) % capacity];
+
+            return ordered;
+        }
+    }
+
+    void IMetricsSink::record(const float*, size_t) {}
+
+    // ---- EpochRecorder ----
+
+    EpochRecorder::EpochRecorder(IMetricsSink& Sink)
+        : sink(Sink), epochStart(std::chrono::steady_clock::now()) {}
+
+    void EpochRecorder::record(const float* losses, size_t count) {
+        if (count == 0)
+            return;
+
+        if (samples == 0)
+            minLoss = maxLoss = losses[0];
+
+        // Sum in double so the mean holds up over millions of examples
+        for (size_t i = 0; i < count; i++) {
+            lossSum += losses[i];
+            minLoss = std::min(minLoss, losses[i]);
+            maxLoss = std::max(maxLoss, losses[i]);
+        }
+
+        samples += count;
+        sink.record(losses, count);
+    }
+
+    void EpochRecorder::record(float loss) {
+        record(&loss, 1);
+    }
+
+    bool EpochRecorder::endEpoch() {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        EpochMetrics metrics;
+        metrics.epoch = epoch;
+        metrics.samples = samples;
+        metrics.meanLoss = samples > 0 ? static_cast<float>(lossSum / static_cast<double>(samples)) : 0.0f;
+        metrics.minLoss = minLoss;
+        metrics.maxLoss = maxLoss;
+        metrics.seconds = std::chrono::duration<double>(now - epochStart).count();
+        metrics.samplesPerSecond = metrics.seconds > 0.0 ? static_cast<double>(samples) / metrics.seconds : 0.0;
+
+        epoch++;
+        samples = 0;
+        lossSum = 0.0;
+        minLoss = maxLoss = 0.0f;
+
+        bool keepGoing = sink.endEpoch(metrics);
+
+        // Time spent in the sink is not charged to the next epoch
+        epochStart = std::chrono::steady_clock::now();
+
+        return keepGoing;
+    }
+
+    int EpochRecorder::epochsCompleted() const {
+        return epoch;
+    }
+
+    // ---- MetricsHistory ----
+
+    MetricsHistory::MetricsHistory(size_t EpochCapacity, size_t LossCapacity)
+        : epochRing(EpochCapacity), lossRing(LossCapacity) {}
+
+    void MetricsHistory::record(const float* losses, size_t count) {
+        size_t capacity = lossRing.size();
+
+        // Only the last capacity values can survive
+        if (count > capacity) {
+            lossesSeen += count - capacity;
+            losses += count - capacity;
+            count = capacity;
+        }
+
+        for (size_t i = 0; i < count; i++, lossesSeen++)
+            lossRing[lossesSeen % capacity] = losses[i];
+    }
+
+    bool MetricsHistory::endEpoch(const EpochMetrics& metrics) {
+        if (!epochRing.empty())
+            epochRing[epochsSeen % epochRing.size()] = metrics;
+
+        epochsSeen++;
+        return true;
+    }
+
+    std::vector<EpochMetrics> MetricsHistory::epochs() const {
+        return unroll(epochRing, epochsSeen);
+    }
+
+    std::vector<float> MetricsHistory::losses() const {
+        return unroll(lossRing, lossesSeen);
+    }
+
+    const EpochMetrics& MetricsHistory::last() const {
+        if (epochsSeen == 0 || epochRing.empty())
+            throw std::logic_error("No epoch has been recorded.");
+
+        return epochRing[(epochsSeen - 1) % epochRing.size()];
+    }
+
+    size_t MetricsHistory::epochCount() const {
+        return epochsSeen;
+    }
+
+    size_t MetricsHistory::lossCount() const {
+        return lossesSeen;
+    }
+
+    void MetricsHistory::clear() {
+        epochsSeen = 0;
+        lossesSeen = 0;
+    }
+
+    // ---- EarlyStopping ----
+
+    EarlyStopping::EarlyStopping(float Threshold, IMetricsSink* Next)
+        : threshold(Threshold), next(Next) {}
+
+    void EarlyStopping::record(const float* losses, size_t count) {
+        if (next)
+            next->record(losses, count);
+    }
+
+    bool EarlyStopping::endEpoch(const EpochMetrics& metrics) {
+        bool keepGoing = next ? next->endEpoch(metrics) : true;
+
+        if (metrics.meanLoss <= threshold)
+            triggered = true;
+
+        return keepGoing && !triggered;
+    }
+
+    bool EarlyStopping::stopped() const {
+        return triggered;
+    }
+
+    // ---- MetricsCallback ----
+
+    MetricsCallback::MetricsCallback(std::function<bool(const EpochMetrics&)> Callback)
+        : callback(std::move(Callback)) {
+        if (!callback)
+            throw std::invalid_argument("Metrics callback must not be empty.");
+    }
+
+    bool MetricsCallback::endEpoch(const EpochMetrics& metrics) {
+        return callback(metrics);
+    }
+
+}
@@ -1,9 +1,114 @@
 #include "bbdnn/NeuralNetwork.hpp"
+#include "bbdnn/Expr.hpp"
+#include "bbdnn/Gemm.hpp"
+#include "bbdnn/Profiler.hpp"
+#include "bbdnn/Simd.hpp"
 #include <algorithm>
 
 namespace bbdnn {
 
-    NeuralNetwork::NeuralNetwork(uint_fast32_t RngSeed, std::vector<DenseLayer> Layers): layers(std::move(Layers)), layerCount(layers.size()), rngSeed(RngSeed) {
+    namespace {
+        // Samples scored per batched forward pass in evaluate()
+        constexpr int EVALUATION_BATCH_SIZE = 256;
+
+        // Keeps every example's SSR, for the training overloads that return them all
+        struct ResidualLog : IMetricsSink {
+            std::vector<float> losses;
+
+            explicit ResidualLog(size_t expectedCount) {
+                losses.reserve(expectedCount);
+            }
+
+            void record(const float* values, size_t count) override {
+                losses.insert(losses.end(), values, values + count);
+            }
+
+            bool endEpoch(const EpochMetrics&) override {
+                return true;
+            }
+        };
+
+        // Backpropagate one example into gradients. activated(l) and unactivated(l) return layer l's values,
+        // so the same pass serves the layers' own storage and a TrainingContext.
+        template <typename Activated, typename Unactivated>
+        float backPropagateInto(const std::vector<DenseLayer>& layers, const std::vector<LayerConnection>& connections,
+                                Activated activated, Unactivated unactivated, const Vector& expected,
+                                float gradientScale, bool accumulate, GradientWorkspace& gradients) {
+            int layerCount = static_cast<int>(layers.size());
+            const DenseLayer& last = layers.back();
+            int lastSize = last.size();
+
+            if (lastSize != expected.size())
+                throw std::invalid_argument("Expected values must be the sme size as output layer.");
+
+            const kernels::KernelTable& k = kernels::kernelTable();
+            const Vector& predicted = activated(layerCount - 1);
+
+            // Sensitivity of the output layer's unactivated neurons: dE/dA * f'(z)
+            Vector& outputSensitivity = gradients.sensitivities[layerCount - 1];
+            float residualSquared = 0;
+
+            {
+                BBDNN_PROFILE_LAYER(layerCount - 2);
+                BBDNN_PROFILE_SCOPE(profiling::Phase::Loss, 5L * lastSize, 4L * lastSize * sizeof(float));
+
+                last.getActivationFunction()->deriveInto(unactivated(layerCount - 1).rawData(), outputSensitivity.rawData(), lastSize);
+
+                // Evaluate accuracy alongside the derivative of the loss function
+                for (int i = 0; i < lastSize; i++) {
+                    float residual = expected[i] - predicted[i];
+                    residualSquared += residual * residual;
+                    outputSensitivity[i] *= -2 * residual;
+                }
+            }
+
+            // Walk connections from the output back, writing each gradient into its own slot
+            for (int l = layerCount - 2; l >= 0; l--) {
+                const DenseLayer& inLayer = layers[l];
+                int inSize = inLayer.size();
+                int outSize = layers[l + 1].size();
+
+                const Vector& delta = gradients.sensitivities[l + 1];
+                Matrix& weightGradient = gradients.weights[l];
+                Vector& biasGradient = gradients.biases[l];
+
+                BBDNN_PROFILE_LAYER(l);
+
+                // Sensitivity of this layer: (W . delta) * f'(z), using the weights before any update
+                Vector* sensitivity = l == 0 ? nullptr : &gradients.sensitivities[l];
+                Vector& derivatives = gradients.derivatives[l];
+
+                if (sensitivity) {
+                    BBDNN_PROFILE_SCOPE(profiling::Phase::Sensitivity, 2L * inSize, 2L * inSize * sizeof(float));
+                    inLayer.getActivationFunction()->deriveInto(unactivated(l).rawData(), derivatives.rawData(), inSize);
+                }
+
+                BBDNN_PROFILE_SCOPE(profiling::Phase::WeightGradient, (sensitivity ? 4L : 2L) * inSize * outSize + 2L * outSize,
+                                    (((accumulate ? 2L : 1L) + (sensitivity ? 1L : 0L)) * inSize * outSize + 3L * inSize + 3L * outSize) * sizeof(float));
+
+                // dE/dW = A^(l) . delta^T and W . delta in one sweep over the weights, dE/db = delta. The input
+                // connection has no sensitivity to fuse, and its bare outer product is store-bound either way
+                if (sensitivity)
+                    k.denseBackward(activated(l).rawData(), delta.rawData(), connections[l].getWeights().rawData(),
+                                    derivatives.rawData(), gradientScale, accumulate, weightGradient.rawData(),
+                                    sensitivity->rawData(), 1, inSize, outSize);
+                else
+                    kernels::gemm(inSize, outSize, 1, gradientScale,
+                                  activated(l).rawData(), 1, 1,
+                                  delta.rawData(), outSize, 1,
+                                  accumulate ? 1.0f : 0.0f, weightGradient.rawData(), outSize);
+
+                if (accumulate)
+                    k.axpy(gradientScale, delta.rawData(), biasGradient.rawData(), outSize);
+                else
+                    k.scale(delta.rawData(), gradientScale, biasGradient.rawData(), outSize);
+            }
+
+            return residualSquared;
+        }
+    }
+
+    NeuralNetwork::NeuralNetwork(uint_fast32_t RngSeed, std::vector<DenseLayer> Layers, bool initializeWeights): layers(std::move(Layers)), layerCount(layers.size()), rngSeed(RngSeed), shuffleEngine(RngSeed) {
         if (layerCount < 2)
             throw std::invalid_argument("Neural Network input vector must contain at least 2 layers");
 
@@ -14,10 +119,55 @@ namespace bbdnn {
             DenseLayer& outLayer = layers[i+1];
 
             // Add connection to connections list
-            connections.push_back(LayerConnection(inLayer, outLayer, true, rngSeed));
+            connections.push_back(LayerConnection(inLayer, outLayer, initializeWeights, rngSeed));
+        }
+
+        setOptimizer(Optimizer::SGD());
+    }
+
+    void NeuralNetwork::setOptimizer(OptimizerPtr newOptimizer) {
+        if (newOptimizer == nullptr)
+            throw std::invalid_argument("Optimizer pointer cannot be null.");
+
+        optimizer = std::move(newOptimizer);
+        optimizer->reset();
+
+        for (LayerConnection& connection : connections)
+            connection.resetOptimizerState(optimizer->stateCount());
+    }
+
+    const IOptimizer& NeuralNetwork::getOptimizer() const {
+        return *optimizer;
+    }
+
+    void NeuralNetwork::stepParameters(const GradientWorkspace& stepGradients, float learningRate) {
+        OptimizerStep step = optimizer->beginStep(learningRate);
+
+        for (size_t l = 0; l < connections.size(); l++) {
+            // Parameters and state are read and written, gradients only read
+            BBDNN_PROFILE_LAYER(static_cast<int>(l));
+            BBDNN_PROFILE_SCOPE(profiling::Phase::Update, 2L * connections[l].parameterCount() * (1 + optimizer->stateCount()),
+                                connections[l].parameterCount() * (3 + 2 * optimizer->stateCount()) * sizeof(float));
+
+            connections[l].applyGradients(stepGradients.weights[l], stepGradients.biases[l], *optimizer, step);
         }
     }
 
+    void NeuralNetwork::setThreadCount(int threads) {
+        if (threads <= 0)
+            throw std::invalid_argument("Thread count must be at least 1.");
+
+        if (threads == getThreadCount())
+            return;
+
+        pool = threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr;
+        contexts.clear();
+    }
+
+    int NeuralNetwork::getThreadCount() const {
+        return pool ? pool->size() : 1;
+    }
+
     const DenseLayer& NeuralNetwork::getLayer(int l) const {
         return layers[l];
     }
@@ -30,135 +180,102 @@ namespace bbdnn {
         // std::cerr << "Deleting Neural Network" << std::endl;
     }
 
-    void NeuralNetwork::setInput(Vector input)
+    void NeuralNetwork::setInput(VectorView input)
     {   
         DenseLayer& inputLayer = layers[0];
 
         inputLayer.setActivatedValues(input);
     }
 
-    Vector NeuralNetwork::output() const {
+    VectorView NeuralNetwork::output() const {
         int last = layerCount - 1;
 
         return layers[last].getActivatedVector();
     }
 
     void NeuralNetwork::forwardPropogate() {
-        for (LayerConnection& connection : connections)
-            connection.forwardPropogate();
+        for (size_t l = 0; l < connections.size(); l++) {
+            BBDNN_PROFILE_LAYER(static_cast<int>(l));
+            connections[l].forwardPropogate();
+        }
     }
 
-    Vector NeuralNetwork::getLayerErrorSensitivity(int layerIndex, const Vector& nextLayerSensitivity) {
-        if (layerIndex < 0 || layerIndex >= layerCount - 1)
-            throw std::out_of_range("Layer index out of range for getting layer error sensitivity.");
+    MatrixView NeuralNetwork::forwardPropogate(const Matrix& inputBatch) {
+        if (inputBatch.Cols() != inputSize())
+            throw std::invalid_argument("Input batch column count must match input layer size.");
 
-        LayerConnection& connection = connections[layerIndex];
-
-        DenseLayer& currentLayer = layers[layerIndex];
-        DenseLayer& nextLayer = layers[layerIndex + 1];
-
-        if (nextLayerSensitivity.size() != nextLayer.size())
-            throw std::invalid_argument("Next layer sensitivity vector size does not match next layer size.");
+        return forwardPropogate(inputBatch.rawData(), inputBatch.Rows());
+    }
 
-        Vector curDerivatives(currentLayer.size());
+    MatrixView NeuralNetwork::forwardPropogate(const float* inputRows, int batchSize) {
+        if (batchSize <= 0)
+            throw std::invalid_argument("Batch size must be positive");
 
-        // Look at every neuron
-        for (int i = 0; i < currentLayer.size(); i++)
+        // The first connection reads the rows in place; later ones read the previous layer's batch
         {
-            float sensOfLayer = 0; // The sensitivity of the next layer wrt the current activation
-        
-            float activationDerivative = 1;
-        
-            float preactivationVal = currentLayer.getUnactivatedValue(i);
-            activationDerivative = currentLayer.getActivationFunction()->derive(preactivationVal);
-
-            for (int j = 0; j < nextLayer.size(); j++)
-            {
-                float deltaUnactivatedNeuron = nextLayerSensitivity[j] * connection.weightAt(j, i);   
-                sensOfLayer += deltaUnactivatedNeuron;
-            }
+            BBDNN_PROFILE_LAYER(0);
+            connections[0].forwardPropogateBatch(inputRows, batchSize);
+        }
 
-            sensOfLayer *= activationDerivative;
-        
-            curDerivatives[i] = sensOfLayer;
+        for (int l = 1; l < layerCount - 1; l++) {
+            BBDNN_PROFILE_LAYER(l);
+            connections[l].forwardPropogateBatch();
         }
 
-        return curDerivatives;
+        return layers.back().getActivatedBatch().view().rowSlice(0, batchSize);
     }
 
-    std::tuple<std::vector<Matrix>, std::vector<Vector>, float> NeuralNetwork::backPropagate(Vector expected, 
-        float learningRate) {
-        DenseLayer& last = layers.back();
-        int lastSize = last.size();
-
-        if (lastSize != expected.size())
-            throw std::invalid_argument("Expected values must be the sme size as output layer.");
-
-        Vector predicted = last.getActivatedVector();
-
-        // Evaluate accuracy
-        float residualSquared = 0;
-        for (int i = 0; i < outputSize(); i++)
-            residualSquared += (expected[i] - predicted[i]) * (expected[i] - predicted[i]);
-        
-
-        std::vector<Matrix> weightsDiff;
-        std::vector<Vector> biasesDiff;
-
-        // Sensitivity of next layers' unactivated neurons
-        Vector forwardDerivatives(lastSize);
+    float NeuralNetwork::computeGradients(const Vector& expected, float gradientScale, bool accumulate) {
+        return backPropagateInto(layers, connections,
+                                 [this](int l) -> const Vector& { return layers[l].getActivatedValues(); },
+                                 [this](int l) -> const Vector& { return layers[l].getUnactivatedValues(); },
+                                 expected, gradientScale, accumulate, gradientWorkspace());
+    }
 
-        // Derivative of loss function
-        for (int i = 0; i < lastSize; i++)
-        {
-            float dE_dC = -2 * (expected[i] - predicted[i]);
-            float activationDerivative = 1;
+    GradientWorkspace& NeuralNetwork::gradientWorkspace() {
+        if (gradients.weights.empty())
+            gradients = GradientWorkspace(layers);
 
-        
-            float preactivationVal = last.getUnactivatedValue(i);
-            activationDerivative = last.getActivationFunction()->derive(preactivationVal);
+        return gradients;
+    }
 
-            float errorSens = dE_dC * activationDerivative;
-            forwardDerivatives[i] = errorSens;
+    void NeuralNetwork::forwardPropogate(InferenceContext& context, bool storeUnactivated) const {
+        for (size_t l = 0; l < connections.size(); l++) {
+            BBDNN_PROFILE_LAYER(static_cast<int>(l));
+            connections[l].forwardPropogate(context.activated[l], context.unactivated[l + 1], context.activated[l + 1], storeUnactivated);
         }
+    }
 
-        Matrix weightsGradient = layers[layerCount-2].getActivatedVector() * forwardDerivatives.transposed();
-        Vector biasGradient = forwardDerivatives;
-
-        Matrix costweightsDiff = weightsGradient * learningRate;
-        Vector costBiasesDiff = biasGradient * learningRate;
-
-        weightsDiff.push_back(costweightsDiff);
-        biasesDiff.push_back(costBiasesDiff);
-
-        // Derivatives of hidden layers
-        for (int l = layerCount - 2; l >= 1; l--)
-        {
-            LayerConnection& backwardConnection = connections[l-1];
-
-            DenseLayer& currentLayer = layers[l];
-            DenseLayer& prevLayer = layers[l-1];
-            Vector curDerivatives(currentLayer.size(), 0.0f);
+    float NeuralNetwork::computeGradients(TrainingContext& context, const Vector& expected, float gradientScale, bool accumulate) const {
+        return backPropagateInto(layers, connections,
+                                 [&context](int l) -> const Vector& { return context.activated[l]; },
+                                 [&context](int l) -> const Vector& { return context.unactivated[l]; },
+                                 expected, gradientScale, accumulate, context.gradients);
+    }
 
-            curDerivatives = getLayerErrorSensitivity(l, forwardDerivatives);
+    void NeuralNetwork::applyGradients(float learningRate) {
+        stepParameters(gradientWorkspace(), learningRate);
+    }
 
-            Matrix weightsGradient =  prevLayer.getActivatedVector() * curDerivatives.transposed();
-            Vector& biasGradient = curDerivatives;
+    const GradientWorkspace& NeuralNetwork::getGradients() const {
+        return gradients;
+    }
 
-            Matrix layerWeightsDiff = (weightsGradient * learningRate);
-            Vector layerBiasDiff = biasGradient * learningRate;
+    std::tuple<std::vector<Matrix>, std::vector<Vector>, float> NeuralNetwork::backPropagate(const Vector& expected, 
+        float learningRate) {
+        float residualSquared = computeGradients(expected);
 
-            weightsDiff.push_back(layerWeightsDiff);
-            biasesDiff.push_back(layerBiasDiff);
+        std::vector<Matrix> weightsDiff;
+        std::vector<Vector> biasesDiff;
+        weightsDiff.reserve(connections.size());
+        biasesDiff.reserve(connections.size());
 
-            forwardDerivatives = curDerivatives;
+        for (size_t l = 0; l < connections.size(); l++) {
+            weightsDiff.push_back(gradients.weights[l] * learningRate);
+            biasesDiff.push_back(gradients.biases[l] * learningRate);
         }
 
-        // reverse to match layer order
-        std::reverse(weightsDiff.begin(), weightsDiff.end());
-        std::reverse(biasesDiff.begin(), biasesDiff.end());
-
-        return { weightsDiff, biasesDiff, residualSquared };
+        return { std::move(weightsDiff), std::move(biasesDiff), residualSquared };
     }
 
     std::pair<std::vector<Matrix>, std::vector<Vector>> NeuralNetwork::takeStep(const std::vector<Matrix>& deltaWeights, const std::vector<Vector>& deltaBiases) {
@@ -173,14 +290,11 @@ namespace bbdnn {
         for (int l = 0; l < connectionCount; l++) {
             LayerConnection& connection = connections[l];
 
-            Matrix currentWeights = connection.getWeights();
-            Vector currentBiases = connection.getBiases();
-
-            newWeights[l] = currentWeights - deltaWeights[l];
-            newBiases[l] = currentBiases - deltaBiases[l];
+            newWeights[l] = connection.getWeights() - deltaWeights[l];
+            newBiases[l] = expr::lazy(connection.getBiases()) - deltaBiases[l];
         }
 
-        return { newWeights, newBiases };
+        return { std::move(newWeights), std::move(newBiases) };
     }
 
     void NeuralNetwork::updateParameters(std::vector<Matrix> newWeights, std::vector<Vector> newBiases) {
@@ -188,12 +302,19 @@ namespace bbdnn {
             throw std::invalid_argument("New weights/biases size must match number of connections.");
 
         for (size_t l = 0; l < connections.size(); l++) {
-            connections[l].setWeights(newWeights[l]);
-            connections[l].setBiases(newBiases[l]);
+            connections[l].setWeights(std::move(newWeights[l]));
+            connections[l].setBiases(std::move(newBiases[l]));
         }
     }
 
     std::vector<float> NeuralNetwork::train(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, bool isStochastic) {
+        ResidualLog log(trainingFeatures.size() * std::max(epochs, 0));
+        train(trainingFeatures, trainingLabels, learningRate, epochs, log, isStochastic);
+
+        return std::move(log.losses);
+    }
+
+    int NeuralNetwork::train(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, IMetricsSink& sink, bool isStochastic) {
         if (epochs <= 0)
             throw std::invalid_argument("Must have 1+ epochs to train model");
         
@@ -204,54 +325,348 @@ namespace bbdnn {
             throw std::invalid_argument("Training dataset must not be empty.");
         
             
-        size_t connectionCount = connections.size();
         size_t exampleCount = trainingFeatures.size();
         float exampleWeight = 1.0f / static_cast<float>(exampleCount);
         
-        std::vector<float> metrics;
-        
-        for (int epoch = 0; epoch < epochs; epoch++) {
-            std::vector<Matrix> cumDeltaWeights(connectionCount);
-            std::vector<Vector> cumDeltaBiases(connectionCount);
-
-            if (!isStochastic)
-            {
-                // Set shape and zero-out 'new<Parameter>' matrices
-                std::transform(connections.begin(), connections.end(), cumDeltaWeights.begin(), 
-                    [](const LayerConnection& lc){ return Matrix(lc.getWeights().Rows(), lc.getWeights().Cols(), 0.0f); });
+        if (!isStochastic && pool)
+            return trainParallel(trainingFeatures, trainingLabels, learningRate, epochs, sink);
 
-                std::transform(connections.begin(), connections.end(), cumDeltaBiases.begin(), 
-                    [](const LayerConnection& lc){ return Vector(lc.getBiases().size(), 0.0f); });
-            }
+        EpochRecorder recorder(sink);
 
+        for (int epoch = 0; epoch < epochs; epoch++) {
             for (size_t exampleInd = 0; exampleInd < exampleCount; exampleInd++) {
                 const Vector& expectedOut = trainingLabels[exampleInd];
 
                 setInput(trainingFeatures[exampleInd]);
                 forwardPropogate();
-                auto [deltaWeights, deltaBiases, outMetric] = backPropagate(expectedOut, learningRate);
-                metrics.push_back(outMetric);
 
                 // Update params based on method
                 if (isStochastic) { // SGD
-                    auto [newWeights, newBiases] = takeStep(deltaWeights, deltaBiases);
-                    updateParameters(newWeights, newBiases);
+                    recorder.record(computeGradients(expectedOut));
+                    applyGradients(learningRate);
                 }
-                else { // Full-batch Accumulation
-                    for (size_t l = 0; l < connectionCount; l++) {
-                        cumDeltaWeights[l] += deltaWeights[l] * exampleWeight;
-                        cumDeltaBiases[l] += deltaBiases[l] * exampleWeight;
-                    }
+                else { // Full-batch Accumulation; the first example overwrites last epoch's sums
+                    recorder.record(computeGradients(expectedOut, exampleWeight, exampleInd > 0));
                 }
             }
 
-            if (!isStochastic) { // Full-batch Update
-                auto [newWeights, newBiases] = takeStep(cumDeltaWeights, cumDeltaBiases);
-                updateParameters(newWeights, newBiases);
-            }
+            if (!isStochastic) // Full-batch Update
+                applyGradients(learningRate);
+
+            if (!recorder.endEpoch())
+                break;
         }
         
-        return metrics;
+        return recorder.epochsCompleted();
+    }
+
+    void NeuralNetwork::computeBatchGradients(const float* inputRows, const float* expectedRows, float* residuals) {
+        DenseLayer& last = layers.back();
+        int batchSize = last.batchSize();
+        int lastSize = last.size();
+
+        const kernels::KernelTable& k = kernels::kernelTable();
+        GradientWorkspace& gradients = gradientWorkspace();
+        gradients.resizeBatch(batchSize);
+
+        // Mean over the batch
+        float gradientScale = 1.0f / static_cast<float>(batchSize);
+
+        const Matrix& predicted = last.getActivatedBatch();
+        Matrix& outputSensitivity = gradients.batchSensitivities[layerCount - 1];
+
+        {
+            BBDNN_PROFILE_LAYER(layerCount - 2);
+            BBDNN_PROFILE_SCOPE(profiling::Phase::Loss, 5L * batchSize * lastSize, 4L * batchSize * lastSize * sizeof(float));
+
+            last.getActivationFunction()->deriveInto(last.getUnactivatedBatch().rawData(), outputSensitivity.rawData(), static_cast<size_t>(batchSize) * lastSize);
+
+            // Per-sample residuals and dE/dA * f'(z), one row per sample
+            for (int r = 0; r < batchSize; r++) {
+                const float* expected = expectedRows + (long)r * lastSize;
+                float residualSquared = 0;
+
+                for (int i = 0; i < lastSize; i++) {
+                    float residual = expected[i] - predicted(r, i);
+                    residualSquared += residual * residual;
+                    outputSensitivity(r, i) *= -2 * residual;
+                }
+
+                residuals[r] = residualSquared;
+            }
+        }
+
+        for (int l = layerCount - 2; l >= 0; l--) {
+            const DenseLayer& inLayer = layers[l];
+            int inSize = inLayer.size();
+            int outSize = layers[l + 1].size();
+
+            // The input rows were read in place by the forward pass, so layer 0 has no batch of its own
+            const float* inputs = l == 0 ? inputRows : inLayer.getActivatedBatch().rawData();
+            const Matrix& delta = gradients.batchSensitivities[l + 1];
+            Vector& biasGradient = gradients.biases[l];
+
+            BBDNN_PROFILE_LAYER(l);
+
+            // Delta^(l) = (Delta . W^T) * f'(Z^(l)), using the weights before any update
+            Matrix* sensitivity = l == 0 ? nullptr : &gradients.batchSensitivities[l];
+            Matrix& derivatives = gradients.batchDerivatives[l];
+
+            if (sensitivity) {
+                BBDNN_PROFILE_SCOPE(profiling::Phase::Sensitivity, 2L * batchSize * inSize, 2L * batchSize * inSize * sizeof(float));
+                inLayer.getActivationFunction()->deriveInto(inLayer.getUnactivatedBatch().rawData(), derivatives.rawData(), static_cast<size_t>(batchSize) * inSize);
+            }
+
+            BBDNN_PROFILE_SCOPE(profiling::Phase::WeightGradient, (sensitivity ? 4L : 2L) * batchSize * inSize * outSize + 2L * batchSize * outSize,
+                                ((sensitivity ? 2L : 1L) * inSize * outSize + (long)batchSize * (3L * inSize + outSize) + outSize) * sizeof(float));
+
+            // dE/dW = X^T . Delta and Delta . W^T in one sweep over the weights
+            k.denseBackward(inputs, delta.rawData(), connections[l].getWeights().rawData(),
+                            derivatives.rawData(), gradientScale, false, gradients.weights[l].rawData(),
+                            sensitivity ? sensitivity->rawData() : nullptr, batchSize, inSize, outSize);
+
+            // dE/db = column sums of Delta
+            std::fill(biasGradient.rawData(), biasGradient.rawData() + outSize, 0.0f);
+            for (int r = 0; r < batchSize; r++)
+                k.axpy(gradientScale, delta.rawData() + (long)r * outSize, biasGradient.rawData(), outSize);
+        }
+    }
+
+    std::vector<float> NeuralNetwork::trainMinibatch(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, int batchSize) {
+        ResidualLog log(trainingFeatures.size() * std::max(epochs, 0));
+        trainMinibatch(trainingFeatures, trainingLabels, learningRate, epochs, batchSize, log);
+
+        return std::move(log.losses);
+    }
+
+    int NeuralNetwork::trainMinibatch(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, int batchSize, IMetricsSink& sink) {
+        if (epochs <= 0)
+            throw std::invalid_argument("Must have 1+ epochs to train model");
+
+        if (batchSize <= 0)
+            throw std::invalid_argument("Batch size must be positive");
+
+        if (trainingFeatures.size() != trainingLabels.size())
+            throw std::invalid_argument("Training features and training labels must be of same count.");
+
+        if (trainingFeatures.empty())
+            throw std::invalid_argument("Training dataset must not be empty.");
+
+        size_t exampleCount = trainingFeatures.size();
+        int inSize = inputSize();
+        int outSize = outputSize();
+
+        for (size_t i = 0; i < exampleCount; i++) {
+            if (trainingFeatures[i].size() != inSize)
+                throw std::invalid_argument("Training feature size must match input layer size.");
+
+            if (trainingLabels[i].size() != outSize)
+                throw std::invalid_argument("Training label size must match output layer size.");
+        }
+
+        std::vector<size_t> order(exampleCount);
+        for (size_t i = 0; i < exampleCount; i++)
+            order[i] = i;
+
+        int capacity = static_cast<int>(std::min<size_t>(batchSize, exampleCount));
+        layers[0].resizeBatch(capacity);
+        reserveBatch(capacity);
+
+        Matrix expectedBatch(capacity, outSize);
+        std::vector<float> losses(capacity);
+        EpochRecorder recorder(sink);
+
+        for (int epoch = 0; epoch < epochs; epoch++) {
+            std::shuffle(order.begin(), order.end(), shuffleEngine);
+
+            for (size_t start = 0; start < exampleCount; start += batchSize) {
+                int rows = static_cast<int>(std::min<size_t>(batchSize, exampleCount - start));
+
+                // Gather the batch rows straight into the input layer
+                layers[0].resizeBatch(rows);
+                Matrix& inputBatch = layers[0].getActivatedBatch();
+
+                for (int r = 0; r < rows; r++) {
+                    const Vector& feature = trainingFeatures[order[start + r]];
+                    const Vector& label = trainingLabels[order[start + r]];
+
+                    std::copy(feature.rawData(), feature.rawData() + inSize, inputBatch[r]);
+                    std::copy(label.rawData(), label.rawData() + outSize, expectedBatch[r]);
+                }
+
+                trainBatch(inputBatch.rawData(), expectedBatch.rawData(), rows, learningRate, losses.data());
+                recorder.record(losses.data(), rows);
+            }
+
+            if (!recorder.endEpoch())
+                break;
+        }
+
+        return recorder.epochsCompleted();
+    }
+
+    void NeuralNetwork::trainBatch(const float* inputRows, const float* expectedRows, int rows, float learningRate, float* residuals) {
+        forwardPropogate(inputRows, rows);
+        computeBatchGradients(inputRows, expectedRows, residuals);
+        applyGradients(learningRate);
+    }
+
+    void NeuralNetwork::reserveBatch(int rows) {
+        // The input layer is only filled by the std::vector overload of trainMinibatch, which sizes it itself
+        for (int l = 1; l < layerCount; l++)
+            layers[l].resizeBatch(rows);
+
+        gradientWorkspace().resizeBatch(rows);
+    }
+
+    void NeuralNetwork::trainBatches(const Dataset& data, float learningRate, int batchSize, std::vector<size_t>& batchStarts, std::vector<float>& losses, EpochRecorder& recorder) {
+        size_t exampleCount = data.size();
+        reserveBatch(static_cast<int>(std::min<size_t>(batchSize, exampleCount)));
+
+        batchStarts.clear();
+        for (size_t start = 0; start < exampleCount; start += batchSize)
+            batchStarts.push_back(start);
+
+        std::shuffle(batchStarts.begin(), batchStarts.end(), shuffleEngine);
+
+        for (size_t start : batchStarts) {
+            int rows = static_cast<int>(std::min<size_t>(batchSize, exampleCount - start));
+
+            trainBatch(data.featureRow(start), data.labelRow(start), rows, learningRate, losses.data());
+            recorder.record(losses.data(), rows);
+        }
+    }
+
+    std::vector<float> NeuralNetwork::trainMinibatch(const Dataset& trainingData, float learningRate, int epochs, int batchSize) {
+        ResidualLog log(trainingData.size() * std::max(epochs, 0));
+        trainMinibatch(trainingData, learningRate, epochs, batchSize, log);
+
+        return std::move(log.losses);
+    }
+
+    int NeuralNetwork::trainMinibatch(const Dataset& trainingData, float learningRate, int epochs, int batchSize, IMetricsSink& sink) {
+        if (epochs <= 0)
+            throw std::invalid_argument("Must have 1+ epochs to train model");
+
+        if (batchSize <= 0)
+            throw std::invalid_argument("Batch size must be positive");
+
+        if (trainingData.empty())
+            throw std::invalid_argument("Training dataset must not be empty.");
+
+        if (trainingData.featureSize() != inputSize() || trainingData.labelSize() != outputSize())
+            throw std::invalid_argument("Dataset feature and label sizes must match the input and output layer sizes.");
+
+        std::vector<size_t> batchStarts;
+        std::vector<float> losses(batchSize);
+        EpochRecorder recorder(sink);
+
+        for (int epoch = 0; epoch < epochs; epoch++) {
+            trainBatches(trainingData, learningRate, batchSize, batchStarts, losses, recorder);
+
+            if (!recorder.endEpoch())
+                break;
+        }
+
+        return recorder.epochsCompleted();
+    }
+
+    std::vector<float> NeuralNetwork::trainMinibatch(DatasetStream& trainingData, float learningRate, int epochs, int batchSize) {
+        ResidualLog log(0);
+        trainMinibatch(trainingData, learningRate, epochs, batchSize, log);
+
+        return std::move(log.losses);
+    }
+
+    int NeuralNetwork::trainMinibatch(DatasetStream& trainingData, float learningRate, int epochs, int batchSize, IMetricsSink& sink) {
+        if (epochs <= 0)
+            throw std::invalid_argument("Must have 1+ epochs to train model");
+
+        if (batchSize <= 0)
+            throw std::invalid_argument("Batch size must be positive");
+
+        if (trainingData.featureSize() != inputSize() || trainingData.labelSize() != outputSize())
+            throw std::invalid_argument("Dataset feature and label sizes must match the input and output layer sizes.");
+
+        Dataset chunk(trainingData.featureSize(), trainingData.labelSize());
+        std::vector<size_t> batchStarts;
+        std::vector<float> losses(batchSize);
+        EpochRecorder recorder(sink);
+
+        for (int epoch = 0; epoch < epochs; epoch++) {
+            if (epoch > 0)
+                trainingData.rewind();
+
+            while (trainingData.next(chunk))
+                trainBatches(chunk, learningRate, batchSize, batchStarts, losses, recorder);
+
+            if (!recorder.endEpoch())
+                break;
+        }
+
+        return recorder.epochsCompleted();
+    }
+
+    int NeuralNetwork::trainParallel(const std::vector<Vector>& trainingFeatures, const std::vector<Vector>& trainingLabels, float learningRate, int epochs, IMetricsSink& sink) {
+        size_t exampleCount = trainingFeatures.size();
+        float exampleWeight = 1.0f / static_cast<float>(exampleCount);
+
+        // Workers index into their own range, so catch bad shapes before any thread starts
+        for (size_t i = 0; i < exampleCount; i++) {
+            if (trainingFeatures[i].size() != inputSize())
+                throw std::invalid_argument("Training feature size must match input layer size.");
+
+            if (trainingLabels[i].size() != outputSize())
+                throw std::invalid_argument("Training label size must match output layer size.");
+        }
+
+        // One contiguous shard per context. The split depends only on the thread and example counts,
+        // so a given thread count always sums in the same order
+        int shardCount = static_cast<int>(std::min<size_t>(pool->size(), exampleCount));
+
+        while (static_cast<int>(contexts.size()) < shardCount)
+            contexts.emplace_back(layers);
+
+        // Shards write their examples' SSRs side by side; the buffer is reused every epoch
+        std::vector<float> losses(exampleCount);
+        float* epochMetrics = losses.data();
+        EpochRecorder recorder(sink);
+
+        for (int epoch = 0; epoch < epochs; epoch++) {
+            pool->run(shardCount, [&](int shard) {
+                TrainingContext& context = contexts[shard];
+                size_t begin = exampleCount * shard / shardCount;
+                size_t end = exampleCount * (shard + 1) / shardCount;
+
+                for (size_t exampleInd = begin; exampleInd < end; exampleInd++) {
+                    context.setInput(trainingFeatures[exampleInd]);
+                    forwardPropogate(context);
+                    epochMetrics[exampleInd] = computeGradients(context, trainingLabels[exampleInd], exampleWeight, exampleInd > begin);
+                }
+            });
+
+            // Pairwise tree reduction into contexts[0]; the pairing is fixed, so the sum is reproducible
+            for (int stride = 1; stride < shardCount; stride *= 2) {
+                int pairs = (shardCount + 2 * stride - 1) / (2 * stride);
+
+                pool->run(pairs, [&](int pair) {
+                    int target = pair * 2 * stride;
+
+                    if (target + stride < shardCount) {
+                        BBDNN_PROFILE_SCOPE(profiling::Phase::Reduction, parameterCount(), 3 * parameterCount() * sizeof(float));
+                        contexts[target].gradients.accumulate(contexts[target + stride].gradients);
+                    }
+                });
+            }
+
+            stepParameters(contexts[0].gradients, learningRate);
+            recorder.record(losses.data(), exampleCount);
+
+            if (!recorder.endEpoch())
+                break;
+        }
+
+        return recorder.epochsCompleted();
     }
 
     std::vector<float> NeuralNetwork::evaluate(const std::vector<Vector>& testFeatures, const std::vector<Vector>& testLabels) {
@@ -262,49 +677,173 @@ namespace bbdnn {
             throw std::invalid_argument("Test dataset must not be empty.");
 
         size_t exampleCount = testFeatures.size();
+        int inSize = inputSize();
+        int outSize = outputSize();
+
         std::vector<float> metrics;
         metrics.reserve(exampleCount);
 
-        for (size_t exampleInd = 0; exampleInd < exampleCount; exampleInd++) {
-            const Vector& expectedOut = testLabels[exampleInd];
+        // Score in batches so each weight matrix is streamed once per batch instead of once per example
+        Matrix batch(static_cast<int>(std::min<size_t>(EVALUATION_BATCH_SIZE, exampleCount)), inSize);
 
-            setInput(testFeatures[exampleInd]);
-            forwardPropogate();
-            DenseLayer& last = layers.back();
-            Vector predicted = last.getActivatedVector();
+        for (size_t start = 0; start < exampleCount; start += EVALUATION_BATCH_SIZE) {
+            int batchSize = static_cast<int>(std::min<size_t>(EVALUATION_BATCH_SIZE, exampleCount - start));
 
-            float residulSquared = 0;
-            for (int i = 0; i < outputSize(); i++)
-                residulSquared += (expectedOut[i] - predicted[i]) * (expectedOut[i] - predicted[i]);
-            
-            metrics.push_back(residulSquared);
+            for (int r = 0; r < batchSize; r++) {
+                const Vector& feature = testFeatures[start + r];
+
+                if (feature.size() != inSize)
+                    throw std::invalid_argument("Test feature size must match input layer size.");
+
+                std::copy(feature.rawData(), feature.rawData() + inSize, batch[r]);
+            }
+
+            MatrixView predicted = forwardPropogate(batch.rawData(), batchSize);
+
+            for (int r = 0; r < batchSize; r++) {
+                const Vector& expectedOut = testLabels[start + r];
+
+                if (expectedOut.size() != outSize)
+                    throw std::invalid_argument("Test label size must match output layer size.");
+
+                float residulSquared = 0;
+                for (int i = 0; i < outSize; i++)
+                    residulSquared += (expectedOut[i] - predicted(r, i)) * (expectedOut[i] - predicted(r, i));
+
+                metrics.push_back(residulSquared);
+            }
+        }
+
+        return metrics;
+    }
+
+    void NeuralNetwork::scoreBatches(const Dataset& data, std::vector<float>& metrics) {
+        int outSize = outputSize();
+
+        for (size_t start = 0; start < data.size(); start += EVALUATION_BATCH_SIZE) {
+            int batchSize = static_cast<int>(std::min<size_t>(EVALUATION_BATCH_SIZE, data.size() - start));
+            MatrixView predicted = forwardPropogate(data.featureRow(start), batchSize);
+
+            for (int r = 0; r < batchSize; r++) {
+                const float* expectedOut = data.labelRow(start + r);
+
+                float residulSquared = 0;
+                for (int i = 0; i < outSize; i++)
+                    residulSquared += (expectedOut[i] - predicted(r, i)) * (expectedOut[i] - predicted(r, i));
+
+                metrics.push_back(residulSquared);
+            }
         }
+    }
+
+    std::vector<float> NeuralNetwork::evaluate(const Dataset& testData) {
+        if (testData.empty())
+            throw std::invalid_argument("Test dataset must not be empty.");
+
+        if (testData.featureSize() != inputSize() || testData.labelSize() != outputSize())
+            throw std::invalid_argument("Dataset feature and label sizes must match the input and output layer sizes.");
+
+        std::vector<float> metrics;
+        metrics.reserve(testData.size());
+        scoreBatches(testData, metrics);
+
+        return metrics;
+    }
+
+    std::vector<float> NeuralNetwork::evaluate(DatasetStream& testData) {
+        if (testData.featureSize() != inputSize() || testData.labelSize() != outputSize())
+            throw std::invalid_argument("Dataset feature and label sizes must match the input and output layer sizes.");
+
+        Dataset chunk(testData.featureSize(), testData.labelSize());
+        std::vector<float> metrics;
+
+        while (testData.next(chunk))
+            scoreBatches(chunk, metrics);
 
         return metrics;
     }
 
-    Vector NeuralNetwork::predict(const Vector& input) {
-        setInput(input);
-        forwardPropogate();
-        Vector prediction = output();
-        clear();
+    Vector NeuralNetwork::predict(const Vector& input) const {
+        InferenceContext context = createInferenceContext();
 
-        return prediction;
+        return predict(input, context);
+    }
+
+    const Vector& NeuralNetwork::predict(const Vector& input, InferenceContext& context) const {
+        if (context.activated.size() != layers.size())
+            throw std::invalid_argument("Inference context does not match the network's layer count.");
+
+        context.setInput(input);
+        forwardPropogate(context, false);
+
+        return context.output();
+    }
+
+    InferenceContext NeuralNetwork::createInferenceContext() const {
+        return InferenceContext(layers);
     }
 
     void NeuralNetwork::clear() {
-        for (auto& layer : layers)
-            layer.setActivatedValues(Vector(layer.size(), 0.0f));
+        for (auto& layer : layers) {
+            Vector& values = layer.getActivatedValues();
+            std::fill(values.rawData(), values.rawData() + values.size(), 0.0f);
+        }
     }
 
     const std::vector<LayerConnection>& NeuralNetwork::getConnections() const {
         return connections;
     }
 
+    uint_fast32_t NeuralNetwork::seed() const {
+        return rngSeed;
+    }
+
     int NeuralNetwork::size() const {
         return layerCount;
     }
 
+    int NeuralNetwork::parameterCount() const {
+        int count = 0;
+        for (const LayerConnection& connection : connections)
+            count += connection.parameterCount();
+
+        return count;
+    }
+
+    void NeuralNetwork::setWeightPrecision(WeightPrecision precision, bool keepMasterWeights) {
+        if (!keepMasterWeights && precision == WeightPrecision::Float32)
+            throw std::invalid_argument("fp32 weights are the master weights and cannot be released.");
+
+        for (LayerConnection& connection : connections) {
+            connection.setWeightPrecision(precision);
+
+            if (!keepMasterWeights)
+                connection.releaseMasterWeights();
+        }
+    }
+
+    WeightPrecision NeuralNetwork::getWeightPrecision() const {
+        return connections.front().getWeightPrecision();
+    }
+
+    size_t NeuralNetwork::weightBytes() const {
+        size_t bytes = 0;
+        for (const LayerConnection& connection : connections)
+            bytes += connection.weightBytes();
+
+        return bytes;
+    }
+
+    void NeuralNetwork::setWorkload(Workload workload) {
+        for (LayerConnection& connection : connections)
+            connection.setWeightLayout(connection.layoutFor(workload));
+    }
+
+    void NeuralNetwork::updateSparseWeights() {
+        for (LayerConnection& connection : connections)
+            connection.updateSparseWeights();
+    }
+
     int NeuralNetwork::inputSize() const
     {
         return layers[0].size();
@@ -0,0 +1,170 @@
+#include "bbdnn/Optimizers.hpp"
+#include "bbdnn/Simd.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    void IOptimizer::update(const OptimizerStep& step, float* params, const float* grads, float* state0, float* state1, size_t n) const {
+        if (kind() == OptimizerKind::Custom)
+            throw std::logic_error("Custom optimizers must override update.");
+
+        kernels::kernelTable().optimize(kind(), step, params, grads, state0, state1, n);
+    }
+
+    void IOptimizer::reset() {}
+
+    OptimizerKind IOptimizer::kind() const {
+        return OptimizerKind::Custom;
+    }
+
+    int SGDOptimizer::stateCount() const {
+        return 0;
+    }
+
+    OptimizerStep SGDOptimizer::beginStep(float learningRate) {
+        OptimizerStep step;
+        step.learningRate = learningRate;
+
+        return step;
+    }
+
+    OptimizerKind SGDOptimizer::kind() const {
+        return OptimizerKind::SGD;
+    }
+
+    OptimizerPtr SGDOptimizer::clone() const {
+        return std::make_unique<SGDOptimizer>(*this);
+    }
+
+    MomentumOptimizer::MomentumOptimizer(float Momentum) : momentum(Momentum) {}
+
+    int MomentumOptimizer::stateCount() const {
+        return 1;
+    }
+
+    OptimizerStep MomentumOptimizer::beginStep(float learningRate) {
+        OptimizerStep step;
+        step.learningRate = learningRate;
+        step.decay1 = momentum;
+
+        return step;
+    }
+
+    OptimizerKind MomentumOptimizer::kind() const {
+        return OptimizerKind::Momentum;
+    }
+
+    OptimizerPtr MomentumOptimizer::clone() const {
+        return std::make_unique<MomentumOptimizer>(*this);
+    }
+
+    NesterovOptimizer::NesterovOptimizer(float Momentum) : momentum(Momentum) {}
+
+    int NesterovOptimizer::stateCount() const {
+        return 1;
+    }
+
+    OptimizerStep NesterovOptimizer::beginStep(float learningRate) {
+        OptimizerStep step;
+        step.learningRate = learningRate;
+        step.decay1 = momentum;
+
+        return step;
+    }
+
+    OptimizerKind NesterovOptimizer::kind() const {
+        return OptimizerKind::Nesterov;
+    }
+
+    OptimizerPtr NesterovOptimizer::clone() const {
+        return std::make_unique<NesterovOptimizer>(*this);
+    }
+
+    RMSPropOptimizer::RMSPropOptimizer(float Rho, float Epsilon) : rho(Rho), epsilon(Epsilon) {}
+
+    int RMSPropOptimizer::stateCount() const {
+        return 1;
+    }
+
+    OptimizerStep RMSPropOptimizer::beginStep(float learningRate) {
+        OptimizerStep step;
+        step.learningRate = learningRate;
+        step.decay1 = rho;
+        step.epsilon = epsilon;
+
+        return step;
+    }
+
+    OptimizerKind RMSPropOptimizer::kind() const {
+        return OptimizerKind::RMSProp;
+    }
+
+    OptimizerPtr RMSPropOptimizer::clone() const {
+        return std::make_unique<RMSPropOptimizer>(*this);
+    }
+
+    AdamOptimizer::AdamOptimizer(float Beta1, float Beta2, float Epsilon) : beta1(Beta1), beta2(Beta2), epsilon(Epsilon) {}
+
+    int AdamOptimizer::stateCount() const {
+        return 2;
+    }
+
+    OptimizerStep AdamOptimizer::beginStep(float learningRate) {
+        steps++;
+
+        OptimizerStep step;
+        step.learningRate = learningRate;
+        step.decay1 = beta1;
+        step.decay2 = beta2;
+        step.epsilon = epsilon;
+        step.correction1 = static_cast<float>(1.0 / (1.0 - std::pow(static_cast<double>(beta1), steps)));
+        step.correction2 = static_cast<float>(1.0 / (1.0 - std::pow(static_cast<double>(beta2), steps)));
+
+        return step;
+    }
+
+    void AdamOptimizer::reset() {
+        steps = 0;
+    }
+
+    OptimizerKind AdamOptimizer::kind() const {
+        return OptimizerKind::Adam;
+    }
+
+    OptimizerPtr AdamOptimizer::clone() const {
+        return std::make_unique<AdamOptimizer>(*this);
+    }
+
+    AdamWOptimizer::AdamWOptimizer(float Beta1, float Beta2, float Epsilon, float WeightDecay) : AdamOptimizer(Beta1, Beta2, Epsilon), weightDecay(WeightDecay) {}
+
+    OptimizerStep AdamWOptimizer::beginStep(float learningRate) {
+        OptimizerStep step = AdamOptimizer::beginStep(learningRate);
+        step.weightDecay = weightDecay;
+
+        return step;
+    }
+
+    OptimizerKind AdamWOptimizer::kind() const {
+        return OptimizerKind::AdamW;
+    }
+
+    OptimizerPtr AdamWOptimizer::clone() const {
+        return std::make_unique<AdamWOptimizer>(*this);
+    }
+
+    namespace Optimizer {
+        OptimizerPtr SGD() { return make_optimizer<SGDOptimizer>(); }
+
+        OptimizerPtr Momentum(float momentum) { return make_optimizer<MomentumOptimizer>(momentum); }
+
+        OptimizerPtr Nesterov(float momentum) { return make_optimizer<NesterovOptimizer>(momentum); }
+
+        OptimizerPtr RMSProp(float rho, float epsilon) { return make_optimizer<RMSPropOptimizer>(rho, epsilon); }
+
+        OptimizerPtr Adam(float beta1, float beta2, float epsilon) { return make_optimizer<AdamOptimizer>(beta1, beta2, epsilon); }
+
+        OptimizerPtr AdamW(float beta1, float beta2, float epsilon, float weightDecay) { return make_optimizer<AdamWOptimizer>(beta1, beta2, epsilon, weightDecay); }
+    }
+
+}
@@ -0,0 +1,327 @@
+#include "bbdnn/Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace bbdnn::profiling {
+
+    using detail::Slot;
+    using detail::TraceEvent;
+    using detail::ThreadLog;
+
+    namespace {
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadLog>> logs;
+            // Cycle counter and clock at the last reset, for converting ticks to nanoseconds
+            uint64_t originTicks;
+            std::chrono::steady_clock::time_point origin;
+
+            Registry();
+        };
+
+        // A sampled call at least this long (about 5 us at 3 GHz) keeps the next call's clock reads under 1% of
+        // its time, so long phases such as batched GEMMs are measured on every call regardless of the period
+        constexpr uint64_t LONG_CALL_TICKS = 1 << 14;
+
+        std::atomic<size_t> maxEvents { 0 };
+        std::atomic<uint32_t> period { DEFAULT_SAMPLE_PERIOD };
+
+        // A cycle counter costs a fraction of a steady_clock read, which matters for scopes this small
+        uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            uint64_t value;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+            return value;
+#else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        Registry::Registry() : originTicks(ticks()), origin(std::chrono::steady_clock::now()) {}
+
+        Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        // Nanoseconds per tick, measured against steady_clock since the last reset. Waits until at least
+        // a millisecond has passed so the ratio is meaningful. Caller holds the registry lock
+        double nanosecondsPerTick(const Registry& r) {
+            std::chrono::steady_clock::time_point end = r.origin + std::chrono::milliseconds(1);
+            while (std::chrono::steady_clock::now() < end) {}
+
+            uint64_t elapsedTicks = ticks() - r.originTicks;
+            double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - r.origin).count();
+
+            return elapsedTicks > 0 ? elapsed / static_cast<double>(elapsedTicks) : 1.0;
+        }
+
+        std::string layerName(int layer) {
+            return layer < 0 ? std::string("network") : "L" + std::to_string(layer);
+        }
+
+    }
+
+    namespace detail {
+
+        // Read on every scope, so kept out of the registry's lazy initialization
+        constinit thread_local ThreadLog* currentLog = nullptr;
+        std::atomic<bool> tracing { false };
+
+        // The registry keeps each log after its thread exits, so its totals still show up
+        ThreadLog& registerThread() {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+
+            r.logs.push_back(std::make_unique<ThreadLog>());
+            currentLog = r.logs.back().get();
+            currentLog->threadId = static_cast<int>(r.logs.size());
+
+            return *currentLog;
+        }
+
+        void growSlots(ThreadLog& log, size_t index) {
+            size_t oldSize = log.stats.size();
+            log.stats.resize((index / PHASE_COUNT + 1) * PHASE_COUNT);
+
+            for (size_t i = oldSize; i < log.stats.size(); i++) {
+                log.stats[i].totals.phase = static_cast<Phase>(i % PHASE_COUNT);
+                log.stats[i].totals.layer = static_cast<int>(i / PHASE_COUNT) - 1;
+            }
+        }
+
+    }
+
+    const char* phaseName(Phase phase) {
+        switch (phase) {
+            case Phase::Forward: return "Forward";
+            case Phase::Activation: return "Activation";
+            case Phase::Loss: return "Loss";
+            case Phase::Sensitivity: return "Sensitivity";
+            case Phase::WeightGradient: return "WeightGradient";
+            case Phase::Update: return "Update";
+            case Phase::Reduction: return "Reduction";
+        }
+
+        return "Unknown";
+    }
+
+    bool enabled() {
+#ifdef BBDNN_ENABLE_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void reset() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        for (const std::unique_ptr<ThreadLog>& log : r.logs) {
+            log->allocations = 0;
+            log->stats.clear();
+            log->events.clear();
+        }
+
+        r.originTicks = ticks();
+        r.origin = std::chrono::steady_clock::now();
+    }
+
+    void setSamplePeriod(uint32_t samplePeriod) {
+        period.store(std::max<uint32_t>(samplePeriod, 1), std::memory_order_relaxed);
+    }
+
+    uint32_t samplePeriod() {
+        return period.load(std::memory_order_relaxed);
+    }
+
+    void setTracing(bool on, size_t eventLimit) {
+        maxEvents.store(eventLimit, std::memory_order_relaxed);
+        detail::tracing.store(on, std::memory_order_relaxed);
+    }
+
+    bool isTracing() {
+        return detail::tracing.load(std::memory_order_relaxed);
+    }
+
+    std::vector<PhaseStats> summary() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        std::vector<PhaseStats> totals;
+        // Calls the samples stand for, short of totals[i].calls by the calls since each thread's last sample
+        std::vector<uint64_t> represented;
+
+        for (const std::unique_ptr<ThreadLog>& log : r.logs) {
+            if (log->stats.size() > totals.size()) {
+                size_t oldSize = totals.size();
+                totals.resize(log->stats.size());
+                represented.resize(log->stats.size());
+
+                for (size_t i = oldSize; i < totals.size(); i++) {
+                    totals[i].phase = static_cast<Phase>(i % PHASE_COUNT);
+                    totals[i].layer = static_cast<int>(i / PHASE_COUNT) - 1;
+                }
+            }
+
+            for (size_t i = 0; i < log->stats.size(); i++) {
+                const PhaseStats& stats = log->stats[i].totals;
+                represented[i] += stats.calls;
+                totals[i].calls += stats.calls + log->stats[i].interval - log->stats[i].countdown;
+                totals[i].sampledCalls += stats.sampledCalls;
+                totals[i].nanoseconds += stats.nanoseconds;
+                totals[i].flops += stats.flops;
+                totals[i].bytes += stats.bytes;
+                totals[i].allocations += stats.allocations;
+            }
+        }
+
+        // Extend the samples to the calls made since the last ones
+        double scale = nanosecondsPerTick(r);
+        for (size_t i = 0; i < totals.size(); i++) {
+            PhaseStats& s = totals[i];
+            double extension = represented[i] > 0 ? static_cast<double>(s.calls) / static_cast<double>(represented[i]) : 0.0;
+            s.nanoseconds = static_cast<uint64_t>(static_cast<double>(s.nanoseconds) * scale * extension + 0.5);
+            s.flops = static_cast<uint64_t>(static_cast<double>(s.flops) * extension + 0.5);
+            s.bytes = static_cast<uint64_t>(static_cast<double>(s.bytes) * extension + 0.5);
+            s.allocations = static_cast<uint64_t>(static_cast<double>(s.allocations) * extension + 0.5);
+        }
+
+        totals.erase(std::remove_if(totals.begin(), totals.end(), [](const PhaseStats& s) { return s.calls == 0; }), totals.end());
+
+        return totals;
+    }
+
+    uint64_t allocationCount() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        uint64_t count = 0;
+        for (const std::unique_ptr<ThreadLog>& log : r.logs)
+            count += log->allocations;
+
+        return count;
+    }
+
+    void printSummary(std::ostream& out) {
+        std::vector<PhaseStats> totals = summary();
+
+        uint64_t totalNanoseconds = 0;
+        for (const PhaseStats& s : totals)
+            totalNanoseconds += s.nanoseconds;
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-8s %-15s %10s %11s %7s %9s %8s %8s\n",
+                      "layer", "phase", "calls", "time (ms)", "share", "GFLOP/s", "GB/s", "allocs");
+        out << line;
+
+        for (const PhaseStats& s : totals) {
+            double seconds = static_cast<double>(s.nanoseconds) * 1e-9;
+            double share = totalNanoseconds > 0 ? 100.0 * static_cast<double>(s.nanoseconds) / static_cast<double>(totalNanoseconds) : 0.0;
+            double gflops = seconds > 0.0 ? static_cast<double>(s.flops) / seconds * 1e-9 : 0.0;
+            double gbytes = seconds > 0.0 ? static_cast<double>(s.bytes) / seconds * 1e-9 : 0.0;
+
+            std::snprintf(line, sizeof(line), "%-8s %-15s %10llu %11.3f %6.1f%% %9.2f %8.2f %8llu\n",
+                          layerName(s.layer).c_str(), phaseName(s.phase), static_cast<unsigned long long>(s.calls),
+                          seconds * 1e3, share, gflops, gbytes, static_cast<unsigned long long>(s.allocations));
+            out << line;
+        }
+
+        std::snprintf(line, sizeof(line), "total %.3f ms in phases, %llu matrix allocations\n",
+                      static_cast<double>(totalNanoseconds) * 1e-6, static_cast<unsigned long long>(allocationCount()));
+        out << line;
+    }
+
+    void writeChromeTrace(const std::string& path) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Could not open trace file for writing: " + path);
+
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        double scale = nanosecondsPerTick(r);
+
+        file << "{\"traceEvents\":[";
+        bool first = true;
+        char event[320];
+
+        for (const std::unique_ptr<ThreadLog>& log : r.logs) {
+            std::snprintf(event, sizeof(event),
+                          "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"bbdnn thread %d\"}}",
+                          first ? "" : ",", log->threadId, log->threadId);
+            file << event;
+            first = false;
+
+            // Complete events with microsecond timestamps
+            for (const TraceEvent& e : log->events) {
+                std::snprintf(event, sizeof(event),
+                              ",\n{\"name\":\"%s %s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                              "\"args\":{\"layer\":%d,\"flops\":%llu,\"bytes\":%llu}}",
+                              phaseName(e.phase), layerName(e.layer).c_str(), phaseName(e.phase), log->threadId,
+                              static_cast<double>(e.start - r.originTicks) * scale * 1e-3, static_cast<double>(e.duration) * scale * 1e-3,
+                              e.layer, static_cast<unsigned long long>(e.flops), static_cast<unsigned long long>(e.bytes));
+                file << event;
+            }
+        }
+
+        file << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+        if (!file)
+            throw std::runtime_error("Could not write trace file: " + path);
+    }
+
+    void Scope::begin(uint64_t Flops, uint64_t Bytes) {
+        Slot& entry = log->stats[index];
+
+        // This sample stands for the calls since the last one, itself included
+        weight = entry.interval - entry.countdown;
+        entry.totals.calls += weight;
+        entry.countdown = entry.interval = period.load(std::memory_order_relaxed);
+
+        flops = Flops;
+        bytes = Bytes;
+        allocationsAtStart = log->allocations;
+        start = ticks();
+    }
+
+    void Scope::end() {
+        // Read the clock before touching the totals so the bookkeeping stays out of the sample
+        uint64_t end = ticks();
+
+        Slot& entry = log->stats[index];
+        if (end - start >= LONG_CALL_TICKS)
+            entry.countdown = entry.interval = 1;
+
+        // Weighted by the calls the sample stands for; nanoseconds holds ticks until summary() converts it
+        PhaseStats& stats = entry.totals;
+        stats.sampledCalls++;
+        stats.nanoseconds += (end - start) * weight;
+        stats.flops += flops * weight;
+        stats.bytes += bytes * weight;
+        stats.allocations += (log->allocations - allocationsAtStart) * weight;
+
+        if (detail::tracing.load(std::memory_order_relaxed) && log->events.size() < maxEvents.load(std::memory_order_relaxed))
+            log->events.push_back({ stats.phase, stats.layer, start, end - start, flops, bytes });
+    }
+
+    void countAllocation() {
+        detail::threadLog().allocations++;
+    }
+
+}
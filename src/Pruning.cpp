@@ -0,0 +1,241 @@
+#include "bbdnn/Pruning.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace bbdnn {
+
+    namespace {
+
+        // The fp32 weights of a connection, widened from the 16-bit copy when the master was released
+        Matrix currentWeights(const LayerConnection& connection) {
+            return connection.hasMasterWeights() ? connection.getWeights() : connection.widenedWeights();
+        }
+
+        // Install new parameters, keeping the network's weight precision and whether it holds master weights
+        void replaceParameters(NeuralNetwork& network, std::vector<Matrix> weights, std::vector<Vector> biases) {
+            const LayerConnection& first = network.getConnections().front();
+            WeightPrecision precision = first.getWeightPrecision();
+            bool released = !first.hasMasterWeights();
+
+            network.updateParameters(std::move(weights), std::move(biases));
+            network.updateSparseWeights();
+
+            if (released)
+                network.setWeightPrecision(precision, false);
+        }
+
+        void countRemaining(const NeuralNetwork& network, PruningReport& report) {
+            for (const LayerConnection& connection : network.getConnections()) {
+                long total = connection.parameterCount() - connection.getBiases().size();
+                report.remainingWeights += static_cast<size_t>(std::lround(connection.density() * total));
+
+                if (connection.isSparse())
+                    report.sparseConnections++;
+            }
+        }
+
+        // Zero the weights of every connection below its threshold, given by thresholdOf(connection index, weights)
+        template <typename ThresholdFn>
+        PruningReport pruneBelow(NeuralNetwork& network, ThresholdFn thresholdOf) {
+            const std::vector<LayerConnection>& connections = network.getConnections();
+            std::vector<Matrix> weights;
+            std::vector<Vector> biases;
+            PruningReport report;
+
+            for (size_t l = 0; l < connections.size(); l++) {
+                Matrix w = currentWeights(connections[l]);
+                size_t zeroed = thresholdOf(l, w);
+
+                report.prunedWeights += zeroed;
+                weights.push_back(std::move(w));
+                biases.emplace_back(connections[l].getBiases());
+            }
+
+            replaceParameters(network, std::move(weights), std::move(biases));
+            countRemaining(network, report);
+
+            return report;
+        }
+
+    }
+
+    PruningReport pruneWeights(NeuralNetwork& network, float threshold) {
+        if (!(threshold >= 0.0f))
+            throw std::invalid_argument("Pruning threshold must be non-negative.");
+
+        return pruneBelow(network, [threshold](size_t, Matrix& w) {
+            size_t zeroed = 0;
+
+            for (int i = 0; i < w.size(); i++) {
+                float& value = w.rawData()[i];
+
+                if (value != 0.0f && std::fabs(value) < threshold) {
+                    value = 0.0f;
+                    zeroed++;
+                }
+            }
+
+            return zeroed;
+        });
+    }
+
+    PruningReport pruneToSparsity(NeuralNetwork& network, float sparsity) {
+        if (!(sparsity >= 0.0f && sparsity <= 1.0f))
+            throw std::invalid_argument("Sparsity must be in [0, 1].");
+
+        return pruneBelow(network, [sparsity](size_t, Matrix& w) {
+            size_t target = static_cast<size_t>(std::floor(sparsity * static_cast<float>(w.size())));
+            if (target == 0)
+                return size_t(0);
+
+            // Magnitude of the target-th smallest weight; everything below goes, then ties until target is reached
+            std::vector<float> magnitudes(w.size());
+            for (int i = 0; i < w.size(); i++)
+                magnitudes[i] = std::fabs(w.rawData()[i]);
+
+            std::nth_element(magnitudes.begin(), magnitudes.begin() + (target - 1), magnitudes.end());
+            float cutoff = magnitudes[target - 1];
+
+            size_t below = 0;
+            for (int i = 0; i < w.size(); i++)
+                if (std::fabs(w.rawData()[i]) < cutoff)
+                    below++;
+
+            size_t zeroed = 0;
+            size_t ties = target - below;
+
+            for (int i = 0; i < w.size(); i++) {
+                float& value = w.rawData()[i];
+                float magnitude = std::fabs(value);
+
+                if (magnitude < cutoff || (magnitude == cutoff && ties > 0)) {
+                    if (magnitude == cutoff)
+                        ties--;
+
+                    if (value != 0.0f)
+                        zeroed++;
+
+                    value = 0.0f;
+                }
+            }
+
+            return zeroed;
+        });
+    }
+
+    std::pair<NeuralNetwork, PruningReport> pruneNeurons(const NeuralNetwork& network, float threshold) {
+        if (!(threshold >= 0.0f))
+            throw std::invalid_argument("Pruning threshold must be non-negative.");
+
+        const std::vector<LayerConnection>& connections = network.getConnections();
+        std::vector<Matrix> weights;
+        std::vector<Vector> biases;
+
+        for (const LayerConnection& connection : connections) {
+            weights.push_back(currentWeights(connection));
+            biases.emplace_back(connection.getBiases());
+        }
+
+        PruningReport report;
+        std::vector<int> sizes { network.inputSize() };
+
+        // Hidden layer h sits between connection h - 1 (column j feeds neuron j) and connection h (row j leaves it)
+        for (int h = 1; h + 1 < network.size(); h++) {
+            Matrix& incoming = weights[h - 1];
+            Matrix& outgoing = weights[h];
+            int neurons = outgoing.Rows();
+            int nextNeurons = outgoing.Cols();
+
+            std::vector<float> norms(neurons, 0.0f);
+            std::vector<bool> constant(neurons, true);
+
+            for (int j = 0; j < neurons; j++) {
+                for (int o = 0; o < nextNeurons; o++)
+                    norms[j] += outgoing.at(j, o) * outgoing.at(j, o);
+
+                norms[j] = std::sqrt(norms[j]);
+
+                for (int i = 0; i < incoming.Rows() && constant[j]; i++)
+                    constant[j] = incoming.at(i, j) == 0.0f;
+            }
+
+            std::vector<int> kept;
+            for (int j = 0; j < neurons; j++)
+                if (norms[j] >= threshold && !constant[j])
+                    kept.push_back(j);
+
+            if (kept.empty())
+                kept.push_back(static_cast<int>(std::max_element(norms.begin(), norms.end()) - norms.begin()));
+
+            if (static_cast<int>(kept.size()) == neurons) {
+                sizes.push_back(neurons);
+                continue;
+            }
+
+            // A neuron with no inputs outputs f(b_j) for every example: fold f(b_j) * row j into the next biases
+            const IActivation& activation = *network.getLayer(h).getActivationFunction();
+            std::vector<bool> keep(neurons, false);
+            for (int j : kept)
+                keep[j] = true;
+
+            for (int j = 0; j < neurons; j++) {
+                if (keep[j] || !constant[j])
+                    continue;
+
+                float output;
+                activation.apply(&biases[h - 1][j], &output, 1);
+
+                for (int o = 0; o < nextNeurons; o++)
+                    biases[h][o] += output * outgoing.at(j, o);
+            }
+
+            int keptCount = static_cast<int>(kept.size());
+            Matrix shrunkIncoming(incoming.Rows(), keptCount);
+            Matrix shrunkOutgoing(keptCount, nextNeurons);
+            Vector shrunkBiases(keptCount);
+
+            for (int k = 0; k < keptCount; k++) {
+                int j = kept[k];
+
+                for (int i = 0; i < incoming.Rows(); i++)
+                    shrunkIncoming.at(i, k) = incoming.at(i, j);
+
+                std::copy(outgoing.rawData() + (long)j * nextNeurons, outgoing.rawData() + (long)(j + 1) * nextNeurons,
+                          shrunkOutgoing.rawData() + (long)k * nextNeurons);
+
+                shrunkBiases[k] = biases[h - 1][j];
+            }
+
+            report.prunedNeurons += neurons - keptCount;
+            report.prunedWeights += static_cast<size_t>(neurons - keptCount) * (incoming.Rows() + nextNeurons);
+
+            incoming = std::move(shrunkIncoming);
+            outgoing = std::move(shrunkOutgoing);
+            biases[h - 1] = std::move(shrunkBiases);
+            sizes.push_back(keptCount);
+        }
+
+        sizes.push_back(network.outputSize());
+
+        std::vector<DenseLayer> layers;
+        for (int l = 0; l < network.size(); l++)
+            layers.emplace_back(sizes[l], network.getLayer(l).getActivationFunction()->clone());
+
+        NeuralNetwork pruned(network.seed(), std::move(layers), false);
+        pruned.updateParameters(std::move(weights), std::move(biases));
+        pruned.updateSparseWeights();
+        pruned.setOptimizer(network.getOptimizer().clone());
+        pruned.setThreadCount(network.getThreadCount());
+
+        const LayerConnection& first = connections.front();
+        if (first.getWeightPrecision() != WeightPrecision::Float32)
+            pruned.setWeightPrecision(first.getWeightPrecision(), first.hasMasterWeights());
+
+        countRemaining(pruned, report);
+
+        return { std::move(pruned), report };
+    }
+
+}
@@ -0,0 +1,312 @@
+#include "bbdnn/Quantization.hpp"
+#include "bbdnn/Profiler.hpp"
+#include "bbdnn/Simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    namespace {
+
+        // gemvInt8 requires the dot product length to be a multiple of this
+        constexpr int INT8_ALIGNMENT = 64;
+
+        // Outputs rescaled, activated and requantized per pass, small enough to stay in L1
+        constexpr int REQUANTIZE_BLOCK = 64;
+
+        int padInt8(int size) {
+            return (size + INT8_ALIGNMENT - 1) / INT8_ALIGNMENT * INT8_ALIGNMENT;
+        }
+
+        int8_t quantizeValue(float value, float inverseScale) {
+            float scaled = std::clamp(value * inverseScale, -127.0f, 127.0f);
+            return static_cast<int8_t>(std::lrint(scaled));
+        }
+
+        // Symmetric scale mapping the chosen percentile of |values| to 127
+        float calibratedScale(std::vector<float>& magnitudes, float percentile) {
+            if (magnitudes.empty())
+                return 1.0f;
+
+            size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0f * static_cast<float>(magnitudes.size())));
+            rank = std::clamp<size_t>(rank, 1, magnitudes.size()) - 1;
+
+            std::nth_element(magnitudes.begin(), magnitudes.begin() + rank, magnitudes.end());
+            float range = magnitudes[rank];
+
+            return range > 0.0f ? range / 127.0f : 1.0f;
+        }
+
+    }
+
+    QuantizedNetwork QuantizedNetwork::quantize(const NeuralNetwork& network, const Dataset& calibration, const QuantizationOptions& options) {
+        if (calibration.empty())
+            throw std::invalid_argument("Calibration dataset must not be empty.");
+
+        if (calibration.featureSize() != network.inputSize())
+            throw std::invalid_argument("Calibration features must match the network's input size.");
+
+        if (!(options.percentile > 0.0f && options.percentile <= 100.0f))
+            throw std::invalid_argument("Calibration percentile must be in (0, 100].");
+
+        if (options.maxCalibrationRows == 0)
+            throw std::invalid_argument("At least one calibration row is needed.");
+
+        const std::vector<LayerConnection>& sourceConnections = network.getConnections();
+        size_t connectionCount = sourceConnections.size();
+
+        // Record |input| of every connection over the calibration rows with the fp32 network
+        size_t rows = std::min(calibration.size(), options.maxCalibrationRows);
+        std::vector<std::vector<float>> magnitudes(connectionCount);
+        std::vector<float> maxMagnitudes(connectionCount, 0.0f);
+        bool keepAll = options.percentile < 100.0f;
+
+        InferenceContext context = network.createInferenceContext();
+
+        for (size_t row = 0; row < rows; row++) {
+            context.setInput(VectorView(calibration.featureRow(row), network.inputSize()));
+            network.forwardPropogate(context);
+
+            for (size_t l = 0; l < connectionCount; l++) {
+                const Vector& input = context.activated[l];
+
+                for (int i = 0; i < input.size(); i++) {
+                    float magnitude = std::fabs(input[i]);
+                    maxMagnitudes[l] = std::max(maxMagnitudes[l], magnitude);
+
+                    if (keepAll)
+                        magnitudes[l].push_back(magnitude);
+                }
+            }
+        }
+
+        QuantizedNetwork quantized;
+        quantized.connections.resize(connectionCount);
+
+        for (size_t l = 0; l < connectionCount; l++) {
+            const LayerConnection& source = sourceConnections[l];
+            Matrix weights = source.hasMasterWeights() ? source.getWeights() : source.widenedWeights();
+            Connection& target = quantized.connections[l];
+
+            target.inputSize = weights.Rows();
+            target.outputSize = weights.Cols();
+            target.paddedInputSize = padInt8(target.inputSize);
+            target.activation = network.getLayer(static_cast<int>(l) + 1).getActivationFunction()->clone();
+
+            // Context buffers this wide hold every connection's padded input and its outputs
+            quantized.scratchSize = std::max<size_t>({ quantized.scratchSize, static_cast<size_t>(target.paddedInputSize),
+                                                       static_cast<size_t>(padInt8(target.outputSize)) });
+            quantized.accumulatorSize = std::max<size_t>(quantized.accumulatorSize, static_cast<size_t>(target.outputSize));
+
+            if (keepAll) {
+                target.inputScale = calibratedScale(magnitudes[l], options.percentile);
+                std::vector<float>().swap(magnitudes[l]);
+            }
+            else {
+                target.inputScale = maxMagnitudes[l] > 0.0f ? maxMagnitudes[l] / 127.0f : 1.0f;
+            }
+
+            VectorView biases = source.getBiases();
+            target.biases.assign(biases.rawData(), biases.rawData() + target.outputSize);
+
+            // Per-output symmetric scales, stored transposed so each output's weights are contiguous
+            target.weights.assign(static_cast<size_t>(target.outputSize) * target.paddedInputSize, 0);
+            target.outputScales.resize(target.outputSize);
+
+            for (int o = 0; o < target.outputSize; o++) {
+                float range = 0.0f;
+                for (int i = 0; i < target.inputSize; i++)
+                    range = std::max(range, std::fabs(weights.at(i, o)));
+
+                float weightScale = range > 0.0f ? range / 127.0f : 1.0f;
+                int8_t* row = target.weights.data() + static_cast<size_t>(o) * target.paddedInputSize;
+
+                for (int i = 0; i < target.inputSize; i++)
+                    row[i] = quantizeValue(weights.at(i, o), 1.0f / weightScale);
+
+                target.outputScales[o] = target.inputScale * weightScale;
+            }
+        }
+
+        return quantized;
+    }
+
+    const Vector& QuantizedNetwork::run(const float* input, QuantizedContext& context) const {
+        // Size a default-constructed context on first use; a smaller one from another network would overflow
+        if (context.current.empty())
+            context = createContext();
+        else if (context.current.size() < scratchSize || context.next.size() < scratchSize ||
+                 context.accumulators.size() < accumulatorSize || context.output.size() != outputSize())
+            throw std::invalid_argument("Quantized context does not match the network's layer sizes.");
+
+        const kernels::KernelTable& table = kernels::kernelTable();
+
+        const Connection& first = connections.front();
+        float inverseScale = 1.0f / first.inputScale;
+        for (int i = 0; i < first.inputSize; i++)
+            context.current[i] = quantizeValue(input[i], inverseScale);
+
+        float block[REQUANTIZE_BLOCK];
+
+        for (size_t l = 0; l < connections.size(); l++) {
+            BBDNN_PROFILE_LAYER(static_cast<int>(l));
+            const Connection& c = connections[l];
+            bool last = l + 1 == connections.size();
+
+            {
+                BBDNN_PROFILE_SCOPE(profiling::Phase::Forward, 2L * c.paddedInputSize * c.outputSize,
+                                    c.weights.size() + c.paddedInputSize + c.outputSize * sizeof(int32_t));
+
+                table.gemvInt8(context.current.data(), c.weights.data(), context.accumulators.data(),
+                               static_cast<size_t>(c.outputSize), static_cast<size_t>(c.paddedInputSize));
+            }
+
+            BBDNN_PROFILE_SCOPE(profiling::Phase::Activation, 3L * c.outputSize,
+                                c.outputSize * (3 * sizeof(float) + sizeof(int32_t) + sizeof(int8_t)));
+
+            // Rescale, add bias, activate and requantize a block at a time so the fp32 values never leave L1
+            float nextInverseScale = last ? 1.0f : 1.0f / connections[l + 1].inputScale;
+
+            for (int start = 0; start < c.outputSize; start += REQUANTIZE_BLOCK) {
+                int count = std::min(REQUANTIZE_BLOCK, c.outputSize - start);
+
+                for (int o = 0; o < count; o++)
+                    block[o] = static_cast<float>(context.accumulators[start + o]) * c.outputScales[start + o] + c.biases[start + o];
+
+                float* activated = last ? context.output.rawData() + start : block;
+                c.activation->apply(block, activated, static_cast<size_t>(count));
+
+                if (!last)
+                    for (int o = 0; o < count; o++)
+                        context.next[start + o] = quantizeValue(block[o], nextInverseScale);
+            }
+
+            if (!last)
+                std::swap(context.current, context.next);
+        }
+
+        return context.output;
+    }
+
+    Vector QuantizedNetwork::predict(const Vector& input) const {
+        QuantizedContext context = createContext();
+        return predict(input, context);
+    }
+
+    const Vector& QuantizedNetwork::predict(const Vector& input, QuantizedContext& context) const {
+        if (input.size() != inputSize())
+            throw std::invalid_argument("Input size must match the network's input size.");
+
+        return run(input.rawData(), context);
+    }
+
+    QuantizedContext QuantizedNetwork::createContext() const {
+        // Zero-filled, and the padding of each weight row is zero, so stale values past a layer's end add nothing
+        QuantizedContext context;
+        context.current.assign(scratchSize, 0);
+        context.next.assign(scratchSize, 0);
+        context.accumulators.assign(accumulatorSize, 0);
+        context.output = Vector(outputSize());
+
+        return context;
+    }
+
+    std::vector<float> QuantizedNetwork::evaluate(const Dataset& testData) const {
+        if (testData.empty())
+            throw std::invalid_argument("Test dataset must not be empty.");
+
+        if (testData.featureSize() != inputSize() || testData.labelSize() != outputSize())
+            throw std::invalid_argument("Dataset feature and label sizes must match the input and output layer sizes.");
+
+        QuantizedContext context = createContext();
+        std::vector<float> metrics;
+        metrics.reserve(testData.size());
+
+        for (size_t row = 0; row < testData.size(); row++) {
+            const Vector& output = run(testData.featureRow(row), context);
+            const float* label = testData.labelRow(row);
+
+            float ssr = 0.0f;
+            for (int i = 0; i < output.size(); i++)
+                ssr += (output[i] - label[i]) * (output[i] - label[i]);
+
+            metrics.push_back(ssr);
+        }
+
+        return metrics;
+    }
+
+    int QuantizedNetwork::size() const {
+        return static_cast<int>(connections.size());
+    }
+
+    int QuantizedNetwork::inputSize() const {
+        return connections.front().inputSize;
+    }
+
+    int QuantizedNetwork::outputSize() const {
+        return connections.back().outputSize;
+    }
+
+    float QuantizedNetwork::inputScale(int l) const {
+        if (l < 0 || l >= size())
+            throw std::invalid_argument("Connection index out of range.");
+
+        return connections[l].inputScale;
+    }
+
+    size_t QuantizedNetwork::memoryBytes() const {
+        size_t bytes = 0;
+
+        for (const Connection& c : connections)
+            bytes += c.weights.size() * sizeof(int8_t) + (c.outputScales.size() + c.biases.size() + 1) * sizeof(float);
+
+        return bytes;
+    }
+
+    QuantizationReport compareQuantized(const NeuralNetwork& network, const QuantizedNetwork& quantized, const Dataset& testData) {
+        if (testData.empty())
+            throw std::invalid_argument("Test dataset must not be empty.");
+
+        if (testData.featureSize() != network.inputSize() || testData.labelSize() != network.outputSize() ||
+            quantized.inputSize() != network.inputSize() || quantized.outputSize() != network.outputSize())
+            throw std::invalid_argument("Networks and dataset must agree on input and output sizes.");
+
+        InferenceContext fp32Context = network.createInferenceContext();
+        QuantizedContext int8Context = quantized.createContext();
+        Vector input(network.inputSize());
+
+        QuantizationReport report;
+        double fp32Loss = 0.0;
+        double int8Loss = 0.0;
+        double outputError = 0.0;
+
+        for (size_t row = 0; row < testData.size(); row++) {
+            std::copy(testData.featureRow(row), testData.featureRow(row) + network.inputSize(), input.rawData());
+
+            const Vector& expected = network.predict(input, fp32Context);
+            const Vector& actual = quantized.predict(input, int8Context);
+            const float* label = testData.labelRow(row);
+
+            for (int i = 0; i < expected.size(); i++) {
+                fp32Loss += (expected[i] - label[i]) * (expected[i] - label[i]);
+                int8Loss += (actual[i] - label[i]) * (actual[i] - label[i]);
+
+                float error = std::fabs(expected[i] - actual[i]);
+                report.maxOutputError = std::max(report.maxOutputError, error);
+                outputError += error;
+            }
+        }
+
+        report.samples = testData.size();
+        report.fp32MeanLoss = static_cast<float>(fp32Loss / static_cast<double>(report.samples));
+        report.int8MeanLoss = static_cast<float>(int8Loss / static_cast<double>(report.samples));
+        report.meanOutputError = static_cast<float>(outputError / (static_cast<double>(report.samples) * network.outputSize()));
+        report.fp32Bytes = static_cast<size_t>(network.parameterCount()) * sizeof(float);
+        report.int8Bytes = quantized.memoryBytes();
+
+        return report;
+    }
+
+}
@@ -0,0 +1,307 @@
+#include "bbdnn/Serialization.hpp"
+#include "MappedFile.hpp"
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    namespace {
+
+        constexpr char MODEL_MAGIC[8] = { 'B', 'B', 'D', 'N', 'N', 'M', 'D', 'L' };
+
+        struct ModelHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t layerCount;
+            uint64_t seed;
+            uint64_t fileSize;
+            char reserved[32];
+        };
+
+        struct LayerRecord {
+            int32_t size;
+            int32_t kind;
+            float p0;
+            float p1;
+        };
+
+        struct ConnectionRecord {
+            uint64_t weightsOffset;
+            uint64_t biasesOffset;
+        };
+
+        static_assert(sizeof(ModelHeader) == 64 && sizeof(LayerRecord) == 16 && sizeof(ConnectionRecord) == 16,
+                      "Model file records must have a fixed layout");
+
+        // Header, layer table and connection table as read from a model image
+        struct ModelImage {
+            ModelHeader header;
+            std::vector<LayerRecord> layers;
+            std::vector<ConnectionRecord> connections;
+        };
+
+        uint64_t alignBlob(uint64_t offset) {
+            return (offset + MODEL_BLOB_ALIGNMENT - 1) / MODEL_BLOB_ALIGNMENT * MODEL_BLOB_ALIGNMENT;
+        }
+
+        void requireLittleEndian() {
+            if constexpr (std::endian::native != std::endian::little)
+                throw std::runtime_error("Model files are only supported on little-endian hosts.");
+        }
+
+        LayerRecord describeLayer(const DenseLayer& layer) {
+            const IActivation& activation = *layer.getActivationFunction();
+            LayerRecord record { layer.size(), static_cast<int32_t>(activation.kind()), 0.0f, 0.0f };
+
+            switch (activation.kind()) {
+                case ActivationKind::Custom:
+                    throw std::invalid_argument("Layers with custom activations cannot be saved.");
+                case ActivationKind::LeakyReLU:
+                    record.p0 = static_cast<const LeakyReLUActivation&>(activation).alpha;
+                    break;
+                case ActivationKind::Logistic:
+                    record.p0 = static_cast<const LogisticActivation&>(activation).l;
+                    record.p1 = static_cast<const LogisticActivation&>(activation).k;
+                    break;
+                default:
+                    break;
+            }
+
+            return record;
+        }
+
+        ActivationPtr makeActivation(const LayerRecord& record) {
+            switch (static_cast<ActivationKind>(record.kind)) {
+                case ActivationKind::Linear: return Activation::Linear();
+                case ActivationKind::ReLU: return Activation::ReLU();
+                case ActivationKind::LeakyReLU: return Activation::LeakyReLU(record.p0);
+                case ActivationKind::Sigmoid: return Activation::Sigmoid();
+                case ActivationKind::Logistic: return Activation::Logistic(record.p0, record.p1);
+                case ActivationKind::Tanh: return Activation::Tanh();
+                default:
+                    throw std::invalid_argument("Model file contains an unknown activation kind.");
+            }
+        }
+
+        // Check that a blob of count floats at offset is aligned and inside the image
+        void requireBlob(uint64_t offset, uint64_t count, uint64_t size) {
+            if (offset % MODEL_BLOB_ALIGNMENT != 0)
+                throw std::invalid_argument("Model file blob is not 64-byte aligned.");
+
+            if (offset > size || count > (size - offset) / sizeof(float))
+                throw std::invalid_argument("Model file blob extends past the end of the file.");
+        }
+
+        ModelImage parseModel(const char* bytes, size_t size) {
+            requireLittleEndian();
+
+            ModelImage image;
+
+            if (size < sizeof(ModelHeader))
+                throw std::invalid_argument("Model file is too small to hold a header.");
+
+            std::memcpy(&image.header, bytes, sizeof(ModelHeader));
+
+            if (std::memcmp(image.header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0)
+                throw std::invalid_argument("File is not a bbdnn model.");
+
+            if (image.header.version != MODEL_FORMAT_VERSION)
+                throw std::invalid_argument("Unsupported model file version.");
+
+            if (image.header.fileSize != size)
+                throw std::invalid_argument("Model file size does not match its header.");
+
+            uint64_t layerCount = image.header.layerCount;
+            if (layerCount < 2 || layerCount > (size - sizeof(ModelHeader)) / (sizeof(LayerRecord) + sizeof(ConnectionRecord)))
+                throw std::invalid_argument("Model file has an invalid layer count.");
+
+            image.layers.resize(layerCount);
+            image.connections.resize(layerCount - 1);
+
+            const char* cursor = bytes + sizeof(ModelHeader);
+            std::memcpy(image.layers.data(), cursor, layerCount * sizeof(LayerRecord));
+            cursor += layerCount * sizeof(LayerRecord);
+            std::memcpy(image.connections.data(), cursor, (layerCount - 1) * sizeof(ConnectionRecord));
+
+            for (const LayerRecord& layer : image.layers)
+                if (layer.size <= 0)
+                    throw std::invalid_argument("Model file has a layer with no neurons.");
+
+            for (uint64_t l = 0; l + 1 < layerCount; l++) {
+                uint64_t inSize = static_cast<uint64_t>(image.layers[l].size);
+                uint64_t outSize = static_cast<uint64_t>(image.layers[l + 1].size);
+
+                requireBlob(image.connections[l].weightsOffset, inSize * outSize, size);
+                requireBlob(image.connections[l].biasesOffset, outSize, size);
+            }
+
+            return image;
+        }
+
+        NeuralNetwork buildNetwork(const ModelImage& image) {
+            std::vector<DenseLayer> layers;
+            layers.reserve(image.layers.size());
+
+            for (const LayerRecord& record : image.layers)
+                layers.emplace_back(record.size, makeActivation(record));
+
+            // Every parameter comes from the file, so skip the random initialization
+            return NeuralNetwork(static_cast<uint_fast32_t>(image.header.seed), std::move(layers), false);
+        }
+
+        std::vector<char> readFile(const std::string& path) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+                throw std::runtime_error("Could not open model file: " + path);
+
+            std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+
+            if (!file.read(bytes.data(), bytes.size()))
+                throw std::runtime_error("Could not read model file: " + path);
+
+            return bytes;
+        }
+
+    }
+
+    void saveModel(const NeuralNetwork& network, const std::string& path) {
+        requireLittleEndian();
+
+        int layerCount = network.size();
+
+        std::vector<LayerRecord> layers;
+        std::vector<ConnectionRecord> connections;
+        layers.reserve(layerCount);
+        connections.reserve(layerCount - 1);
+
+        for (int l = 0; l < layerCount; l++)
+            layers.push_back(describeLayer(network.getLayer(l)));
+
+        // Lay out the blobs after the tables, each on its own 64-byte boundary
+        uint64_t offset = sizeof(ModelHeader) + layerCount * sizeof(LayerRecord) + (layerCount - 1) * sizeof(ConnectionRecord);
+
+        for (int l = 0; l < layerCount - 1; l++) {
+            uint64_t inSize = network.getLayer(l).size();
+            uint64_t outSize = network.getLayer(l + 1).size();
+
+            ConnectionRecord record;
+            record.weightsOffset = alignBlob(offset);
+            offset = record.weightsOffset + inSize * outSize * sizeof(float);
+            record.biasesOffset = alignBlob(offset);
+            offset = record.biasesOffset + outSize * sizeof(float);
+
+            connections.push_back(record);
+        }
+
+        ModelHeader header {};
+        std::memcpy(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+        header.version = MODEL_FORMAT_VERSION;
+        header.layerCount = static_cast<uint32_t>(layerCount);
+        header.seed = network.seed();
+        header.fileSize = offset;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Could not open model file for writing: " + path);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(layers.data()), layers.size() * sizeof(LayerRecord));
+        file.write(reinterpret_cast<const char*>(connections.data()), connections.size() * sizeof(ConnectionRecord));
+
+        const char padding[MODEL_BLOB_ALIGNMENT] = {};
+        auto writeBlob = [&](uint64_t blobOffset, const float* values, int count) {
+            file.write(padding, static_cast<std::streamsize>(blobOffset - static_cast<uint64_t>(file.tellp())));
+            file.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count) * sizeof(float));
+        };
+
+        for (int l = 0; l < layerCount - 1; l++) {
+            const LayerConnection& connection = network.getConnections()[l];
+            // Inference-only connections save their 16-bit weights widened back to fp32
+            Matrix weights = connection.hasMasterWeights() ? connection.getWeights() : connection.widenedWeights();
+            VectorView biases = connection.getBiases();
+
+            writeBlob(connections[l].weightsOffset, weights.rawData(), weights.size());
+            writeBlob(connections[l].biasesOffset, biases.rawData(), biases.size());
+        }
+
+        if (!file)
+            throw std::runtime_error("Could not write model file: " + path);
+    }
+
+    NeuralNetwork loadModel(const std::string& path) {
+        std::vector<char> bytes = readFile(path);
+        ModelImage image = parseModel(bytes.data(), bytes.size());
+        NeuralNetwork network = buildNetwork(image);
+
+        std::vector<Matrix> weights;
+        std::vector<Vector> biases;
+
+        for (size_t l = 0; l < image.connections.size(); l++) {
+            int inSize = image.layers[l].size;
+            int outSize = image.layers[l + 1].size;
+
+            Matrix layerWeights(inSize, outSize);
+            Vector layerBiases(outSize);
+            std::memcpy(layerWeights.rawData(), bytes.data() + image.connections[l].weightsOffset, layerWeights.size() * sizeof(float));
+            std::memcpy(layerBiases.rawData(), bytes.data() + image.connections[l].biasesOffset, layerBiases.size() * sizeof(float));
+
+            weights.push_back(std::move(layerWeights));
+            biases.push_back(std::move(layerBiases));
+        }
+
+        network.updateParameters(std::move(weights), std::move(biases));
+
+        // The weights were just copied in, so measuring their density costs little next to reading the file
+        network.updateSparseWeights();
+
+        return network;
+    }
+
+    MappedModel::MappedModel(const std::string& path) {
+        io::MappedFile file = io::mapFile(path);
+        char* base = static_cast<char*>(file.data.get());
+
+        ModelImage image = parseModel(base, file.size);
+        model = std::make_unique<NeuralNetwork>(buildNetwork(image));
+
+        std::vector<Matrix> weights;
+        std::vector<Vector> biases;
+
+        for (size_t l = 0; l < image.connections.size(); l++) {
+            int inSize = image.layers[l].size;
+            int outSize = image.layers[l + 1].size;
+
+            float* weightData = reinterpret_cast<float*>(base + image.connections[l].weightsOffset);
+            float* biasData = reinterpret_cast<float*>(base + image.connections[l].biasesOffset);
+
+            weights.push_back(Matrix::borrow(inSize, outSize, weightData));
+            biases.push_back(Vector(Matrix::borrow(outSize, 1, biasData)));
+        }
+
+        model->updateParameters(std::move(weights), std::move(biases));
+        mapping = std::move(file.data);
+    }
+
+    MappedModel& MappedModel::operator=(MappedModel&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        // The network borrows the mapping, so it goes first
+        model = std::move(other.model);
+        mapping = std::move(other.mapping);
+
+        return *this;
+    }
+
+    NeuralNetwork& MappedModel::network() {
+        return *model;
+    }
+
+    const NeuralNetwork& MappedModel::network() const {
+        return *model;
+    }
+
+}
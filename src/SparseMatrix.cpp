@@ -0,0 +1,242 @@
+#include "bbdnn/SparseMatrix.hpp"
+#include "bbdnn/Gemm.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+namespace bbdnn {
+
+    namespace {
+
+        // Shape of the crossover probe: a square connection, and the batch size of the batched probe
+        constexpr int PROBE_SIZE = 512;
+        constexpr int PROBE_BATCH = 32;
+
+        // Densities probed, lowest first
+        constexpr float PROBE_DENSITIES[] = { 0.01f, 0.02f, 0.03f, 0.05f, 0.08f, 0.12f, 0.18f, 0.25f, 0.35f, 0.5f };
+
+        struct Crossover {
+            float single;
+            float batched;
+        };
+
+        // Current crossovers, changed by setCrossoverDensity and measureCrossoverDensity
+        std::atomic<float> singleCrossover { SPARSE_SINGLE_CROSSOVER };
+        std::atomic<float> batchedCrossover { SPARSE_BATCHED_CROSSOVER };
+
+        // Fastest of several timed runs, in seconds
+        template <typename Fn>
+        double fastestRun(Fn fn) {
+            fn();
+
+            double best = 1e30;
+            for (int run = 0; run < 7; run++) {
+                auto start = std::chrono::steady_clock::now();
+                fn();
+                best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            return best;
+        }
+
+        // Time the dense GEMM against multiplyAdd on random patterns of rising density. The crossover is the
+        // highest density reached before the sparse kernel first loses, so one noisy win cannot raise it
+        Crossover measureCrossover() {
+            std::mt19937 engine(7);
+            std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+            Matrix dense(PROBE_SIZE, PROBE_SIZE);
+            for (int i = 0; i < dense.size(); i++)
+                dense.rawData()[i] = value(engine);
+
+            Matrix inputs(PROBE_BATCH, PROBE_SIZE);
+            for (int i = 0; i < inputs.size(); i++)
+                inputs.rawData()[i] = value(engine);
+
+            Matrix outputs(PROBE_BATCH, PROBE_SIZE, 0.0f);
+
+            auto denseRun = [&](int batch) {
+                return fastestRun([&] {
+                    kernels::gemm(batch, PROBE_SIZE, PROBE_SIZE, 1.0f,
+                                  inputs.rawData(), PROBE_SIZE, 1,
+                                  dense.rawData(), PROBE_SIZE, 1,
+                                  1.0f, outputs.rawData(), PROBE_SIZE);
+                });
+            };
+
+            double denseSingle = denseRun(1);
+            double denseBatched = denseRun(PROBE_BATCH);
+
+            Crossover crossover { 0.0f, 0.0f };
+            bool singleWins = true;
+            bool batchedWins = true;
+
+            for (float density : PROBE_DENSITIES) {
+                Matrix pruned(PROBE_SIZE, PROBE_SIZE, 0.0f);
+                for (int i = 0; i < pruned.size(); i++)
+                    if (unit(engine) < density)
+                        pruned.rawData()[i] = dense.rawData()[i];
+
+                SparseMatrix sparse(pruned);
+
+                singleWins = singleWins && fastestRun([&] { sparse.multiplyAdd(inputs.rawData(), outputs.rawData()); }) < denseSingle;
+                batchedWins = batchedWins && fastestRun([&] {
+                    sparse.multiplyAdd(inputs.rawData(), PROBE_SIZE, outputs.rawData(), PROBE_SIZE, PROBE_BATCH);
+                }) < denseBatched;
+
+                if (singleWins)
+                    crossover.single = density;
+                if (batchedWins)
+                    crossover.batched = density;
+            }
+
+            return crossover;
+        }
+
+    }
+
+    SparseMatrix::SparseMatrix(const Matrix& dense) : rows(dense.Rows()), cols(dense.Cols()) {
+        rowStarts.reserve(rows + 1);
+        rowStarts.push_back(0);
+
+        for (int r = 0; r < rows; r++) {
+            const float* row = dense.rawData() + (long)r * cols;
+
+            for (int c = 0; c < cols; c++) {
+                if (row[c] != 0.0f) {
+                    columns.push_back(c);
+                    values.push_back(row[c]);
+                }
+            }
+
+            rowStarts.push_back(static_cast<int>(values.size()));
+        }
+    }
+
+    int SparseMatrix::Rows() const {
+        return rows;
+    }
+
+    int SparseMatrix::Cols() const {
+        return cols;
+    }
+
+    int SparseMatrix::nonZeros() const {
+        return static_cast<int>(values.size());
+    }
+
+    float SparseMatrix::density() const {
+        return rows * cols == 0 ? 0.0f : static_cast<float>(values.size()) / (static_cast<float>(rows) * cols);
+    }
+
+    bool SparseMatrix::empty() const {
+        return rows == 0;
+    }
+
+    Matrix SparseMatrix::toDense() const {
+        Matrix dense(rows, cols, 0.0f);
+
+        for (int r = 0; r < rows; r++)
+            for (int k = rowStarts[r]; k < rowStarts[r + 1]; k++)
+                dense.at(r, columns[k]) = values[k];
+
+        return dense;
+    }
+
+    void SparseMatrix::multiplyAdd(const float* x, float* y) const {
+        for (int r = 0; r < rows; r++) {
+            float xr = x[r];
+            if (xr == 0.0f)
+                continue;
+
+            // Columns within a row are distinct, so the scattered updates are independent
+            for (int k = rowStarts[r]; k < rowStarts[r + 1]; k++)
+                y[columns[k]] += xr * values[k];
+        }
+    }
+
+    void SparseMatrix::multiplyAdd(const float* X, int ldx, float* Y, int ldy, int batch) const {
+        int b = 0;
+
+        // Four batch rows share every index and value loaded
+        for (; b + 4 <= batch; b += 4) {
+            const float* x0 = X + (long)b * ldx;
+            const float* x1 = x0 + ldx;
+            const float* x2 = x1 + ldx;
+            const float* x3 = x2 + ldx;
+            float* y0 = Y + (long)b * ldy;
+            float* y1 = y0 + ldy;
+            float* y2 = y1 + ldy;
+            float* y3 = y2 + ldy;
+
+            for (int r = 0; r < rows; r++) {
+                float a0 = x0[r];
+                float a1 = x1[r];
+                float a2 = x2[r];
+                float a3 = x3[r];
+
+                if (a0 == 0.0f && a1 == 0.0f && a2 == 0.0f && a3 == 0.0f)
+                    continue;
+
+                for (int k = rowStarts[r]; k < rowStarts[r + 1]; k++) {
+                    int c = columns[k];
+                    float v = values[k];
+
+                    y0[c] += a0 * v;
+                    y1[c] += a1 * v;
+                    y2[c] += a2 * v;
+                    y3[c] += a3 * v;
+                }
+            }
+        }
+
+        for (; b < batch; b++)
+            multiplyAdd(X + (long)b * ldx, Y + (long)b * ldy);
+    }
+
+    void SparseMatrix::applyPattern(Matrix& dense) {
+        if (dense.Rows() != rows || dense.Cols() != cols)
+            throw std::invalid_argument("Dense matrix dimensions must match the sparse pattern.");
+
+        for (int r = 0; r < rows; r++) {
+            float* row = dense.rawData() + (long)r * cols;
+            int c = 0;
+
+            // Columns within a row are stored in ascending order
+            for (int k = rowStarts[r]; k < rowStarts[r + 1]; k++) {
+                for (; c < columns[k]; c++)
+                    row[c] = 0.0f;
+
+                values[k] = row[c++];
+            }
+
+            for (; c < cols; c++)
+                row[c] = 0.0f;
+        }
+    }
+
+    size_t SparseMatrix::memoryBytes() const {
+        return rowStarts.size() * sizeof(int) + columns.size() * sizeof(int) + values.size() * sizeof(float);
+    }
+
+    float SparseMatrix::crossoverDensity(int batchSize) {
+        return batchSize == 1 ? singleCrossover.load() : batchedCrossover.load();
+    }
+
+    void SparseMatrix::setCrossoverDensity(float single, float batched) {
+        if (!(single >= 0.0f && single <= 1.0f && batched >= 0.0f && batched <= 1.0f))
+            throw std::invalid_argument("Crossover densities must be in [0, 1].");
+
+        singleCrossover = single;
+        batchedCrossover = batched;
+    }
+
+    void SparseMatrix::measureCrossoverDensity() {
+        Crossover measured = measureCrossover();
+        setCrossoverDensity(measured.single, measured.batched);
+    }
+
+}
@@ -0,0 +1,93 @@
+#include "bbdnn/ThreadPool.hpp"
+#include <stdexcept>
+
+namespace bbdnn {
+
+    ThreadPool::ThreadPool(int threadCount) {
+        if (threadCount <= 0)
+            throw std::invalid_argument("Thread pool must have at least 1 thread.");
+
+        // The caller of run() works too, so only threadCount - 1 extra threads are needed
+        workers.reserve(threadCount - 1);
+        for (int i = 0; i < threadCount - 1; i++)
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        wake.notify_all();
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    void ThreadPool::runTasks() {
+        for (int i = nextTask++; i < jobCount; i = nextTask++) {
+            try {
+                (*job)(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure)
+                    failure = std::current_exception();
+            }
+        }
+    }
+
+    void ThreadPool::workerLoop() {
+        uint64_t seen = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+
+                if (stopping)
+                    return;
+
+                seen = generation;
+            }
+
+            runTasks();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyWorkers == 0)
+                finished.notify_one();
+        }
+    }
+
+    void ThreadPool::run(int taskCount, const std::function<void(int)>& task) {
+        if (taskCount <= 0)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &task;
+            jobCount = taskCount;
+            nextTask = 0;
+            busyWorkers = static_cast<int>(workers.size());
+            failure = nullptr;
+            generation++;
+        }
+
+        wake.notify_all();
+        runTasks();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return busyWorkers == 0; });
+
+        job = nullptr;
+
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+
+    int ThreadPool::size() const {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+}
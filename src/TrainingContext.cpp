@@ -0,0 +1,8 @@
+#include "bbdnn/TrainingContext.hpp"
+
+namespace bbdnn {
+
+    TrainingContext::TrainingContext(const std::vector<DenseLayer>& layers) : InferenceContext(layers), gradients(layers) {
+    }
+
+}
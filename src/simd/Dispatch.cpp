@@ -0,0 +1,72 @@
+#include "bbdnn/Simd.hpp"
+#include "KernelTables.hpp"
+#include <stdexcept>
+
+namespace bbdnn::kernels {
+
+    bool isSimdLevelAvailable(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::Scalar:
+                return true;
+#if defined(BBDNN_HAVE_X86_KERNELS)
+            case SimdLevel::SSE42:
+                return __builtin_cpu_supports("sse4.2");
+            case SimdLevel::AVX2:
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+            case SimdLevel::AVX512:
+                return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+                       __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+#endif
+#if defined(BBDNN_HAVE_NEON_KERNELS)
+            case SimdLevel::NEON:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    SimdLevel detectSimdLevel() {
+        for (SimdLevel level : { SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE42, SimdLevel::NEON })
+            if (isSimdLevelAvailable(level))
+                return level;
+
+        return SimdLevel::Scalar;
+    }
+
+    const char* simdLevelName(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::Scalar: return "scalar";
+            case SimdLevel::SSE42:  return "sse4.2";
+            case SimdLevel::AVX2:   return "avx2";
+            case SimdLevel::AVX512: return "avx512";
+            case SimdLevel::NEON:   return "neon";
+        }
+
+        return "unknown";
+    }
+
+    const KernelTable& kernelTable(SimdLevel level) {
+        if (!isSimdLevelAvailable(level))
+            throw std::invalid_argument("Requested SIMD level is not available on this build or CPU.");
+
+        switch (level) {
+#if defined(BBDNN_HAVE_X86_KERNELS)
+            case SimdLevel::SSE42:  return sse42KernelTable();
+            case SimdLevel::AVX2:   return avx2KernelTable();
+            case SimdLevel::AVX512: return avx512KernelTable();
+#endif
+#if defined(BBDNN_HAVE_NEON_KERNELS)
+            case SimdLevel::NEON:   return neonKernelTable();
+#endif
+            default:                return scalarKernelTable();
+        }
+    }
+
+    const KernelTable& kernelTable() {
+        // Resolved once; every later call is a single load of the cached reference
+        static const KernelTable& active = kernelTable(detectSimdLevel());
+        return active;
+    }
+
+}
@@ -0,0 +1,841 @@
+#ifndef KERNEL_IMPL_HPP
+#define KERNEL_IMPL_HPP
+
+// Kernel bodies written once against the register wrappers in SimdTypes.hpp. Each per-ISA
+// translation unit instantiates them with its own wrapper; the anonymous namespace keeps every
+// instantiation local to the unit compiled with the matching target flags.
+
+#include "bbdnn/Simd.hpp"
+#include "SimdTypes.hpp"
+#include "KernelImplInt8.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace bbdnn::kernels {
+
+    namespace {
+
+        /// Accumulator lanes used by sum(), fixed so every ISA rounds identically.
+        constexpr int SUM_LANES = 16;
+
+        template <typename V>
+        void addKernel(const float* a, const float* b, float* out, size_t n) {
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width)
+                V::store(out + i, V::add(V::load(a + i), V::load(b + i)));
+            for (; i < n; i++)
+                out[i] = a[i] + b[i];
+        }
+
+        template <typename V>
+        void subKernel(const float* a, const float* b, float* out, size_t n) {
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width)
+                V::store(out + i, V::sub(V::load(a + i), V::load(b + i)));
+            for (; i < n; i++)
+                out[i] = a[i] - b[i];
+        }
+
+        template <typename V>
+        void mulKernel(const float* a, const float* b, float* out, size_t n) {
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width)
+                V::store(out + i, V::mul(V::load(a + i), V::load(b + i)));
+            for (; i < n; i++)
+                out[i] = a[i] * b[i];
+        }
+
+        template <typename V>
+        void scaleKernel(const float* a, float s, float* out, size_t n) {
+            typename V::Reg scalar = V::set1(s);
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width)
+                V::store(out + i, V::mul(V::load(a + i), scalar));
+            for (; i < n; i++)
+                out[i] = a[i] * s;
+        }
+
+        template <typename V>
+        void divideKernel(const float* a, float s, float* out, size_t n) {
+            typename V::Reg scalar = V::set1(s);
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width)
+                V::store(out + i, V::div(V::load(a + i), scalar));
+            for (; i < n; i++)
+                out[i] = a[i] / s;
+        }
+
+        template <typename V>
+        void axpyKernel(float a, const float* x, float* y, size_t n) {
+            typename V::Reg scalar = V::set1(a);
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width)
+                V::store(y + i, V::fmadd(scalar, V::load(x + i), V::load(y + i)));
+            for (; i < n; i++)
+                y[i] += a * x[i];
+        }
+
+        // Lane l accumulates every element with index = l (mod 16), the tail is folded into the
+        // first lanes, and the lanes are combined by a fixed pairwise tree. The rounding sequence is
+        // therefore the same for every register width.
+        template <typename V>
+        float sumKernel(const float* a, size_t n) {
+            constexpr int regs = SUM_LANES / V::width;
+
+            typename V::Reg acc[regs];
+            for (int r = 0; r < regs; r++)
+                acc[r] = V::zero();
+
+            size_t i = 0;
+            for (; i + SUM_LANES <= n; i += SUM_LANES)
+                for (int r = 0; r < regs; r++)
+                    acc[r] = V::add(acc[r], V::load(a + i + r * V::width));
+
+            float lanes[SUM_LANES];
+            for (int r = 0; r < regs; r++)
+                V::store(lanes + r * V::width, acc[r]);
+
+            for (size_t t = 0; i + t < n; t++)
+                lanes[t] += a[i + t];
+
+            for (int stride = SUM_LANES / 2; stride > 0; stride /= 2)
+                for (int l = 0; l < stride; l++)
+                    lanes[l] += lanes[l + stride];
+
+            return lanes[0];
+        }
+
+        // exp(x): n = round(x / ln2), r = x - n ln2 in two Cody-Waite steps, e^r from the Cephes degree-6
+        // polynomial, then scaled by 2^n through the exponent bits. The polynomial runs on x clamped so 2^n
+        // stays normal; outside that range the result is 0 or +inf, and NaN passes through
+        template <typename V>
+        typename V::Reg expApprox(typename V::Reg x) {
+            using Reg = typename V::Reg;
+
+            Reg low = V::set1(-87.3f);
+            Reg high = V::set1(88.0f);
+            Reg input = x;
+            x = V::min(V::max(x, low), high);
+
+            Reg n = V::floor(V::fmadd(x, V::set1(1.44269504088896341f), V::set1(0.5f)));
+            Reg r = V::sub(x, V::mul(n, V::set1(0.693359375f)));
+            r = V::sub(r, V::mul(n, V::set1(-2.12194440e-4f)));
+
+            Reg p = V::set1(1.9875691500e-4f);
+            p = V::fmadd(p, r, V::set1(1.3981999507e-3f));
+            p = V::fmadd(p, r, V::set1(8.3334519073e-3f));
+            p = V::fmadd(p, r, V::set1(4.1665795894e-2f));
+            p = V::fmadd(p, r, V::set1(1.6666665459e-1f));
+            p = V::fmadd(p, r, V::set1(5.0000001201e-1f));
+            p = V::fmadd(p, V::mul(r, r), r);
+            p = V::add(p, V::set1(1.0f));
+
+            Reg result = V::mul(p, V::pow2i(n));
+
+            // Both comparisons are false for NaN, which lands in the last select
+            Reg inRange = V::select(V::greater(input, high), V::set1(std::numeric_limits<float>::infinity()), result);
+            Reg belowRange = V::select(V::greater(high, input), V::zero(), input);
+            return V::select(V::greater(input, low), inRange, belowRange);
+        }
+
+        // tanh(x): the Cephes odd polynomial below |x| = 0.625, where 1 - 2 / (e^2|x| + 1) would cancel,
+        // and the exp form with the sign restored above it
+        template <typename V>
+        typename V::Reg tanhApprox(typename V::Reg x) {
+            using Reg = typename V::Reg;
+
+            Reg ax = V::abs(x);
+            Reg one = V::set1(1.0f);
+
+            Reg e = expApprox<V>(V::add(ax, ax));
+            Reg large = V::sub(one, V::div(V::set1(2.0f), V::add(e, one)));
+            large = V::select(V::greater(V::zero(), x), V::sub(V::zero(), large), large);
+
+            Reg x2 = V::mul(x, x);
+            Reg p = V::set1(-5.70498872745e-3f);
+            p = V::fmadd(p, x2, V::set1(2.06390887954e-2f));
+            p = V::fmadd(p, x2, V::set1(-5.37397155531e-2f));
+            p = V::fmadd(p, x2, V::set1(1.33314422036e-1f));
+            p = V::fmadd(p, x2, V::set1(-3.33332819422e-1f));
+            Reg small = V::fmadd(V::mul(p, x2), x, x);
+
+            return V::select(V::greater(V::set1(0.625f), ax), small, large);
+        }
+
+        // l / (1 + e^(-k x)); the sigmoid is l = k = 1
+        template <typename V>
+        typename V::Reg logisticApprox(typename V::Reg x, float l, float k) {
+            typename V::Reg e = expApprox<V>(V::mul(x, V::set1(-k)));
+            return V::div(V::set1(l), V::add(V::set1(1.0f), e));
+        }
+
+        // Apply op register by register; the ragged tail goes through a padded buffer so it sees the same math
+        template <typename V, typename Op>
+        void mapKernel(const float* in, float* out, size_t n, Op op) {
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width)
+                V::store(out + i, op(V::load(in + i)));
+
+            if (i == n)
+                return;
+
+            float buffer[V::width] = {};
+            for (size_t t = 0; i + t < n; t++)
+                buffer[t] = in[i + t];
+
+            V::store(buffer, op(V::load(buffer)));
+
+            for (size_t t = 0; i + t < n; t++)
+                out[i + t] = buffer[t];
+        }
+
+        template <typename V>
+        void activateKernel(ActivationKind kind, float p0, float p1, const float* in, float* out, size_t n) {
+            using Reg = typename V::Reg;
+
+            switch (kind) {
+                case ActivationKind::ReLU:
+                    mapKernel<V>(in, out, n, [](Reg x) { return V::max(x, V::zero()); });
+                    break;
+                case ActivationKind::LeakyReLU:
+                    mapKernel<V>(in, out, n, [p0](Reg x) {
+                        return V::select(V::greater(x, V::zero()), x, V::mul(x, V::set1(p0)));
+                    });
+                    break;
+                case ActivationKind::Sigmoid:
+                    mapKernel<V>(in, out, n, [](Reg x) { return logisticApprox<V>(x, 1.0f, 1.0f); });
+                    break;
+                case ActivationKind::Logistic:
+                    mapKernel<V>(in, out, n, [p0, p1](Reg x) { return logisticApprox<V>(x, p0, p1); });
+                    break;
+                case ActivationKind::Tanh:
+                    mapKernel<V>(in, out, n, [](Reg x) { return tanhApprox<V>(x); });
+                    break;
+                default: // Linear
+                    if (in != out)
+                        for (size_t i = 0; i < n; i++)
+                            out[i] = in[i];
+                    break;
+            }
+        }
+
+        template <typename V>
+        void activateDerivativeKernel(ActivationKind kind, float p0, float p1, const float* in, float* out, size_t n) {
+            using Reg = typename V::Reg;
+
+            switch (kind) {
+                case ActivationKind::ReLU:
+                    mapKernel<V>(in, out, n, [](Reg x) {
+                        return V::select(V::greater(x, V::zero()), V::set1(1.0f), V::zero());
+                    });
+                    break;
+                case ActivationKind::LeakyReLU:
+                    mapKernel<V>(in, out, n, [p0](Reg x) {
+                        return V::select(V::greater(x, V::zero()), V::set1(1.0f), V::set1(p0));
+                    });
+                    break;
+                case ActivationKind::Sigmoid:
+                    mapKernel<V>(in, out, n, [](Reg x) {
+                        Reg s = logisticApprox<V>(x, 1.0f, 1.0f);
+                        return V::mul(s, V::sub(V::set1(1.0f), s));
+                    });
+                    break;
+                case ActivationKind::Logistic:
+                    // Mirrors LogisticActivation::derive (v * (1 - v)) so the scalar and span paths agree
+                    mapKernel<V>(in, out, n, [p0, p1](Reg x) {
+                        Reg v = logisticApprox<V>(x, p0, p1);
+                        return V::mul(v, V::sub(V::set1(1.0f), v));
+                    });
+                    break;
+                case ActivationKind::Tanh:
+                    mapKernel<V>(in, out, n, [](Reg x) {
+                        Reg t = tanhApprox<V>(x);
+                        return V::sub(V::set1(1.0f), V::mul(t, t));
+                    });
+                    break;
+                default: // Linear
+                    for (size_t i = 0; i < n; i++)
+                        out[i] = 1.0f;
+                    break;
+            }
+        }
+
+        // Run op over parameters, gradients and up to two state buffers register by register. The tail goes
+        // through padded buffers so it sees the same math; null state buffers are never read or written.
+        template <typename V, typename Op>
+        void updateKernel(float* params, const float* grads, float* state0, float* state1, size_t n, Op op) {
+            using Reg = typename V::Reg;
+
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width) {
+                Reg w = V::load(params + i);
+                Reg s0 = state0 ? V::load(state0 + i) : V::zero();
+                Reg s1 = state1 ? V::load(state1 + i) : V::zero();
+
+                op(w, V::load(grads + i), s0, s1);
+
+                V::store(params + i, w);
+                if (state0)
+                    V::store(state0 + i, s0);
+                if (state1)
+                    V::store(state1 + i, s1);
+            }
+
+            if (i == n)
+                return;
+
+            float w[V::width] = {};
+            float g[V::width] = {};
+            float s0[V::width] = {};
+            float s1[V::width] = {};
+
+            for (size_t t = 0; i + t < n; t++) {
+                w[t] = params[i + t];
+                g[t] = grads[i + t];
+                s0[t] = state0 ? state0[i + t] : 0.0f;
+                s1[t] = state1 ? state1[i + t] : 0.0f;
+            }
+
+            Reg wr = V::load(w);
+            Reg s0r = V::load(s0);
+            Reg s1r = V::load(s1);
+            op(wr, V::load(g), s0r, s1r);
+            V::store(w, wr);
+            V::store(s0, s0r);
+            V::store(s1, s1r);
+
+            for (size_t t = 0; i + t < n; t++) {
+                params[i + t] = w[t];
+                if (state0)
+                    state0[i + t] = s0[t];
+                if (state1)
+                    state1[i + t] = s1[t];
+            }
+        }
+
+        template <typename V>
+        void optimizeKernel(OptimizerKind kind, const OptimizerStep& step, float* params, const float* grads, float* state0, float* state1, size_t n) {
+            using Reg = typename V::Reg;
+
+            Reg negativeRate = V::set1(-step.learningRate);
+            Reg decay1 = V::set1(step.decay1);
+            Reg decay2 = V::set1(step.decay2);
+            Reg oneMinusDecay1 = V::set1(1.0f - step.decay1);
+            Reg oneMinusDecay2 = V::set1(1.0f - step.decay2);
+            Reg epsilon = V::set1(step.epsilon);
+
+            switch (kind) {
+                case OptimizerKind::Momentum:
+                    // v = mu v + g; w -= lr v
+                    updateKernel<V>(params, grads, state0, nullptr, n, [&](Reg& w, Reg g, Reg& v, Reg&) {
+                        v = V::fmadd(decay1, v, g);
+                        w = V::fmadd(negativeRate, v, w);
+                    });
+                    break;
+                case OptimizerKind::Nesterov:
+                    // v = mu v + g; w -= lr (g + mu v)
+                    updateKernel<V>(params, grads, state0, nullptr, n, [&](Reg& w, Reg g, Reg& v, Reg&) {
+                        v = V::fmadd(decay1, v, g);
+                        w = V::fmadd(negativeRate, V::fmadd(decay1, v, g), w);
+                    });
+                    break;
+                case OptimizerKind::RMSProp:
+                    // s = rho s + (1 - rho) g^2; w -= lr g / (sqrt(s) + eps)
+                    updateKernel<V>(params, grads, state0, nullptr, n, [&](Reg& w, Reg g, Reg& s, Reg&) {
+                        s = V::fmadd(decay1, s, V::mul(oneMinusDecay1, V::mul(g, g)));
+                        w = V::fmadd(negativeRate, V::div(g, V::add(V::sqrt(s), epsilon)), w);
+                    });
+                    break;
+                case OptimizerKind::Adam:
+                case OptimizerKind::AdamW: {
+                    // m = b1 m + (1 - b1) g; v = b2 v + (1 - b2) g^2;
+                    // w -= lr (m c1 / (sqrt(v c2) + eps) + lambda w), lambda = 0 for Adam
+                    Reg correction1 = V::set1(step.correction1);
+                    Reg correction2 = V::set1(step.correction2);
+                    Reg weightDecay = V::set1(step.weightDecay);
+
+                    updateKernel<V>(params, grads, state0, state1, n, [&](Reg& w, Reg g, Reg& m, Reg& v) {
+                        m = V::fmadd(decay1, m, V::mul(oneMinusDecay1, g));
+                        v = V::fmadd(decay2, v, V::mul(oneMinusDecay2, V::mul(g, g)));
+
+                        Reg denominator = V::add(V::sqrt(V::mul(v, correction2)), epsilon);
+                        Reg direction = V::fmadd(weightDecay, w, V::div(V::mul(m, correction1), denominator));
+                        w = V::fmadd(negativeRate, direction, w);
+                    });
+                    break;
+                }
+                default: // SGD
+                    updateKernel<V>(params, grads, nullptr, nullptr, n, [&](Reg& w, Reg g, Reg&, Reg&) {
+                        w = V::fmadd(negativeRate, g, w);
+                    });
+                    break;
+            }
+        }
+
+        // ---- 16-bit weights ----
+
+        template <typename V, WeightPrecision P>
+        typename V::Reg loadWeights(const uint16_t* p) {
+            if constexpr (P == WeightPrecision::BFloat16)
+                return V::loadBFloat16(p);
+            else
+                return V::loadHalf(p);
+        }
+
+        template <WeightPrecision P>
+        float widenValue(uint16_t value) {
+            if constexpr (P == WeightPrecision::BFloat16)
+                return bfloat16ToFloat(value);
+            else
+                return halfToFloat(value);
+        }
+
+        template <typename V, WeightPrecision P>
+        void widenKernel(const uint16_t* in, float* out, size_t n) {
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width)
+                V::store(out + i, loadWeights<V, P>(in + i));
+            for (; i < n; i++)
+                out[i] = widenValue<P>(in[i]);
+        }
+
+        template <typename V, WeightPrecision P>
+        void narrowKernel(const float* in, uint16_t* out, size_t n) {
+            size_t i = 0;
+            for (; i + V::width <= n; i += V::width) {
+                if constexpr (P == WeightPrecision::BFloat16)
+                    V::storeBFloat16(out + i, V::load(in + i));
+                else
+                    V::storeHalf(out + i, V::load(in + i));
+            }
+            for (; i < n; i++)
+                out[i] = P == WeightPrecision::BFloat16 ? floatToBFloat16(in[i]) : floatToHalf(in[i]);
+        }
+
+        // y += x^T W for a rows x n row-major W, four rows per pass over y so each load and store of y
+        // is shared by four widening multiply-adds
+        template <typename V, WeightPrecision P>
+        void gemvWidenKernel(const float* x, const uint16_t* w, float* y, size_t rows, size_t n) {
+            size_t r = 0;
+
+            for (; r + 4 <= rows; r += 4) {
+                const uint16_t* w0 = w + r * n;
+                const uint16_t* w1 = w0 + n;
+                const uint16_t* w2 = w1 + n;
+                const uint16_t* w3 = w2 + n;
+                typename V::Reg x0 = V::set1(x[r]);
+                typename V::Reg x1 = V::set1(x[r + 1]);
+                typename V::Reg x2 = V::set1(x[r + 2]);
+                typename V::Reg x3 = V::set1(x[r + 3]);
+
+                size_t j = 0;
+                for (; j + V::width <= n; j += V::width) {
+                    typename V::Reg acc = V::load(y + j);
+                    acc = V::fmadd(x0, loadWeights<V, P>(w0 + j), acc);
+                    acc = V::fmadd(x1, loadWeights<V, P>(w1 + j), acc);
+                    acc = V::fmadd(x2, loadWeights<V, P>(w2 + j), acc);
+                    acc = V::fmadd(x3, loadWeights<V, P>(w3 + j), acc);
+                    V::store(y + j, acc);
+                }
+                for (; j < n; j++) {
+                    float acc = y[j];
+                    acc += x[r] * widenValue<P>(w0[j]);
+                    acc += x[r + 1] * widenValue<P>(w1[j]);
+                    acc += x[r + 2] * widenValue<P>(w2[j]);
+                    acc += x[r + 3] * widenValue<P>(w3[j]);
+                    y[j] = acc;
+                }
+            }
+
+            for (; r < rows; r++) {
+                const uint16_t* row = w + r * n;
+                typename V::Reg xr = V::set1(x[r]);
+
+                size_t j = 0;
+                for (; j + V::width <= n; j += V::width)
+                    V::store(y + j, V::fmadd(xr, loadWeights<V, P>(row + j), V::load(y + j)));
+                for (; j < n; j++)
+                    y[j] += x[r] * widenValue<P>(row[j]);
+            }
+        }
+
+        // Sum of a register's lanes
+        template <typename V>
+        float laneSum(typename V::Reg v) {
+            alignas(64) float lanes[V::width];
+            V::store(lanes, v);
+
+            float total = 0.0f;
+            for (int i = 0; i < V::width; i++)
+                total += lanes[i];
+
+            return total;
+        }
+
+        // y[r] += dot(w + r * stride, x) over n values, four rows per pass so each load of x feeds four rows
+        template <typename V>
+        void gemvRowsKernel(const float* x, const float* w, size_t stride, float* y, size_t rows, size_t n) {
+            size_t r = 0;
+
+            for (; r + 4 <= rows; r += 4) {
+                const float* w0 = w + r * stride;
+                const float* w1 = w0 + stride;
+                const float* w2 = w1 + stride;
+                const float* w3 = w2 + stride;
+                typename V::Reg acc0 = V::zero();
+                typename V::Reg acc1 = V::zero();
+                typename V::Reg acc2 = V::zero();
+                typename V::Reg acc3 = V::zero();
+
+                size_t i = 0;
+                for (; i + V::width <= n; i += V::width) {
+                    typename V::Reg xv = V::load(x + i);
+                    acc0 = V::fmadd(xv, V::load(w0 + i), acc0);
+                    acc1 = V::fmadd(xv, V::load(w1 + i), acc1);
+                    acc2 = V::fmadd(xv, V::load(w2 + i), acc2);
+                    acc3 = V::fmadd(xv, V::load(w3 + i), acc3);
+                }
+
+                float s0 = laneSum<V>(acc0);
+                float s1 = laneSum<V>(acc1);
+                float s2 = laneSum<V>(acc2);
+                float s3 = laneSum<V>(acc3);
+                for (; i < n; i++) {
+                    s0 += x[i] * w0[i];
+                    s1 += x[i] * w1[i];
+                    s2 += x[i] * w2[i];
+                    s3 += x[i] * w3[i];
+                }
+
+                y[r] += s0;
+                y[r + 1] += s1;
+                y[r + 2] += s2;
+                y[r + 3] += s3;
+            }
+
+            for (; r < rows; r++) {
+                const float* row = w + r * stride;
+                typename V::Reg acc = V::zero();
+
+                size_t i = 0;
+                for (; i + V::width <= n; i += V::width)
+                    acc = V::fmadd(V::load(x + i), V::load(row + i), acc);
+
+                float s = laneSum<V>(acc);
+                for (; i < n; i++)
+                    s += x[i] * row[i];
+
+                y[r] += s;
+            }
+        }
+
+        // x^T times one panel of four registers' width of columns (see KernelTable::gemvPanels), left in sums.
+        // The outputs stay in registers for the whole pass over x; even and odd rows feed separate
+        // accumulators so consecutive multiply-adds do not wait on each other
+        template <typename V>
+        void panelSums(const float* x, const float* panel, size_t rows, typename V::Reg (&sums)[4]) {
+            constexpr size_t W = V::width;
+            constexpr size_t P = 4 * W;
+
+            typename V::Reg even[4] = { V::zero(), V::zero(), V::zero(), V::zero() };
+            typename V::Reg odd[4] = { V::zero(), V::zero(), V::zero(), V::zero() };
+
+            size_t i = 0;
+            for (; i + 2 <= rows; i += 2) {
+                const float* p0 = panel + i * P;
+                const float* p1 = p0 + P;
+                typename V::Reg x0 = V::set1(x[i]);
+                typename V::Reg x1 = V::set1(x[i + 1]);
+
+                for (size_t k = 0; k < 4; k++) {
+                    even[k] = V::fmadd(x0, V::load(p0 + k * W), even[k]);
+                    odd[k] = V::fmadd(x1, V::load(p1 + k * W), odd[k]);
+                }
+            }
+
+            if (i < rows) {
+                const float* p0 = panel + i * P;
+                typename V::Reg x0 = V::set1(x[i]);
+
+                for (size_t k = 0; k < 4; k++)
+                    even[k] = V::fmadd(x0, V::load(p0 + k * W), even[k]);
+            }
+
+            for (size_t k = 0; k < 4; k++)
+                sums[k] = V::add(even[k], odd[k]);
+        }
+
+        template <typename V>
+        void gemvPanelsKernel(const float* x, const float* panels, float* y, size_t rows, size_t n) {
+            constexpr size_t W = V::width;
+            constexpr size_t P = 4 * W;
+
+            for (size_t first = 0; first < n; first += P) {
+                typename V::Reg sums[4];
+                panelSums<V>(x, panels + first * rows, rows, sums);
+
+                if (n - first >= P) {
+                    for (size_t k = 0; k < 4; k++)
+                        V::store(y + first + k * W, V::add(V::load(y + first + k * W), sums[k]));
+                }
+                else {
+                    // Last panel: its padding columns are zero, but y ends at n
+                    alignas(64) float tail[P];
+                    for (size_t k = 0; k < 4; k++)
+                        V::store(tail + k * W, sums[k]);
+
+                    for (size_t c = 0; first + c < n; c++)
+                        y[first + c] += tail[c];
+                }
+            }
+        }
+
+        // f(x) on one register for a built-in activation, with the same math as activateKernel
+        template <typename V>
+        typename V::Reg activateRegister(ActivationKind kind, float p0, float p1, typename V::Reg x) {
+            switch (kind) {
+                case ActivationKind::ReLU:
+                    return V::max(x, V::zero());
+                case ActivationKind::LeakyReLU:
+                    return V::select(V::greater(x, V::zero()), x, V::mul(x, V::set1(p0)));
+                case ActivationKind::Sigmoid:
+                    return logisticApprox<V>(x, 1.0f, 1.0f);
+                case ActivationKind::Logistic:
+                    return logisticApprox<V>(x, p0, p1);
+                case ActivationKind::Tanh:
+                    return tanhApprox<V>(x);
+                default: // Linear
+                    return x;
+            }
+        }
+
+        // z = x^T W + b and a = f(z) for W packed as for gemvPanels: bias, store and activation run on each
+        // panel's sums while they are still in registers. z may be null
+        template <typename V>
+        void denseForwardKernel(ActivationKind kind, float p0, float p1, const float* x, const float* panels, const float* bias,
+                                float* z, float* a, size_t rows, size_t n) {
+            constexpr size_t W = V::width;
+            constexpr size_t P = 4 * W;
+
+            for (size_t first = 0; first < n; first += P) {
+                typename V::Reg sums[4];
+                panelSums<V>(x, panels + first * rows, rows, sums);
+
+                if (n - first >= P) {
+                    for (size_t k = 0; k < 4; k++) {
+                        typename V::Reg pre = V::add(sums[k], V::load(bias + first + k * W));
+
+                        if (z)
+                            V::store(z + first + k * W, pre);
+
+                        V::store(a + first + k * W, activateRegister<V>(kind, p0, p1, pre));
+                    }
+                }
+                else {
+                    // Last panel: pad the bias with zeros and copy out only the columns before n
+                    size_t count = n - first;
+                    alignas(64) float pre[P] = {};
+                    alignas(64) float post[P];
+
+                    for (size_t c = 0; c < count; c++)
+                        pre[c] = bias[first + c];
+
+                    for (size_t k = 0; k < 4; k++) {
+                        typename V::Reg value = V::add(sums[k], V::load(pre + k * W));
+                        V::store(pre + k * W, value);
+                        V::store(post + k * W, activateRegister<V>(kind, p0, p1, value));
+                    }
+
+                    for (size_t c = 0; c < count; c++) {
+                        if (z)
+                            z[first + c] = pre[c];
+
+                        a[first + c] = post[c];
+                    }
+                }
+            }
+        }
+
+        /// Columns of W swept per tile of the fused backward kernel: four rows of W and of the gradient take 8 KB.
+        constexpr size_t BACKWARD_TILE = 256;
+        /// Row length from which a single example's backward pass goes one row at a time.
+        constexpr size_t BACKWARD_SINGLE_ROW = 128;
+
+        // One example against count columns of R rows, starting at column first: sums[k] = dot(w_k, d) when
+        // Sensitivity is set, and g_k += xv[k] * d, or = when Overwrite is set so g is never read first
+        template <typename V, size_t R, bool Overwrite, bool Sensitivity>
+        void backwardExample(const float* d, const float* w, const float (&xv)[R], float* gradient,
+                             size_t n, size_t first, size_t count, float (&sums)[R]) {
+            typename V::Reg xs[R];
+            typename V::Reg acc[R];
+
+            for (size_t k = 0; k < R; k++) {
+                xs[k] = V::set1(xv[k]);
+                acc[k] = V::zero();
+            }
+
+            size_t c = 0;
+            for (; c + V::width <= count; c += V::width) {
+                typename V::Reg dv = V::load(d + c);
+
+                for (size_t k = 0; k < R; k++) {
+                    float* g = gradient + k * n + first + c;
+
+                    if constexpr (Sensitivity)
+                        acc[k] = V::fmadd(dv, V::load(w + k * n + first + c), acc[k]);
+
+                    if constexpr (Overwrite)
+                        V::store(g, V::mul(xs[k], dv));
+                    else
+                        V::store(g, V::fmadd(xs[k], dv, V::load(g)));
+                }
+            }
+
+            // The tail keeps its scalars in locals, which no store to g can alias, and interleaves the rows so
+            // their sums form independent chains. Rows shorter than a register go straight to it
+            float scalars[R];
+            float partial[R];
+            for (size_t k = 0; k < R; k++) {
+                scalars[k] = xv[k];
+                partial[k] = Sensitivity && c > 0 ? laneSum<V>(acc[k]) : 0.0f;
+            }
+
+            for (size_t j = c; j < count; j++) {
+                float dj = d[j];
+
+                for (size_t k = 0; k < R; k++) {
+                    float& g = gradient[k * n + first + j];
+
+                    if constexpr (Sensitivity)
+                        partial[k] += dj * w[k * n + first + j];
+
+                    g = Overwrite ? scalars[k] * dj : g + scalars[k] * dj;
+                }
+            }
+
+            for (size_t k = 0; k < R; k++)
+                sums[k] = partial[k];
+        }
+
+        // One tile of R rows of W and of the gradient against every example. Each load of delta feeds R
+        // multiply-adds into the sensitivity sums and R into the gradient rows, which stay in L1 across examples.
+        // Without accumulate the first example overwrites the gradient
+        template <typename V, size_t R>
+        void backwardTile(const float* x, const float* delta, const float* w, float scale, bool accumulate, float* gradient,
+                          float* sensitivity, size_t batch, size_t rows, size_t n, size_t first, size_t count) {
+            for (size_t b = 0; b < batch; b++) {
+                const float* d = delta + b * n + first;
+                bool overwrite = b == 0 && !accumulate;
+                float xv[R];
+                float sums[R];
+
+                for (size_t k = 0; k < R; k++)
+                    xv[k] = scale * x[b * rows + k];
+
+                if (sensitivity) {
+                    if (overwrite)
+                        backwardExample<V, R, true, true>(d, w, xv, gradient, n, first, count, sums);
+                    else
+                        backwardExample<V, R, false, true>(d, w, xv, gradient, n, first, count, sums);
+
+                    for (size_t k = 0; k < R; k++)
+                        sensitivity[b * rows + k] = (first == 0 ? 0.0f : sensitivity[b * rows + k]) + sums[k];
+                }
+                else if (overwrite)
+                    backwardExample<V, R, true, false>(d, w, xv, gradient, n, first, count, sums);
+                else
+                    backwardExample<V, R, false, false>(d, w, xv, gradient, n, first, count, sums);
+            }
+        }
+
+        // R rows of W, tile by tile, then the derivative factor once their sensitivity sums are complete
+        template <typename V, size_t R>
+        void backwardRows(const float* x, const float* delta, const float* w, const float* derivatives, float scale,
+                          bool accumulate, float* gradient, float* sensitivity, size_t batch, size_t rows, size_t n) {
+            for (size_t first = 0; first < n; first += BACKWARD_TILE)
+                backwardTile<V, R>(x, delta, w, scale, accumulate, gradient, sensitivity, batch, rows, n,
+                                   first, std::min(BACKWARD_TILE, n - first));
+
+            if (sensitivity)
+                for (size_t b = 0; b < batch; b++)
+                    for (size_t k = 0; k < R; k++)
+                        sensitivity[b * rows + k] *= derivatives[b * rows + k];
+        }
+
+        // See KernelTable::denseBackward. The row offset is applied to every row-indexed pointer, and rows is
+        // kept as their stride. A batch shares each tile of W across its examples four rows at a time; a single
+        // example has only delta to share, so long rows go one at a time and W and the gradient stream sequentially
+        template <typename V>
+        void denseBackwardKernel(const float* x, const float* delta, const float* w, const float* derivatives, float scale,
+                                 bool accumulate, float* gradient, float* sensitivity, size_t batch, size_t rows, size_t n) {
+            size_t r = 0;
+
+            if (batch > 1 || n < BACKWARD_SINGLE_ROW)
+                for (; r + 4 <= rows; r += 4)
+                    backwardRows<V, 4>(x + r, delta, w + r * n, derivatives ? derivatives + r : nullptr, scale, accumulate,
+                                       gradient + r * n, sensitivity ? sensitivity + r : nullptr, batch, rows, n);
+
+            for (; r < rows; r++)
+                backwardRows<V, 1>(x + r, delta, w + r * n, derivatives ? derivatives + r : nullptr, scale, accumulate,
+                                   gradient + r * n, sensitivity ? sensitivity + r : nullptr, batch, rows, n);
+        }
+
+        template <typename V>
+        void widenDispatch(WeightPrecision precision, const uint16_t* in, float* out, size_t n) {
+            if (precision == WeightPrecision::BFloat16)
+                widenKernel<V, WeightPrecision::BFloat16>(in, out, n);
+            else
+                widenKernel<V, WeightPrecision::Float16>(in, out, n);
+        }
+
+        template <typename V>
+        void narrowDispatch(WeightPrecision precision, const float* in, uint16_t* out, size_t n) {
+            if (precision == WeightPrecision::BFloat16)
+                narrowKernel<V, WeightPrecision::BFloat16>(in, out, n);
+            else
+                narrowKernel<V, WeightPrecision::Float16>(in, out, n);
+        }
+
+        template <typename V>
+        void gemvWidenDispatch(WeightPrecision precision, const float* x, const uint16_t* w, float* y, size_t rows, size_t n) {
+            if (precision == WeightPrecision::BFloat16)
+                gemvWidenKernel<V, WeightPrecision::BFloat16>(x, w, y, rows, n);
+            else
+                gemvWidenKernel<V, WeightPrecision::Float16>(x, w, y, rows, n);
+        }
+
+        template <typename V>
+        KernelTable makeKernelTable(SimdLevel level) {
+            KernelTable table;
+            table.level = level;
+            table.add = addKernel<V>;
+            table.sub = subKernel<V>;
+            table.mul = mulKernel<V>;
+            table.scale = scaleKernel<V>;
+            table.divide = divideKernel<V>;
+            table.axpy = axpyKernel<V>;
+            table.sum = sumKernel<V>;
+            table.activate = activateKernel<V>;
+            table.activateDerivative = activateDerivativeKernel<V>;
+            table.optimize = optimizeKernel<V>;
+            table.widen = widenDispatch<V>;
+            table.narrow = narrowDispatch<V>;
+            table.gemvWiden = gemvWidenDispatch<V>;
+            table.gemvRows = gemvRowsKernel<V>;
+            table.gemvPanels = gemvPanelsKernel<V>;
+            table.denseForward = denseForwardKernel<V>;
+            table.denseBackward = denseBackwardKernel<V>;
+            table.panelWidth = 4 * V::width;
+
+            GemvInt8Variant int8 = selectGemvInt8<V>();
+            table.gemvInt8 = int8.kernel;
+            table.gemvInt8Name = int8.name;
+
+            return table;
+        }
+
+    }
+
+}
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef KERNEL_IMPL_INT8_HPP
+#define KERNEL_IMPL_INT8_HPP
+
+// Int8 GEMV kernels. Unlike the float kernels they are not written against the register wrappers:
+// each ISA has its own multiply-accumulate instruction, so every variant is spelled out and
+// selectGemvInt8<V>() picks the best one the running CPU supports for a given table.
+//
+// Every variant multiplies |x| (unsigned) by sign(x) * w (signed), which is exact for values in
+// [-127, 127]: a pair of such products is at most 2 * 127 * 127 = 32258 and cannot saturate the
+// int16 sums of maddubs.
+
+#include <cstddef>
+#include <cstdint>
+#include "SimdTypes.hpp"
+
+namespace bbdnn::kernels {
+
+    namespace {
+
+        /// Name and function of one int8 GEMV variant.
+        struct GemvInt8Variant {
+            const char* name;
+            void (*kernel)(const int8_t* x, const int8_t* w, int32_t* out, size_t rows, size_t k);
+        };
+
+        void gemvInt8Scalar(const int8_t* x, const int8_t* w, int32_t* out, size_t rows, size_t k) {
+            for (size_t r = 0; r < rows; r++) {
+                const int8_t* row = w + r * k;
+                int32_t acc = 0;
+
+                for (size_t i = 0; i < k; i++)
+                    acc += static_cast<int32_t>(x[i]) * static_cast<int32_t>(row[i]);
+
+                out[r] = acc;
+            }
+        }
+
+#if defined(__SSE4_2__)
+        int32_t horizontalSum(__m128i v) {
+            v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+            v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0xB1));
+            return _mm_cvtsi128_si32(v);
+        }
+#endif
+
+        // Only the SSE4.2 table selects this variant; the AVX2 and AVX-512 units would leave it unused
+#if defined(__SSE4_2__) && !defined(__AVX2__)
+        void gemvInt8Sse42(const int8_t* x, const int8_t* w, int32_t* out, size_t rows, size_t k) {
+            const __m128i ones = _mm_set1_epi16(1);
+
+            for (size_t r = 0; r < rows; r++) {
+                const int8_t* row = w + r * k;
+                __m128i acc = _mm_setzero_si128();
+
+                for (size_t i = 0; i < k; i += 16) {
+                    __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+                    __m128i wv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+                    __m128i pairs = _mm_maddubs_epi16(_mm_abs_epi8(xv), _mm_sign_epi8(wv, xv));
+                    acc = _mm_add_epi32(acc, _mm_madd_epi16(pairs, ones));
+                }
+
+                out[r] = horizontalSum(acc);
+            }
+        }
+#endif
+
+#if defined(__AVX2__)
+        int32_t horizontalSum(__m256i v) {
+            return horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+        }
+
+        // Adds |x| * (sign(x) * w) for one 32-byte block to acc, through maddubs pairs widened by madd
+        inline __m256i dotStepAvx2(__m256i acc, __m256i absX, __m256i xv, const int8_t* w) {
+            __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w));
+            __m256i pairs = _mm256_maddubs_epi16(absX, _mm256_sign_epi8(wv, xv));
+            return _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, _mm256_set1_epi16(1)));
+        }
+
+        // Same block product with dpbusd, which sums four u8 x s8 products straight into int32
+        __attribute__((target("avxvnni")))
+        inline __m256i dotStepAvxVnni(__m256i acc, __m256i absX, __m256i xv, const int8_t* w) {
+            __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w));
+            return _mm256_dpbusd_avx_epi32(acc, absX, _mm256_sign_epi8(wv, xv));
+        }
+
+        // Four rows share each load of x. The VNNI variant below differs only in its step, but a step
+        // needing avxvnni cannot be inlined into a function compiled without it, so the loop is written twice
+        void gemvInt8Avx2(const int8_t* x, const int8_t* w, int32_t* out, size_t rows, size_t k) {
+            size_t r = 0;
+
+            for (; r + 4 <= rows; r += 4) {
+                const int8_t* row = w + r * k;
+                __m256i acc0 = _mm256_setzero_si256();
+                __m256i acc1 = _mm256_setzero_si256();
+                __m256i acc2 = _mm256_setzero_si256();
+                __m256i acc3 = _mm256_setzero_si256();
+
+                for (size_t i = 0; i < k; i += 32) {
+                    __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+                    __m256i absX = _mm256_abs_epi8(xv);
+
+                    acc0 = dotStepAvx2(acc0, absX, xv, row + i);
+                    acc1 = dotStepAvx2(acc1, absX, xv, row + k + i);
+                    acc2 = dotStepAvx2(acc2, absX, xv, row + 2 * k + i);
+                    acc3 = dotStepAvx2(acc3, absX, xv, row + 3 * k + i);
+                }
+
+                out[r] = horizontalSum(acc0);
+                out[r + 1] = horizontalSum(acc1);
+                out[r + 2] = horizontalSum(acc2);
+                out[r + 3] = horizontalSum(acc3);
+            }
+
+            for (; r < rows; r++) {
+                __m256i acc = _mm256_setzero_si256();
+
+                for (size_t i = 0; i < k; i += 32) {
+                    __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+                    acc = dotStepAvx2(acc, _mm256_abs_epi8(xv), xv, w + r * k + i);
+                }
+
+                out[r] = horizontalSum(acc);
+            }
+        }
+
+        __attribute__((target("avxvnni")))
+        void gemvInt8AvxVnni(const int8_t* x, const int8_t* w, int32_t* out, size_t rows, size_t k) {
+            size_t r = 0;
+
+            for (; r + 4 <= rows; r += 4) {
+                const int8_t* row = w + r * k;
+                __m256i acc0 = _mm256_setzero_si256();
+                __m256i acc1 = _mm256_setzero_si256();
+                __m256i acc2 = _mm256_setzero_si256();
+                __m256i acc3 = _mm256_setzero_si256();
+
+                for (size_t i = 0; i < k; i += 32) {
+                    __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+                    __m256i absX = _mm256_abs_epi8(xv);
+
+                    acc0 = dotStepAvxVnni(acc0, absX, xv, row + i);
+                    acc1 = dotStepAvxVnni(acc1, absX, xv, row + k + i);
+                    acc2 = dotStepAvxVnni(acc2, absX, xv, row + 2 * k + i);
+                    acc3 = dotStepAvxVnni(acc3, absX, xv, row + 3 * k + i);
+                }
+
+                out[r] = horizontalSum(acc0);
+                out[r + 1] = horizontalSum(acc1);
+                out[r + 2] = horizontalSum(acc2);
+                out[r + 3] = horizontalSum(acc3);
+            }
+
+            for (; r < rows; r++) {
+                __m256i acc = _mm256_setzero_si256();
+
+                for (size_t i = 0; i < k; i += 32) {
+                    __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+                    acc = dotStepAvxVnni(acc, _mm256_abs_epi8(xv), xv, w + r * k + i);
+                }
+
+                out[r] = horizontalSum(acc);
+            }
+        }
+#endif
+
+#if defined(__AVX512F__)
+        __attribute__((target("avx512bw,avx512vnni")))
+        void gemvInt8Avx512Vnni(const int8_t* x, const int8_t* w, int32_t* out, size_t rows, size_t k) {
+            const __m512i zero = _mm512_setzero_si512();
+            size_t r = 0;
+
+            for (; r + 4 <= rows; r += 4) {
+                const int8_t* row = w + r * k;
+                __m512i acc0 = zero;
+                __m512i acc1 = zero;
+                __m512i acc2 = zero;
+                __m512i acc3 = zero;
+
+                for (size_t i = 0; i < k; i += 64) {
+                    __m512i xv = _mm512_loadu_si512(x + i);
+                    __m512i absX = _mm512_abs_epi8(xv);
+                    // AVX-512 has no sign_epi8; negate w wherever x is negative instead
+                    __mmask64 negative = _mm512_movepi8_mask(xv);
+
+                    __m512i w0 = _mm512_loadu_si512(row + i);
+                    __m512i w1 = _mm512_loadu_si512(row + k + i);
+                    __m512i w2 = _mm512_loadu_si512(row + 2 * k + i);
+                    __m512i w3 = _mm512_loadu_si512(row + 3 * k + i);
+
+                    acc0 = _mm512_dpbusd_epi32(acc0, absX, _mm512_mask_sub_epi8(w0, negative, zero, w0));
+                    acc1 = _mm512_dpbusd_epi32(acc1, absX, _mm512_mask_sub_epi8(w1, negative, zero, w1));
+                    acc2 = _mm512_dpbusd_epi32(acc2, absX, _mm512_mask_sub_epi8(w2, negative, zero, w2));
+                    acc3 = _mm512_dpbusd_epi32(acc3, absX, _mm512_mask_sub_epi8(w3, negative, zero, w3));
+                }
+
+                out[r] = _mm512_reduce_add_epi32(acc0);
+                out[r + 1] = _mm512_reduce_add_epi32(acc1);
+                out[r + 2] = _mm512_reduce_add_epi32(acc2);
+                out[r + 3] = _mm512_reduce_add_epi32(acc3);
+            }
+
+            for (; r < rows; r++) {
+                const int8_t* row = w + r * k;
+                __m512i acc = zero;
+
+                for (size_t i = 0; i < k; i += 64) {
+                    __m512i xv = _mm512_loadu_si512(x + i);
+                    __m512i wv = _mm512_loadu_si512(row + i);
+                    __m512i signedW = _mm512_mask_sub_epi8(wv, _mm512_movepi8_mask(xv), zero, wv);
+                    acc = _mm512_dpbusd_epi32(acc, _mm512_abs_epi8(xv), signedW);
+                }
+
+                out[r] = _mm512_reduce_add_epi32(acc);
+            }
+        }
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+        // Products of two values in [-127, 127] fit int16, so widening multiplies and pairwise adds are exact
+        void gemvInt8Neon(const int8_t* x, const int8_t* w, int32_t* out, size_t rows, size_t k) {
+            for (size_t r = 0; r < rows; r++) {
+                const int8_t* row = w + r * k;
+                int32x4_t acc = vdupq_n_s32(0);
+
+                for (size_t i = 0; i < k; i += 16) {
+                    int8x16_t xv = vld1q_s8(x + i);
+                    int8x16_t wv = vld1q_s8(row + i);
+                    acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(xv), vget_low_s8(wv)));
+                    acc = vpadalq_s16(acc, vmull_high_s8(xv, wv));
+                }
+
+                out[r] = vaddvq_s32(acc);
+            }
+        }
+#endif
+
+        /// Best int8 GEMV for the table built on register type V.
+        template <typename V>
+        GemvInt8Variant selectGemvInt8() {
+#if defined(__AVX512F__)
+            if constexpr (V::width == 16) {
+                if (__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni"))
+                    return { "avx512-vnni", gemvInt8Avx512Vnni };
+            }
+#endif
+#if defined(__AVX2__)
+            if constexpr (V::width >= 8) {
+                if (__builtin_cpu_supports("avxvnni"))
+                    return { "avx-vnni", gemvInt8AvxVnni };
+
+                return { "avx2-maddubs", gemvInt8Avx2 };
+            }
+#endif
+#if defined(__SSE4_2__) && !defined(__AVX2__)
+            if constexpr (V::width == 4)
+                return { "ssse3-maddubs", gemvInt8Sse42 };
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+            if constexpr (V::width == 4)
+                return { "neon", gemvInt8Neon };
+#endif
+            return { "scalar", gemvInt8Scalar };
+        }
+
+    }
+
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef KERNEL_TABLES_HPP
+#define KERNEL_TABLES_HPP
+
+#include "bbdnn/Simd.hpp"
+
+// Per-ISA table accessors, each defined in a translation unit built with that ISA's flags.
+// Only call one after confirming the CPU supports it.
+
+namespace bbdnn::kernels {
+
+    const KernelTable& scalarKernelTable();
+
+#if defined(BBDNN_HAVE_X86_KERNELS)
+    const KernelTable& sse42KernelTable();
+    const KernelTable& avx2KernelTable();
+    const KernelTable& avx512KernelTable();
+#endif
+
+#if defined(BBDNN_HAVE_NEON_KERNELS)
+    const KernelTable& neonKernelTable();
+#endif
+
+}
+
+#endif
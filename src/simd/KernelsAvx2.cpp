@@ -0,0 +1,12 @@
+// Built with -mavx2 -mfma -mf16c.
+#include "KernelImpl.hpp"
+#include "KernelTables.hpp"
+
+namespace bbdnn::kernels {
+
+    const KernelTable& avx2KernelTable() {
+        static const KernelTable table = makeKernelTable<Avx2Vec>(SimdLevel::AVX2);
+        return table;
+    }
+
+}
@@ -0,0 +1,12 @@
+// Built with -mavx512f -mavx512dq -mavx2 -mfma -mf16c.
+#include "KernelImpl.hpp"
+#include "KernelTables.hpp"
+
+namespace bbdnn::kernels {
+
+    const KernelTable& avx512KernelTable() {
+        static const KernelTable table = makeKernelTable<Avx512Vec>(SimdLevel::AVX512);
+        return table;
+    }
+
+}
@@ -0,0 +1,12 @@
+// Built with the baseline AArch64 flags (NEON is mandatory there).
+#include "KernelImpl.hpp"
+#include "KernelTables.hpp"
+
+namespace bbdnn::kernels {
+
+    const KernelTable& neonKernelTable() {
+        static const KernelTable table = makeKernelTable<NeonVec>(SimdLevel::NEON);
+        return table;
+    }
+
+}
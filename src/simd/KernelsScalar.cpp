@@ -0,0 +1,12 @@
+// Built with the baseline target flags.
+#include "KernelImpl.hpp"
+#include "KernelTables.hpp"
+
+namespace bbdnn::kernels {
+
+    const KernelTable& scalarKernelTable() {
+        static const KernelTable table = makeKernelTable<ScalarVec>(SimdLevel::Scalar);
+        return table;
+    }
+
+}
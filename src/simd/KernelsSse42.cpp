@@ -0,0 +1,12 @@
+// Built with -msse4.2.
+#include "KernelImpl.hpp"
+#include "KernelTables.hpp"
+
+namespace bbdnn::kernels {
+
+    const KernelTable& sse42KernelTable() {
+        static const KernelTable table = makeKernelTable<Sse42Vec>(SimdLevel::SSE42);
+        return table;
+    }
+
+}
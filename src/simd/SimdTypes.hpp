@@ -0,0 +1,236 @@
+#ifndef SIMD_TYPES_HPP
+#define SIMD_TYPES_HPP
+
+// Thin per-ISA register wrappers. Every translation unit that includes this header is compiled
+// with its own target flags, so only the wrappers enabled by those flags are defined.
+//
+// loadHalf/loadBFloat16 widen `width` 16-bit values to a register, and storeHalf/storeBFloat16 round a
+// register back to them, both rounding to nearest even like floatToHalf and floatToBFloat16.
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include "bbdnn/HalfPrecision.hpp"
+
+#if defined(__SSE4_2__) || defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace bbdnn::kernels {
+
+    namespace {
+
+        /// One float per "register"; the reference every wider type must match.
+        struct ScalarVec {
+            using Reg = float;
+            using Mask = bool;
+            static constexpr int width = 1;
+
+            static Reg load(const float* p) { return *p; }
+            static void store(float* p, Reg v) { *p = v; }
+            static Reg set1(float x) { return x; }
+            static Reg zero() { return 0.0f; }
+            static Reg add(Reg a, Reg b) { return a + b; }
+            static Reg sub(Reg a, Reg b) { return a - b; }
+            static Reg mul(Reg a, Reg b) { return a * b; }
+            static Reg div(Reg a, Reg b) { return a / b; }
+            static Reg max(Reg a, Reg b) { return a > b ? a : b; }
+            static Reg min(Reg a, Reg b) { return a < b ? a : b; }
+            static Reg fmadd(Reg a, Reg b, Reg c) { return a * b + c; }
+            static Reg sqrt(Reg a) { return std::sqrt(a); }
+            static Reg abs(Reg a) { return std::fabs(a); }
+            static Reg floor(Reg a) { return std::floor(a); }
+            static Mask greater(Reg a, Reg b) { return a > b; }
+            static Reg select(Mask m, Reg t, Reg f) { return m ? t : f; }
+            // 2^n for an integral n in [-126, 127], built directly in the exponent field
+            static Reg pow2i(Reg n) { return std::bit_cast<float>((static_cast<int32_t>(n) + 127) << 23); }
+            static Reg loadHalf(const uint16_t* p) { return halfToFloat(*p); }
+            static void storeHalf(uint16_t* p, Reg v) { *p = floatToHalf(v); }
+            static Reg loadBFloat16(const uint16_t* p) { return bfloat16ToFloat(*p); }
+            static void storeBFloat16(uint16_t* p, Reg v) { *p = floatToBFloat16(v); }
+        };
+
+#if defined(__SSE4_2__)
+        struct Sse42Vec {
+            using Reg = __m128;
+            using Mask = __m128;
+            static constexpr int width = 4;
+
+            static Reg load(const float* p) { return _mm_loadu_ps(p); }
+            static void store(float* p, Reg v) { _mm_storeu_ps(p, v); }
+            static Reg set1(float x) { return _mm_set1_ps(x); }
+            static Reg zero() { return _mm_setzero_ps(); }
+            static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+            static Reg div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+            static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+            static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+            static Reg fmadd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+            static Reg sqrt(Reg a) { return _mm_sqrt_ps(a); }
+            static Reg abs(Reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+            static Reg floor(Reg a) { return _mm_floor_ps(a); }
+            static Mask greater(Reg a, Reg b) { return _mm_cmpgt_ps(a, b); }
+            static Reg select(Mask m, Reg t, Reg f) { return _mm_blendv_ps(f, t, m); }
+            static Reg pow2i(Reg n) {
+                return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23));
+            }
+            // No F16C at this level, so half conversions go through the scalar routines
+            static Reg loadHalf(const uint16_t* p) {
+                return _mm_setr_ps(halfToFloat(p[0]), halfToFloat(p[1]), halfToFloat(p[2]), halfToFloat(p[3]));
+            }
+            static void storeHalf(uint16_t* p, Reg v) {
+                alignas(16) float values[4];
+                _mm_store_ps(values, v);
+                for (int i = 0; i < 4; i++)
+                    p[i] = floatToHalf(values[i]);
+            }
+            static Reg loadBFloat16(const uint16_t* p) {
+                return _mm_castsi128_ps(_mm_slli_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))), 16));
+            }
+            static void storeBFloat16(uint16_t* p, Reg v) {
+                __m128i bits = _mm_castps_si128(v);
+                __m128i high = _mm_srli_epi32(bits, 16);
+                __m128i rounded = _mm_srli_epi32(_mm_add_epi32(bits, _mm_add_epi32(_mm_and_si128(high, _mm_set1_epi32(1)), _mm_set1_epi32(0x7FFF))), 16);
+                __m128i quiet = _mm_or_si128(high, _mm_set1_epi32(0x40));
+                rounded = _mm_blendv_epi8(rounded, quiet, _mm_castps_si128(_mm_cmpunord_ps(v, v)));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi32(rounded, rounded));
+            }
+        };
+#endif
+
+#if defined(__AVX2__)
+        struct Avx2Vec {
+            using Reg = __m256;
+            using Mask = __m256;
+            static constexpr int width = 8;
+
+            static Reg load(const float* p) { return _mm256_loadu_ps(p); }
+            static void store(float* p, Reg v) { _mm256_storeu_ps(p, v); }
+            static Reg set1(float x) { return _mm256_set1_ps(x); }
+            static Reg zero() { return _mm256_setzero_ps(); }
+            static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+            static Reg div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+            static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+            static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+            static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+            static Reg sqrt(Reg a) { return _mm256_sqrt_ps(a); }
+            static Reg abs(Reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+            static Reg floor(Reg a) { return _mm256_floor_ps(a); }
+            static Mask greater(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+            static Reg select(Mask m, Reg t, Reg f) { return _mm256_blendv_ps(f, t, m); }
+            static Reg pow2i(Reg n) {
+                return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127)), 23));
+            }
+            static Reg loadHalf(const uint16_t* p) { return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+            static void storeHalf(uint16_t* p, Reg v) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+            }
+            static Reg loadBFloat16(const uint16_t* p) {
+                return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))), 16));
+            }
+            static void storeBFloat16(uint16_t* p, Reg v) {
+                __m256i bits = _mm256_castps_si256(v);
+                __m256i high = _mm256_srli_epi32(bits, 16);
+                __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, _mm256_add_epi32(_mm256_and_si256(high, _mm256_set1_epi32(1)), _mm256_set1_epi32(0x7FFF))), 16);
+                __m256i quiet = _mm256_or_si256(high, _mm256_set1_epi32(0x40));
+                rounded = _mm256_blendv_epi8(rounded, quiet, _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q)));
+                // packus works within 128-bit lanes; gather the two packed quarters into the low half
+                __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(rounded, rounded), 0x08);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(packed));
+            }
+        };
+#endif
+
+#if defined(__AVX512F__)
+        struct Avx512Vec {
+            using Reg = __m512;
+            using Mask = __mmask16;
+            static constexpr int width = 16;
+
+            static Reg load(const float* p) { return _mm512_loadu_ps(p); }
+            static void store(float* p, Reg v) { _mm512_storeu_ps(p, v); }
+            static Reg set1(float x) { return _mm512_set1_ps(x); }
+            static Reg zero() { return _mm512_setzero_ps(); }
+            static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+            static Reg div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+            static Reg max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+            static Reg min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+            static Reg fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+            static Reg sqrt(Reg a) { return _mm512_sqrt_ps(a); }
+            static Reg abs(Reg a) { return _mm512_abs_ps(a); }
+            static Reg floor(Reg a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+            static Mask greater(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+            static Reg select(Mask m, Reg t, Reg f) { return _mm512_mask_blend_ps(m, f, t); }
+            static Reg pow2i(Reg n) {
+                return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvttps_epi32(n), _mm512_set1_epi32(127)), 23));
+            }
+            static Reg loadHalf(const uint16_t* p) { return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))); }
+            static void storeHalf(uint16_t* p, Reg v) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+            }
+            static Reg loadBFloat16(const uint16_t* p) {
+                return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))), 16));
+            }
+            static void storeBFloat16(uint16_t* p, Reg v) {
+                __m512i bits = _mm512_castps_si512(v);
+                __m512i high = _mm512_srli_epi32(bits, 16);
+                __m512i rounded = _mm512_srli_epi32(_mm512_add_epi32(bits, _mm512_add_epi32(_mm512_and_si512(high, _mm512_set1_epi32(1)), _mm512_set1_epi32(0x7FFF))), 16);
+                __m512i quiet = _mm512_or_si512(high, _mm512_set1_epi32(0x40));
+                rounded = _mm512_mask_blend_epi32(_mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q), rounded, quiet);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtepi32_epi16(rounded));
+            }
+        };
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+        struct NeonVec {
+            using Reg = float32x4_t;
+            using Mask = uint32x4_t;
+            static constexpr int width = 4;
+
+            static Reg load(const float* p) { return vld1q_f32(p); }
+            static void store(float* p, Reg v) { vst1q_f32(p, v); }
+            static Reg set1(float x) { return vdupq_n_f32(x); }
+            static Reg zero() { return vdupq_n_f32(0.0f); }
+            static Reg add(Reg a, Reg b) { return vaddq_f32(a, b); }
+            static Reg sub(Reg a, Reg b) { return vsubq_f32(a, b); }
+            static Reg mul(Reg a, Reg b) { return vmulq_f32(a, b); }
+            static Reg div(Reg a, Reg b) { return vdivq_f32(a, b); }
+            static Reg max(Reg a, Reg b) { return vmaxq_f32(a, b); }
+            static Reg min(Reg a, Reg b) { return vminq_f32(a, b); }
+            static Reg fmadd(Reg a, Reg b, Reg c) { return vfmaq_f32(c, a, b); }
+            static Reg sqrt(Reg a) { return vsqrtq_f32(a); }
+            static Reg abs(Reg a) { return vabsq_f32(a); }
+            static Reg floor(Reg a) { return vrndmq_f32(a); }
+            static Mask greater(Reg a, Reg b) { return vcgtq_f32(a, b); }
+            static Reg select(Mask m, Reg t, Reg f) { return vbslq_f32(m, t, f); }
+            static Reg pow2i(Reg n) {
+                return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23));
+            }
+            static Reg loadHalf(const uint16_t* p) { return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p))); }
+            static void storeHalf(uint16_t* p, Reg v) { vst1_u16(p, vreinterpret_u16_f16(vcvt_f16_f32(v))); }
+            static Reg loadBFloat16(const uint16_t* p) { return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(p), 16)); }
+            static void storeBFloat16(uint16_t* p, Reg v) {
+                uint32x4_t bits = vreinterpretq_u32_f32(v);
+                uint32x4_t lsb = vandq_u32(vshrq_n_u32(bits, 16), vdupq_n_u32(1));
+                uint32x4_t rounded = vaddq_u32(bits, vaddq_u32(lsb, vdupq_n_u32(0x7FFF)));
+                uint32x4_t quiet = vorrq_u32(bits, vdupq_n_u32(0x400000));
+                vst1_u16(p, vshrn_n_u32(vbslq_u32(vceqq_f32(v, v), rounded, quiet), 16));
+            }
+        };
+#endif
+
+    }
+
+}
+
+#endif
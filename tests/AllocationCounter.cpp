@@ -0,0 +1,53 @@
+#include "AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> allocations { 0 };
+
+    void* allocate(size_t bytes, size_t alignment) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+
+        // aligned_alloc needs a size that is a multiple of the alignment
+        size_t rounded = (bytes + alignment - 1) / alignment * alignment;
+        void* memory = alignment <= alignof(std::max_align_t) ? std::malloc(bytes == 0 ? 1 : bytes) : std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+        if (memory == nullptr)
+            throw std::bad_alloc();
+
+        return memory;
+    }
+}
+
+namespace bbdnn::test {
+
+    size_t heapAllocations() {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+}
+
+// The array and nothrow forms forward to these by default
+void* operator new(size_t bytes) {
+    return allocate(bytes, alignof(std::max_align_t));
+}
+
+void* operator new(size_t bytes, std::align_val_t alignment) {
+    return allocate(bytes, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,15 @@
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+
+// Counts every global operator new in the test executable, including the std containers' and the Matrix
+// heap allocator's, by replacing the global allocation functions (AllocationCounter.cpp)
+namespace bbdnn::test {
+
+    /// Heap allocations made by this process so far.
+    size_t heapAllocations();
+
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef TESTCHECK_HPP
+#define TESTCHECK_HPP
+
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+// Minimal checks shared by the tests: each test is an executable that returns nonzero when any check failed
+namespace bbdnn::test {
+
+    inline int failures = 0;
+
+    // Takes a plain string so a passing check never allocates, which the allocation tests rely on
+    inline void check(bool condition, const char* what, const char* file, int line) {
+        if (condition)
+            return;
+
+        failures++;
+        std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+    }
+
+    inline void check(bool condition, const std::string& what, const char* file, int line) {
+        check(condition, what.c_str(), file, line);
+    }
+
+    // |actual - expected| <= tolerance * max(1, |expected|), with NaN only matching NaN
+    inline bool close(float actual, float expected, float tolerance) {
+        if (std::isnan(expected) || std::isnan(actual))
+            return std::isnan(expected) && std::isnan(actual);
+
+        return std::fabs(actual - expected) <= tolerance * std::fmax(1.0f, std::fabs(expected));
+    }
+
+    // Whether running f throws an E
+    template <typename E, typename F>
+    bool throws(F f) {
+        try {
+            f();
+        }
+        catch (const E&) {
+            return true;
+        }
+        catch (...) {
+            return false;
+        }
+
+        return false;
+    }
+
+    // Fresh directory under the system temp directory, removed with everything in it on destruction
+    struct TempDirectory {
+        std::filesystem::path path;
+
+        explicit TempDirectory(const std::string& name) : path(std::filesystem::temp_directory_path() / name) {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~TempDirectory() {
+            std::error_code ignored;
+            std::filesystem::remove_all(path, ignored);
+        }
+
+        std::string file(const std::string& name) const { return (path / name).string(); }
+    };
+
+    inline int report(const char* name) {
+        if (failures == 0)
+            std::cout << name << ": all checks passed" << std::endl;
+        else
+            std::cout << name << ": " << failures << " check(s) failed" << std::endl;
+
+        return failures == 0 ? 0 : 1;
+    }
+
+}
+
+#define CHECK(condition) ::bbdnn::test::check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_MSG(condition, message) ::bbdnn::test::check((condition), (message), __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,125 @@
+#include "bbdnn/NeuralNetwork.hpp"
+#include "AllocationCounter.hpp"
+#include "TestCheck.hpp"
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Heap allocations made by Matrix moves and assignments and by one training step, before (the value-returning
+// backPropagate, takeStep and updateParameters) and after (computeGradients and applyGradients in place)
+using namespace bbdnn;
+using namespace bbdnn::test;
+
+namespace {
+
+    // Copying a view into an owning matrix is always spelled out, and a view of a temporary does not compile
+    static_assert(!std::is_convertible_v<MatrixView, Matrix> && std::is_constructible_v<Matrix, MatrixView>);
+    static_assert(!std::is_convertible_v<VectorView, Vector> && std::is_constructible_v<Vector, VectorView>);
+    static_assert(!std::is_constructible_v<MatrixView, Matrix&&> && std::is_constructible_v<MatrixView, const Matrix&>);
+    static_assert(!std::is_constructible_v<VectorView, Vector&&> && std::is_constructible_v<VectorView, const Vector&>);
+
+    // The same holds for the view accessors of a temporary
+    template <typename M>
+    concept HasView = requires(M&& m) { static_cast<M&&>(m).view(); };
+    template <typename M>
+    concept HasRow = requires(M&& m) { static_cast<M&&>(m).getRow(0); };
+    template <typename M>
+    concept HasCol = requires(M&& m) { static_cast<M&&>(m).getCol(0); };
+
+    static_assert(HasView<const Matrix&> && !HasView<Matrix> && !HasView<const Matrix&&>);
+    static_assert(HasRow<const Matrix&> && !HasRow<Matrix> && !HasRow<Vector>);
+    static_assert(HasCol<Matrix&> && !HasCol<Matrix> && !HasCol<Vector>);
+
+    void testMatrixOwnership() {
+        Matrix source(64, 64, 1.0f);
+        Matrix target(64, 64, 0.0f);
+
+        size_t before = heapAllocations();
+        Matrix moved(std::move(source));
+        CHECK(heapAllocations() == before);
+        CHECK(source.size() == 0);
+        CHECK(moved(63, 63) == 1.0f);
+
+        // Same-shape copies reuse the target's storage
+        before = heapAllocations();
+        target = moved;
+        CHECK(heapAllocations() == before);
+        CHECK(target(10, 20) == 1.0f);
+
+        before = heapAllocations();
+        target = std::move(moved);
+        CHECK(heapAllocations() == before);
+
+        // The raw-data constructor copies, so the caller keeps ownership of its array
+        float values[] = { 1.0f, 2.0f, 3.0f, 4.0f };
+        Matrix copied(2, 2, values);
+        values[0] = 9.0f;
+        CHECK(copied(0, 0) == 1.0f);
+    }
+
+    // The XOR demo network with a wider hidden layer
+    NeuralNetwork makeNetwork() {
+        return NeuralNetwork(42, {
+            DenseLayer(2, Activation::Linear()),
+            DenseLayer(32, Activation::Tanh()),
+            DenseLayer(16, Activation::Tanh()),
+            DenseLayer(1, Activation::Sigmoid()),
+        });
+    }
+
+    void testTrainingStep() {
+        Vector input { 1.0f, 0.0f };
+        Vector expected { 1.0f };
+        const float learningRate = 0.05f;
+
+        // Before: one step returns new gradient and parameter sets
+        NeuralNetwork legacy = makeNetwork();
+        for (int warmup = 0; warmup < 2; warmup++) {
+            legacy.setInput(input);
+            legacy.forwardPropogate();
+            auto [deltaWeights, deltaBiases, ssr] = legacy.backPropagate(expected, learningRate);
+            auto [newWeights, newBiases] = legacy.takeStep(deltaWeights, deltaBiases);
+            legacy.updateParameters(std::move(newWeights), std::move(newBiases));
+        }
+
+        size_t start = heapAllocations();
+        legacy.setInput(input);
+        legacy.forwardPropogate();
+        {
+            auto [deltaWeights, deltaBiases, ssr] = legacy.backPropagate(expected, learningRate);
+            auto [newWeights, newBiases] = legacy.takeStep(deltaWeights, deltaBiases);
+            legacy.updateParameters(std::move(newWeights), std::move(newBiases));
+        }
+        size_t legacyAllocations = heapAllocations() - start;
+
+        // After: gradients land in the network's workspace and the step updates the weights in place
+        NeuralNetwork network = makeNetwork();
+        for (int warmup = 0; warmup < 2; warmup++) {
+            network.setInput(input);
+            network.forwardPropogate();
+            network.computeGradients(expected);
+            network.applyGradients(learningRate);
+        }
+
+        start = heapAllocations();
+        network.setInput(input);
+        network.forwardPropogate();
+        network.computeGradients(expected);
+        network.applyGradients(learningRate);
+        size_t stepAllocations = heapAllocations() - start;
+
+        std::cout << "heap allocations per training step: " << legacyAllocations << " returning new parameter sets, "
+                  << stepAllocations << " in place" << std::endl;
+
+        CHECK(legacyAllocations > 0);
+        CHECK(stepAllocations == 0);
+    }
+
+}
+
+int main() {
+    testMatrixOwnership();
+    testTrainingStep();
+
+    return report("allocation_test");
+}
@@ -0,0 +1,91 @@
+#include "bbdnn/NeuralNetwork.hpp"
+#include "TestCheck.hpp"
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Many threads predicting against one shared model, each with its own InferenceContext or through the
+// context-free predict, must reproduce the serial predictions exactly
+using namespace bbdnn;
+using namespace bbdnn::test;
+
+namespace {
+
+    const int THREADS = 8;
+    const int ROUNDS = 2000;
+    const int INPUTS = 64;
+
+    bool sameValues(const Vector& a, const Vector& b) {
+        if (a.size() != b.size())
+            return false;
+
+        for (int i = 0; i < a.size(); i++)
+            if (a[i] != b[i])
+                return false;
+
+        return true;
+    }
+
+}
+
+int main() {
+    const NeuralNetwork network(11, {
+        DenseLayer(16, Activation::Linear()),
+        DenseLayer(128, Activation::ReLU()),
+        DenseLayer(64, Activation::Tanh()),
+        DenseLayer(4, Activation::Sigmoid()),
+    });
+
+    std::mt19937 rng(5);
+    std::normal_distribution<float> distribution;
+    std::vector<Vector> inputs;
+    for (int i = 0; i < INPUTS; i++) {
+        Vector input(16);
+        for (int j = 0; j < input.size(); j++)
+            input[j] = distribution(rng);
+
+        inputs.push_back(input);
+    }
+
+    std::vector<Vector> expected;
+    for (const Vector& input : inputs)
+        expected.push_back(network.predict(input));
+
+    std::atomic<int> mismatches { 0 };
+    std::atomic<int> predictions { 0 };
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t] {
+            InferenceContext context = network.createInferenceContext();
+
+            // Each thread walks the inputs from a different offset so neighbouring threads run different examples
+            for (int round = 0; round < ROUNDS; round++) {
+                int i = (round * 7 + t * 13) % INPUTS;
+
+                // Odd threads alternate with the allocating overload to cover both paths
+                bool matches = (t % 2 == 1 && round % 2 == 1) ? sameValues(network.predict(inputs[i]), expected[i])
+                                                              : sameValues(network.predict(inputs[i], context), expected[i]);
+
+                if (!matches)
+                    mismatches.fetch_add(1, std::memory_order_relaxed);
+
+                predictions.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::cout << predictions.load() << " predictions on " << THREADS << " threads, " << mismatches.load() << " mismatches" << std::endl;
+
+    CHECK(predictions.load() == THREADS * ROUNDS);
+    CHECK(mismatches.load() == 0);
+
+    // The shared model's own layers are untouched by context predictions
+    CHECK(sameValues(network.predict(inputs[0]), expected[0]));
+
+    return report("concurrent_predict_test");
+}
@@ -0,0 +1,214 @@
+#include "bbdnn/Dataset.hpp"
+#include "bbdnn/DatasetStream.hpp"
+#include "TestCheck.hpp"
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+// CSV and IDX parsing through DatasetStream, including malformed input, rewinding and errors rethrown from the
+// prefetch thread, and Dataset::save / Dataset::map round trips
+using namespace bbdnn;
+using namespace bbdnn::test;
+
+namespace {
+
+    void writeText(const std::string& path, const std::string& text) {
+        std::ofstream out(path, std::ios::binary);
+        out << text;
+    }
+
+    // IDX file of unsigned bytes: magic 0 0 0x08 dims, big-endian dimension sizes, then the values
+    void writeIdx(const std::string& path, const std::vector<uint32_t>& dimensions, const std::vector<uint8_t>& values) {
+        std::ofstream out(path, std::ios::binary);
+        out.put(0).put(0).put(0x08).put(static_cast<char>(dimensions.size()));
+
+        for (uint32_t size : dimensions)
+            for (int shift = 24; shift >= 0; shift -= 8)
+                out.put(static_cast<char>((size >> shift) & 0xFF));
+
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size()));
+    }
+
+    // Every remaining row of a stream, chunk by chunk
+    Dataset readAll(DatasetStream& stream) {
+        Dataset all(stream.featureSize(), stream.labelSize());
+        Dataset chunk(stream.featureSize(), stream.labelSize());
+
+        while (stream.next(chunk)) {
+            CHECK(chunk.size() <= stream.chunkSize());
+
+            for (size_t r = 0; r < chunk.size(); r++)
+                all.append(chunk.featureRow(r), chunk.labelRow(r));
+        }
+
+        return all;
+    }
+
+    void testCsv(const TempDirectory& directory) {
+        std::string path = directory.file("data.csv");
+        writeText(path, "a,b,c,label\n"
+                        "1, 2, 3, 0\n"
+                        "\n"
+                        "4,5,6,+1\r\n"
+                        "   \n"
+                        "-7,8.5,9e1,0\n");
+
+        std::unique_ptr<DatasetStream> stream = DatasetStream::csv(path, 1, 2, true);
+        CHECK(stream->featureSize() == 3);
+        CHECK(stream->labelSize() == 1);
+
+        Dataset rows = readAll(*stream);
+        CHECK(rows.size() == 3);
+        CHECK(rows.featureRow(0)[1] == 2.0f && rows.labelRow(0)[0] == 0.0f);
+        CHECK(rows.featureRow(1)[2] == 6.0f && rows.labelRow(1)[0] == 1.0f);
+        CHECK(rows.featureRow(2)[0] == -7.0f && rows.featureRow(2)[1] == 8.5f && rows.featureRow(2)[2] == 90.0f);
+
+        // Rewinding starts over at the first example after the header
+        stream->rewind();
+        Dataset again = readAll(*stream);
+        CHECK(again.size() == 3);
+        CHECK(again.featureRow(0)[0] == 1.0f);
+
+        // Without the header flag the header line is parsed as data and rejected
+        CHECK(throws<std::invalid_argument>([&] { DatasetStream::csv(path, 1, 2, false); }));
+
+        std::string labelsOnly = directory.file("labels_only.csv");
+        writeText(labelsOnly, "1,2\n3,4\n");
+        CHECK(throws<std::invalid_argument>([&] { DatasetStream::csv(labelsOnly, 2, 2); }));
+
+        CHECK(throws<std::runtime_error>([&] { DatasetStream::csv(directory.file("missing.csv"), 1, 2); }));
+    }
+
+    // Errors after the first row surface from the prefetch thread, after the good chunks before them
+    void testCsvErrors(const TempDirectory& directory) {
+        std::string path = directory.file("wrong_columns.csv");
+        writeText(path, "1,2,0\n3,4,1\n5,6,0\n7,8\n9,10,1\n");
+
+        std::unique_ptr<DatasetStream> stream = DatasetStream::csv(path, 1, 2);
+        Dataset chunk(2, 1);
+
+        CHECK(stream->next(chunk) && chunk.size() == 2);
+        CHECK(throws<std::invalid_argument>([&] { readAll(*stream); }));
+
+        // A rewind restarts the reader, so the good rows come back before the same error
+        stream->rewind();
+        CHECK(stream->next(chunk) && chunk.size() == 2);
+        CHECK(throws<std::invalid_argument>([&] { readAll(*stream); }));
+
+        std::string malformed = directory.file("malformed.csv");
+        writeText(malformed, "1,2,0\n3,x,1\n");
+        std::unique_ptr<DatasetStream> bad = DatasetStream::csv(malformed, 1, 8);
+        CHECK(throws<std::invalid_argument>([&] { readAll(*bad); }));
+    }
+
+    void testIdx(const TempDirectory& directory) {
+        std::string images = directory.file("images.idx");
+        std::string labels = directory.file("labels.idx");
+
+        // Three 2x2 images and their class indices
+        writeIdx(images, { 3, 2, 2 }, { 0, 255, 51, 102, 1, 2, 3, 4, 255, 255, 0, 0 });
+        writeIdx(labels, { 3 }, { 0, 2, 1 });
+
+        std::unique_ptr<DatasetStream> stream = DatasetStream::idx(images, labels, 3, 2, 1.0f / 255.0f);
+        CHECK(stream->featureSize() == 4);
+        CHECK(stream->labelSize() == 3);
+
+        Dataset rows = readAll(*stream);
+        CHECK(rows.size() == 3);
+        CHECK(close(rows.featureRow(0)[1], 1.0f, 1e-6f) && close(rows.featureRow(0)[2], 0.2f, 1e-6f));
+
+        const float oneHot[3][3] = { { 1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } };
+        for (size_t r = 0; r < 3; r++)
+            for (int c = 0; c < 3; c++)
+                CHECK_MSG(rows.labelRow(r)[c] == oneHot[r][c], "one-hot label row " + std::to_string(r));
+
+        stream->rewind();
+        CHECK(readAll(*stream).size() == 3);
+
+        // Label rows with more than one dimension are read as values and the class count is ignored
+        std::string valueLabels = directory.file("value_labels.idx");
+        writeIdx(valueLabels, { 3, 2 }, { 1, 2, 3, 4, 5, 6 });
+        std::unique_ptr<DatasetStream> values = DatasetStream::idx(images, valueLabels, 0, 4);
+        Dataset valueRows = readAll(*values);
+        CHECK(values->labelSize() == 2 && valueRows.labelRow(2)[1] == 6.0f);
+
+        std::string outOfRange = directory.file("out_of_range.idx");
+        writeIdx(outOfRange, { 3 }, { 0, 3, 1 });
+        std::unique_ptr<DatasetStream> bad = DatasetStream::idx(images, outOfRange, 3, 8);
+        CHECK(throws<std::invalid_argument>([&] { readAll(*bad); }));
+
+        std::string shortLabels = directory.file("short_labels.idx");
+        writeIdx(shortLabels, { 2 }, { 0, 1 });
+        CHECK(throws<std::invalid_argument>([&] { DatasetStream::idx(images, shortLabels, 3, 8); }));
+
+        std::string notIdx = directory.file("not_idx.idx");
+        writeText(notIdx, "BBDNN");
+        CHECK(throws<std::invalid_argument>([&] { DatasetStream::idx(notIdx, labels, 3, 8); }));
+
+        // The header promises more images than the file holds
+        std::string truncated = directory.file("truncated.idx");
+        writeIdx(truncated, { 3, 2, 2 }, { 1, 2, 3, 4, 5 });
+        std::unique_ptr<DatasetStream> cut = DatasetStream::idx(truncated, labels, 3, 8);
+        CHECK(throws<std::runtime_error>([&] { readAll(*cut); }));
+    }
+
+    void testSaveAndMap(const TempDirectory& directory) {
+        Dataset data(3, 2);
+        for (int i = 0; i < 10; i++) {
+            float features[] = { static_cast<float>(i), i * 0.5f, -1.0f * i };
+            float labels[] = { i % 2 == 0 ? 1.0f : 0.0f, static_cast<float>(i * i) };
+            data.append(features, labels);
+        }
+
+        std::string path = directory.file("data.bbdnnd");
+        data.save(path);
+
+        Dataset mapped = Dataset::map(path);
+        CHECK(mapped.isMapped());
+        CHECK(mapped.size() == data.size());
+        CHECK(mapped.featureSize() == 3 && mapped.labelSize() == 2);
+
+        bool identical = true;
+        for (size_t r = 0; r < data.size(); r++) {
+            for (int c = 0; c < 3; c++)
+                identical = identical && mapped.featureRow(r)[c] == data.featureRow(r)[c];
+            for (int c = 0; c < 2; c++)
+                identical = identical && mapped.labelRow(r)[c] == data.labelRow(r)[c];
+        }
+        CHECK(identical);
+
+        // Mapped rows are read-only, and a batch view reads them in place
+        CHECK(throws<std::exception>([&] { mapped.append(data.featureRow(0), data.labelRow(0)); }));
+        CHECK(mapped.featureRows(4, 3)(2, 0) == 6.0f);
+
+        // Copies share the mapping, which outlives the original
+        Dataset copy = mapped;
+        mapped = Dataset(3, 2);
+        CHECK(copy.isMapped() && copy.labelRow(9)[1] == 81.0f);
+
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        std::string broken = directory.file("broken.bbdnnd");
+        std::ofstream(broken, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 4));
+        CHECK(throws<std::invalid_argument>([&] { Dataset::map(broken); }));
+
+        bytes[0] = 'X';
+        std::ofstream(broken, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        CHECK(throws<std::invalid_argument>([&] { Dataset::map(broken); }));
+    }
+
+}
+
+int main() {
+    TempDirectory directory("bbdnn_dataset_test");
+
+    testCsv(directory);
+    testCsvErrors(directory);
+    testIdx(directory);
+    testSaveAndMap(directory);
+
+    return report("dataset_test");
+}
@@ -0,0 +1,425 @@
+#include "bbdnn/Simd.hpp"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// Every SIMD kernel table available on this machine checked against the scalar table, or against a double
+// precision reference where the kernels reorder sums
+using namespace bbdnn;
+using namespace bbdnn::test;
+using kernels::KernelTable;
+using kernels::SimdLevel;
+
+namespace {
+
+    // Lengths around every vector width and unroll factor, so the main loops and the tails are both covered
+    const size_t LENGTHS[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 257, 1000 };
+
+    std::mt19937 rng(2024);
+
+    std::vector<float> randomValues(size_t n, float scale = 1.0f) {
+        std::normal_distribution<float> distribution(0.0f, scale);
+        std::vector<float> values(n);
+        for (float& value : values)
+            value = distribution(rng);
+
+        return values;
+    }
+
+    // Compare out against expected elementwise, reporting the first mismatch only
+    void checkClose(const std::vector<float>& out, const std::vector<float>& expected, float tolerance, const std::string& what) {
+        for (size_t i = 0; i < out.size(); i++) {
+            if (!close(out[i], expected[i], tolerance)) {
+                CHECK_MSG(false, what + " differs at " + std::to_string(i) + ": " + std::to_string(out[i]) + " vs " + std::to_string(expected[i]));
+                return;
+            }
+        }
+    }
+
+    void testElementwise(const KernelTable& table, const KernelTable& scalar, const std::string& name) {
+        for (size_t n : LENGTHS) {
+            std::vector<float> a = randomValues(n), b = randomValues(n);
+            std::vector<float> out(n), expected(n);
+            std::string suffix = " n=" + std::to_string(n) + " " + name;
+
+            table.add(a.data(), b.data(), out.data(), n);
+            scalar.add(a.data(), b.data(), expected.data(), n);
+            checkClose(out, expected, 0.0f, "add" + suffix);
+
+            table.sub(a.data(), b.data(), out.data(), n);
+            scalar.sub(a.data(), b.data(), expected.data(), n);
+            checkClose(out, expected, 0.0f, "sub" + suffix);
+
+            table.mul(a.data(), b.data(), out.data(), n);
+            scalar.mul(a.data(), b.data(), expected.data(), n);
+            checkClose(out, expected, 0.0f, "mul" + suffix);
+
+            table.scale(a.data(), 1.7f, out.data(), n);
+            scalar.scale(a.data(), 1.7f, expected.data(), n);
+            checkClose(out, expected, 0.0f, "scale" + suffix);
+
+            table.divide(a.data(), 3.1f, out.data(), n);
+            scalar.divide(a.data(), 3.1f, expected.data(), n);
+            checkClose(out, expected, 0.0f, "divide" + suffix);
+
+            // FMA contracts the multiply-add, so axpy may round once less than the scalar loop
+            out = b;
+            expected = b;
+            table.axpy(0.3f, a.data(), out.data(), n);
+            scalar.axpy(0.3f, a.data(), expected.data(), n);
+            checkClose(out, expected, 1e-6f, "axpy" + suffix);
+
+            // Documented bit-identical across instruction sets
+            float sum = table.sum(a.data(), n);
+            float expectedSum = scalar.sum(a.data(), n);
+            CHECK_MSG(sum == expectedSum, "sum" + suffix + " is not bit-identical to the scalar sum");
+        }
+    }
+
+    void testActivations(const KernelTable& table, const KernelTable& scalar, const std::string& name) {
+        const ActivationKind kinds[] = { ActivationKind::Linear, ActivationKind::ReLU, ActivationKind::LeakyReLU, ActivationKind::Sigmoid,
+                                         ActivationKind::Logistic, ActivationKind::Tanh };
+
+        for (ActivationKind kind : kinds) {
+            // LeakyReLU alpha in p0, Logistic L and K in p0 and p1
+            float p0 = kind == ActivationKind::Logistic ? 2.0f : 0.01f;
+            float p1 = kind == ActivationKind::Logistic ? 1.5f : 0.0f;
+
+            for (size_t n : LENGTHS) {
+                std::vector<float> in = randomValues(n, 6.0f);
+                std::vector<float> out(n), expected(n);
+                std::string suffix = " kind=" + std::to_string(static_cast<int>(kind)) + " n=" + std::to_string(n) + " " + name;
+
+                table.activate(kind, p0, p1, in.data(), out.data(), n);
+                scalar.activate(kind, p0, p1, in.data(), expected.data(), n);
+                checkClose(out, expected, 1e-5f, "activate" + suffix);
+
+                table.activateDerivative(kind, p0, p1, in.data(), out.data(), n);
+                scalar.activateDerivative(kind, p0, p1, in.data(), expected.data(), n);
+                checkClose(out, expected, 1e-5f, "activateDerivative" + suffix);
+            }
+        }
+    }
+
+    // Past the range of the exp approximation sigmoid and tanh saturate instead of stopping at the clamp,
+    // and NaN inputs stay NaN
+    void testActivationLimits(const KernelTable& table, const std::string& name) {
+        const float inf = std::numeric_limits<float>::infinity();
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        // Nine values, so a vector register and a padded tail both see them
+        std::vector<float> in = { -100.0f, 100.0f, nan, -inf, inf, -90.0f, 90.0f, 0.0f, nan };
+        std::vector<float> out(in.size());
+
+        table.activate(ActivationKind::Sigmoid, 0.0f, 0.0f, in.data(), out.data(), in.size());
+        CHECK_MSG(out[0] < 1e-40f && out[5] < 1e-38f && out[3] == 0.0f, "sigmoid underflow " + name);
+        CHECK_MSG(out[1] == 1.0f && out[6] == 1.0f && out[4] == 1.0f, "sigmoid saturation " + name);
+        CHECK_MSG(std::isnan(out[2]) && std::isnan(out[8]), "sigmoid NaN " + name);
+        CHECK_MSG(out[7] == 0.5f, "sigmoid(0) " + name);
+
+        table.activate(ActivationKind::Tanh, 0.0f, 0.0f, in.data(), out.data(), in.size());
+        CHECK_MSG(out[0] == -1.0f && out[3] == -1.0f && out[1] == 1.0f && out[4] == 1.0f, "tanh saturation " + name);
+        CHECK_MSG(std::isnan(out[2]) && std::isnan(out[8]), "tanh NaN " + name);
+    }
+
+    void testOptimizers(const KernelTable& table, const KernelTable& scalar, const std::string& name) {
+        const OptimizerKind kinds[] = { OptimizerKind::SGD, OptimizerKind::Momentum, OptimizerKind::Nesterov, OptimizerKind::RMSProp,
+                                        OptimizerKind::Adam, OptimizerKind::AdamW };
+
+        OptimizerStep step;
+        step.learningRate = 0.01f;
+        step.decay1 = 0.9f;
+        step.decay2 = 0.999f;
+        step.epsilon = 1e-8f;
+        step.weightDecay = 0.01f;
+        step.correction1 = 1.0f / (1.0f - 0.9f * 0.9f);
+        step.correction2 = 1.0f / (1.0f - 0.999f * 0.999f);
+
+        for (OptimizerKind kind : kinds) {
+            for (size_t n : LENGTHS) {
+                std::vector<float> params = randomValues(n), grads = randomValues(n);
+                std::vector<float> state0 = randomValues(n, 0.1f), state1 = randomValues(n, 0.1f);
+                for (float& value : state1)
+                    value = value * value;
+
+                std::vector<float> expectedParams = params, expectedState0 = state0, expectedState1 = state1;
+                std::string suffix = " kind=" + std::to_string(static_cast<int>(kind)) + " n=" + std::to_string(n) + " " + name;
+
+                table.optimize(kind, step, params.data(), grads.data(), state0.data(), state1.data(), n);
+                scalar.optimize(kind, step, expectedParams.data(), grads.data(), expectedState0.data(), expectedState1.data(), n);
+
+                checkClose(params, expectedParams, 1e-5f, "optimize params" + suffix);
+                checkClose(state0, expectedState0, 1e-5f, "optimize state0" + suffix);
+                checkClose(state1, expectedState1, 1e-5f, "optimize state1" + suffix);
+            }
+        }
+    }
+
+    // One step of a built-in rule in double precision, written from the formulas in Optimizers.hpp; t is the
+    // 1-based step number for Adam's bias corrections
+    void referenceStep(OptimizerKind kind, double lr, double decay1, double decay2, double epsilon, double weightDecay, int t,
+                       double& w, double g, double& s0, double& s1) {
+        switch (kind) {
+            case OptimizerKind::Momentum:
+                s0 = decay1 * s0 + g;
+                w -= lr * s0;
+                break;
+            case OptimizerKind::Nesterov:
+                s0 = decay1 * s0 + g;
+                w -= lr * (g + decay1 * s0);
+                break;
+            case OptimizerKind::RMSProp:
+                s0 = decay1 * s0 + (1 - decay1) * g * g;
+                w -= lr * g / (std::sqrt(s0) + epsilon);
+                break;
+            case OptimizerKind::Adam:
+            case OptimizerKind::AdamW: {
+                s0 = decay1 * s0 + (1 - decay1) * g;
+                s1 = decay2 * s1 + (1 - decay2) * g * g;
+                double m = s0 / (1 - std::pow(decay1, t));
+                double v = s1 / (1 - std::pow(decay2, t));
+                double lambda = kind == OptimizerKind::AdamW ? weightDecay : 0.0;
+                w -= lr * (m / (std::sqrt(v) + epsilon) + lambda * w);
+                break;
+            }
+            default:
+                w -= lr * g;
+                break;
+        }
+    }
+
+    // The fused kernels over several steps, with the step scalars from the optimizers themselves, against the
+    // double reference, so a formula shared by every table (the scalar one included) is checked too
+    void testOptimizerReference(const KernelTable& table, const std::string& name) {
+        struct Rule {
+            OptimizerPtr optimizer;
+            double decay1, decay2, epsilon, weightDecay;
+        };
+
+        Rule rules[] = {
+            { Optimizer::SGD(), 0, 0, 0, 0 },
+            { Optimizer::Momentum(0.8f), 0.8, 0, 0, 0 },
+            { Optimizer::Nesterov(0.7f), 0.7, 0, 0, 0 },
+            { Optimizer::RMSProp(0.95f, 1e-6f), 0.95, 0, 1e-6, 0 },
+            { Optimizer::Adam(0.85f, 0.99f, 1e-6f), 0.85, 0.99, 1e-6, 0 },
+            { Optimizer::AdamW(0.9f, 0.995f, 1e-7f, 0.05f), 0.9, 0.995, 1e-7, 0.05 },
+        };
+
+        const float learningRate = 0.01f;
+        const int STEPS = 4;
+        const size_t n = 37;
+
+        for (Rule& rule : rules) {
+            OptimizerKind kind = rule.optimizer->kind();
+            int states = rule.optimizer->stateCount();
+
+            std::vector<float> params = randomValues(n);
+            std::vector<float> state0(n, 0.0f), state1(n, 0.0f);
+            std::vector<double> expectedParams(params.begin(), params.end());
+            std::vector<double> expectedState0(n, 0.0), expectedState1(n, 0.0);
+
+            for (int t = 1; t <= STEPS; t++) {
+                std::vector<float> grads = randomValues(n);
+                OptimizerStep step = rule.optimizer->beginStep(learningRate);
+
+                table.optimize(kind, step, params.data(), grads.data(), states > 0 ? state0.data() : nullptr,
+                               states > 1 ? state1.data() : nullptr, n);
+
+                for (size_t i = 0; i < n; i++)
+                    referenceStep(kind, learningRate, rule.decay1, rule.decay2, rule.epsilon, rule.weightDecay, t,
+                                  expectedParams[i], grads[i], expectedState0[i], expectedState1[i]);
+            }
+
+            std::string suffix = " kind=" + std::to_string(static_cast<int>(kind)) + " " + name;
+            checkClose(params, std::vector<float>(expectedParams.begin(), expectedParams.end()), 1e-5f, "optimizer reference params" + suffix);
+
+            if (states > 0)
+                checkClose(state0, std::vector<float>(expectedState0.begin(), expectedState0.end()), 1e-5f, "optimizer reference state0" + suffix);
+            if (states > 1)
+                checkClose(state1, std::vector<float>(expectedState1.begin(), expectedState1.end()), 1e-5f, "optimizer reference state1" + suffix);
+        }
+    }
+
+    void testPrecision(const KernelTable& table, const KernelTable& scalar, const std::string& name) {
+        for (WeightPrecision precision : { WeightPrecision::BFloat16, WeightPrecision::Float16 }) {
+            for (size_t n : LENGTHS) {
+                std::vector<float> in = randomValues(n, 10.0f);
+                std::vector<uint16_t> narrowed(n), expectedNarrowed(n);
+                std::string suffix = " precision=" + std::to_string(static_cast<int>(precision)) + " n=" + std::to_string(n) + " " + name;
+
+                // Round to nearest even is exact, so both directions must match bit for bit
+                table.narrow(precision, in.data(), narrowed.data(), n);
+                scalar.narrow(precision, in.data(), expectedNarrowed.data(), n);
+                CHECK_MSG(narrowed == expectedNarrowed, "narrow" + suffix);
+
+                std::vector<float> out(n), expected(n);
+                table.widen(precision, expectedNarrowed.data(), out.data(), n);
+                scalar.widen(precision, expectedNarrowed.data(), expected.data(), n);
+                checkClose(out, expected, 0.0f, "widen" + suffix);
+            }
+        }
+    }
+
+    // y = x^T W for a rows x n row-major W, in double precision
+    std::vector<float> referenceGemv(const std::vector<float>& x, const std::vector<float>& w, size_t rows, size_t n) {
+        std::vector<float> y(n);
+        for (size_t c = 0; c < n; c++) {
+            double sum = 0.0;
+            for (size_t r = 0; r < rows; r++)
+                sum += static_cast<double>(x[r]) * w[r * n + c];
+
+            y[c] = static_cast<float>(sum);
+        }
+
+        return y;
+    }
+
+    void testGemv(const KernelTable& table, const std::string& name) {
+        for (size_t rows : { 1, 5, 16, 33 }) {
+            for (size_t n : { 1, 7, 16, 31, 64, 100 }) {
+                std::vector<float> x = randomValues(rows), w = randomValues(rows * n);
+                std::vector<float> expected = referenceGemv(x, w, rows, n);
+                std::string suffix = " rows=" + std::to_string(rows) + " n=" + std::to_string(n) + " " + name;
+
+                // gemvRows reads W^T, one dot product per output
+                std::vector<float> transposed(n * rows);
+                for (size_t r = 0; r < rows; r++)
+                    for (size_t c = 0; c < n; c++)
+                        transposed[c * rows + r] = w[r * n + c];
+
+                std::vector<float> y(n, 0.0f);
+                table.gemvRows(x.data(), transposed.data(), rows, y.data(), n, rows);
+                checkClose(y, expected, 1e-5f, "gemvRows" + suffix);
+
+                // Pack W into panels of panelWidth columns, zero past column n
+                size_t width = table.panelWidth;
+                size_t panelCount = (n + width - 1) / width;
+                std::vector<float> panels(panelCount * width * rows, 0.0f);
+                for (size_t p = 0; p < panelCount; p++)
+                    for (size_t r = 0; r < rows; r++)
+                        for (size_t c = p * width; c < std::min(n, (p + 1) * width); c++)
+                            panels[(p * rows + r) * width + c - p * width] = w[r * n + c];
+
+                std::fill(y.begin(), y.end(), 0.0f);
+                table.gemvPanels(x.data(), panels.data(), y.data(), rows, n);
+                checkClose(y, expected, 1e-5f, "gemvPanels" + suffix);
+
+                // Linear denseForward is the same product plus the bias
+                std::vector<float> bias = randomValues(n), z(n), a(n);
+                table.denseForward(ActivationKind::Linear, 0.0f, 0.0f, x.data(), panels.data(), bias.data(), z.data(), a.data(), rows, n);
+                for (size_t c = 0; c < n; c++)
+                    expected[c] += bias[c];
+
+                checkClose(z, expected, 1e-5f, "denseForward z" + suffix);
+                checkClose(a, expected, 1e-5f, "denseForward a" + suffix);
+            }
+        }
+    }
+
+    void testDenseBackward(const KernelTable& table, const std::string& name) {
+        const float scale = 0.37f;
+
+        for (size_t batch : { 1, 3, 17 }) {
+            for (size_t rows : { 1, 5, 8, 33 }) {
+                for (size_t n : { 1, 7, 16, 300 }) {
+                    for (bool accumulate : { false, true }) {
+                        std::vector<float> x = randomValues(batch * rows), delta = randomValues(batch * n), w = randomValues(rows * n);
+                        std::vector<float> derivatives = randomValues(batch * rows), gradient = randomValues(rows * n);
+                        std::vector<float> sensitivity(batch * rows);
+                        std::vector<float> expectedGradient(rows * n), expectedSensitivity(batch * rows);
+                        std::string suffix = " batch=" + std::to_string(batch) + " rows=" + std::to_string(rows) + " n=" + std::to_string(n) +
+                                             (accumulate ? " accumulate " : " ") + name;
+
+                        for (size_t r = 0; r < rows; r++) {
+                            for (size_t c = 0; c < n; c++) {
+                                double sum = accumulate ? gradient[r * n + c] : 0.0;
+                                for (size_t b = 0; b < batch; b++)
+                                    sum += static_cast<double>(scale) * x[b * rows + r] * delta[b * n + c];
+
+                                expectedGradient[r * n + c] = static_cast<float>(sum);
+                            }
+                        }
+
+                        for (size_t b = 0; b < batch; b++) {
+                            for (size_t r = 0; r < rows; r++) {
+                                double sum = 0.0;
+                                for (size_t c = 0; c < n; c++)
+                                    sum += static_cast<double>(w[r * n + c]) * delta[b * n + c];
+
+                                expectedSensitivity[b * rows + r] = static_cast<float>(sum * derivatives[b * rows + r]);
+                            }
+                        }
+
+                        std::vector<float> gradientOnly = gradient;
+
+                        table.denseBackward(x.data(), delta.data(), w.data(), derivatives.data(), scale, accumulate, gradient.data(),
+                                            sensitivity.data(), batch, rows, n);
+                        checkClose(gradient, expectedGradient, 1e-4f, "denseBackward gradient" + suffix);
+                        checkClose(sensitivity, expectedSensitivity, 1e-4f, "denseBackward sensitivity" + suffix);
+
+                        // A null sensitivity skips the second product without changing the gradient
+                        table.denseBackward(x.data(), delta.data(), w.data(), derivatives.data(), scale, accumulate, gradientOnly.data(),
+                                            nullptr, batch, rows, n);
+                        checkClose(gradientOnly, expectedGradient, 1e-4f, "denseBackward without sensitivity" + suffix);
+                    }
+                }
+            }
+        }
+    }
+
+    void testInt8(const KernelTable& table, const std::string& name) {
+        std::uniform_int_distribution<int> distribution(-127, 127);
+
+        for (size_t rows : { 1, 3, 16 }) {
+            for (size_t k : { 64, 128, 320 }) {
+                std::vector<int8_t> x(k), w(rows * k);
+                for (int8_t& value : x)
+                    value = static_cast<int8_t>(distribution(rng));
+                for (int8_t& value : w)
+                    value = static_cast<int8_t>(distribution(rng));
+
+                std::vector<int32_t> out(rows), expected(rows, 0);
+                for (size_t r = 0; r < rows; r++)
+                    for (size_t i = 0; i < k; i++)
+                        expected[r] += x[i] * w[r * k + i];
+
+                // Exact in int32, so no tolerance
+                table.gemvInt8(x.data(), w.data(), out.data(), rows, k);
+                CHECK_MSG(out == expected, std::string("gemvInt8 (") + table.gemvInt8Name + ") rows=" + std::to_string(rows) +
+                                           " k=" + std::to_string(k) + " " + name);
+            }
+        }
+    }
+
+}
+
+int main() {
+    const KernelTable& scalar = kernels::kernelTable(SimdLevel::Scalar);
+    const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON };
+
+    for (SimdLevel level : levels) {
+        if (!kernels::isSimdLevelAvailable(level))
+            continue;
+
+        const KernelTable& table = kernels::kernelTable(level);
+        std::string name = kernels::simdLevelName(level);
+
+        testElementwise(table, scalar, name);
+        testActivations(table, scalar, name);
+        testActivationLimits(table, name);
+        testOptimizers(table, scalar, name);
+        testOptimizerReference(table, name);
+        testPrecision(table, scalar, name);
+        testGemv(table, name);
+        testDenseBackward(table, name);
+        testInt8(table, name);
+
+        std::cout << "checked " << name << " kernels" << std::endl;
+    }
+
+    return report("kernel_test");
+}
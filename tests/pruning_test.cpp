@@ -0,0 +1,125 @@
+#include "bbdnn/Optimizers.hpp"
+#include "bbdnn/Pruning.hpp"
+#include "TestCheck.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+// Structured pruning at threshold 0 keeps predictions, folding constant neurons into the next biases, and
+// fine-tuning sparse connections keeps the pruned weights at zero
+using namespace bbdnn;
+using namespace bbdnn::test;
+
+namespace {
+
+    NeuralNetwork makeNetwork() {
+        return NeuralNetwork(11, {
+            DenseLayer(5, Activation::Linear()),
+            DenseLayer(32, Activation::Tanh()),
+            DenseLayer(24, Activation::Logistic(1.0f, 1.0f)),
+            DenseLayer(2, Activation::Linear()),
+        });
+    }
+
+    void makeData(std::vector<Vector>& features, std::vector<Vector>& labels, int count) {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        for (int i = 0; i < count; i++) {
+            Vector feature(5);
+            for (int j = 0; j < feature.size(); j++)
+                feature[j] = distribution(rng);
+
+            features.push_back(feature);
+            labels.push_back(Vector { feature[0] - feature[3], feature[1] * feature[2] });
+        }
+    }
+
+    bool closePredictions(const NeuralNetwork& a, const NeuralNetwork& b, const std::vector<Vector>& inputs, float tolerance) {
+        for (const Vector& input : inputs) {
+            Vector x = a.predict(input);
+            Vector y = b.predict(input);
+
+            for (int i = 0; i < x.size(); i++)
+                if (!close(x[i], y[i], tolerance))
+                    return false;
+        }
+
+        return true;
+    }
+
+    void testNeuronsAtZeroThreshold(const std::vector<Vector>& features, const std::vector<Vector>& labels) {
+        NeuralNetwork network = makeNetwork();
+        network.train(features, labels, 0.05f, 3, true);
+
+        // Nothing has a zero outgoing norm, so threshold 0 removes no neuron and changes nothing
+        auto [same, unchanged] = pruneNeurons(network, 0.0f);
+        CHECK(unchanged.prunedNeurons == 0 && unchanged.prunedWeights == 0);
+        CHECK(same.getLayer(1).size() == 32 && same.getLayer(2).size() == 24);
+        CHECK(closePredictions(network, same, features, 0.0f));
+
+        // Cut every input to hidden neurons 3 and 17, and to neuron 5 of the next layer: they output a
+        // constant, which pruning at threshold 0 folds into the next layer's biases
+        std::vector<Matrix> weights;
+        std::vector<Vector> biases;
+        for (const LayerConnection& connection : network.getConnections()) {
+            weights.push_back(connection.getWeights());
+            biases.emplace_back(connection.getBiases());
+        }
+
+        for (int i = 0; i < weights[0].Rows(); i++)
+            weights[0].at(i, 3) = weights[0].at(i, 17) = 0.0f;
+        for (int i = 0; i < weights[1].Rows(); i++)
+            weights[1].at(i, 5) = 0.0f;
+
+        network.updateParameters(std::move(weights), std::move(biases));
+
+        auto [pruned, report] = pruneNeurons(network, 0.0f);
+        CHECK(report.prunedNeurons == 3);
+        CHECK(pruned.getLayer(1).size() == 30 && pruned.getLayer(2).size() == 23);
+        CHECK(pruned.size() == network.size());
+        CHECK(closePredictions(network, pruned, features, 1e-5f));
+    }
+
+    // Connections pruned below the crossover read CSR weights, and their training steps must leave the pruned
+    // weights at zero whichever rule updates them
+    void testFineTuningKeepsPrunedWeights(const std::vector<Vector>& features, const std::vector<Vector>& labels) {
+        OptimizerPtr optimizers[] = { Optimizer::SGD(), Optimizer::Momentum(), Optimizer::Adam() };
+        const char* names[] = { "SGD", "Momentum", "Adam" };
+
+        for (int o = 0; o < 3; o++) {
+            NeuralNetwork network = makeNetwork();
+            network.setOptimizer(std::move(optimizers[o]));
+            network.train(features, labels, 0.05f, 2, true);
+
+            PruningReport report = pruneToSparsity(network, 0.95f);
+            CHECK_MSG(report.sparseConnections > 0, std::string("no sparse connection with ") + names[o]);
+
+            std::vector<float> densities;
+            for (const LayerConnection& connection : network.getConnections())
+                densities.push_back(connection.density());
+
+            network.trainMinibatch(features, labels, 0.01f, 3, 8);
+
+            const std::vector<LayerConnection>& connections = network.getConnections();
+            for (size_t l = 0; l < connections.size(); l++) {
+                if (!connections[l].isSparse())
+                    continue;
+
+                CHECK_MSG(connections[l].density() == densities[l],
+                          "density of sparse connection " + std::to_string(l) + " changed with " + names[o]);
+            }
+        }
+    }
+
+}
+
+int main() {
+    std::vector<Vector> features, labels;
+    makeData(features, labels, 48);
+
+    testNeuronsAtZeroThreshold(features, labels);
+    testFineTuningKeepsPrunedWeights(features, labels);
+
+    return report("pruning_test");
+}
@@ -0,0 +1,146 @@
+#include "bbdnn/Pruning.hpp"
+#include "bbdnn/Serialization.hpp"
+#include "TestCheck.hpp"
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Model files round-trip a trained network exactly, through loadModel and MappedModel alike, malformed files
+// are rejected, and training a mapped model leaves its file untouched
+using namespace bbdnn;
+using namespace bbdnn::test;
+
+namespace {
+
+    NeuralNetwork makeNetwork() {
+        return NeuralNetwork(3, {
+            DenseLayer(6, Activation::Linear()),
+            DenseLayer(24, Activation::LeakyReLU(0.05f)),
+            DenseLayer(16, Activation::Tanh()),
+            DenseLayer(3, Activation::Logistic(2.0f, 1.5f)),
+        });
+    }
+
+    void makeData(std::vector<Vector>& features, std::vector<Vector>& labels, int count) {
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        for (int i = 0; i < count; i++) {
+            Vector feature(6);
+            for (int j = 0; j < feature.size(); j++)
+                feature[j] = distribution(rng);
+
+            features.push_back(feature);
+            labels.push_back(Vector { feature[0] * feature[1], 0.5f, feature[2] > 0.0f ? 1.0f : 0.0f });
+        }
+    }
+
+    bool samePredictions(const NeuralNetwork& a, const NeuralNetwork& b, const std::vector<Vector>& inputs) {
+        for (const Vector& input : inputs) {
+            Vector x = a.predict(input);
+            Vector y = b.predict(input);
+
+            for (int i = 0; i < x.size(); i++)
+                if (x[i] != y[i])
+                    return false;
+        }
+
+        return true;
+    }
+
+    std::vector<char> readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& path, const std::vector<char>& bytes) {
+        std::ofstream out(path, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    void testRoundTrip(const TempDirectory& directory, const std::vector<Vector>& features, const std::vector<Vector>& labels) {
+        NeuralNetwork network = makeNetwork();
+        network.train(features, labels, 0.05f, 5, true);
+
+        std::string path = directory.file("trained.bbdnn");
+        saveModel(network, path);
+
+        NeuralNetwork loaded = loadModel(path);
+        CHECK(loaded.size() == network.size());
+        CHECK(loaded.seed() == network.seed());
+        CHECK(samePredictions(network, loaded, features));
+
+        MappedModel mapped(path);
+        CHECK(samePredictions(network, mapped.network(), features));
+
+        // A pruned model comes back reading the same CSR weights
+        pruneToSparsity(network, 0.95f);
+        saveModel(network, path);
+        NeuralNetwork pruned = loadModel(path);
+        CHECK(samePredictions(network, pruned, features));
+
+        for (int l = 0; l < network.size() - 1; l++)
+            CHECK(pruned.getConnections()[l].isSparse() == network.getConnections()[l].isSparse());
+    }
+
+    void testRejectsMalformedFiles(const TempDirectory& directory) {
+        std::string path = directory.file("model.bbdnn");
+        saveModel(makeNetwork(), path);
+        std::vector<char> bytes = readFile(path);
+
+        std::string broken = directory.file("broken.bbdnn");
+
+        // Cut inside the header and inside the parameter blobs
+        for (size_t length : { size_t(10), bytes.size() / 2, bytes.size() - 1 }) {
+            writeFile(broken, std::vector<char>(bytes.begin(), bytes.begin() + length));
+            CHECK_MSG(throws<std::invalid_argument>([&] { loadModel(broken); }), "truncated to " + std::to_string(length) + " bytes");
+            CHECK_MSG(throws<std::invalid_argument>([&] { MappedModel model(broken); }), "mapped, truncated to " + std::to_string(length) + " bytes");
+        }
+
+        std::vector<char> badMagic = bytes;
+        badMagic[0] = 'X';
+        writeFile(broken, badMagic);
+        CHECK(throws<std::invalid_argument>([&] { loadModel(broken); }));
+        CHECK(throws<std::invalid_argument>([&] { MappedModel model(broken); }));
+
+        // Version follows the 8-byte magic
+        std::vector<char> badVersion = bytes;
+        badVersion[8] = static_cast<char>(MODEL_FORMAT_VERSION + 1);
+        writeFile(broken, badVersion);
+        CHECK(throws<std::invalid_argument>([&] { loadModel(broken); }));
+
+        CHECK(throws<std::runtime_error>([&] { loadModel(directory.file("missing.bbdnn")); }));
+    }
+
+    void testMappedTrainingKeepsFile(const TempDirectory& directory, const std::vector<Vector>& features, const std::vector<Vector>& labels) {
+        std::string path = directory.file("mapped.bbdnn");
+        saveModel(makeNetwork(), path);
+        std::vector<char> before = readFile(path);
+
+        {
+            MappedModel mapped(path);
+            mapped.network().train(features, labels, 0.05f, 3, true);
+
+            NeuralNetwork original = loadModel(path);
+            CHECK(!samePredictions(original, mapped.network(), features));
+        }
+
+        CHECK(readFile(path) == before);
+    }
+
+}
+
+int main() {
+    TempDirectory directory("bbdnn_serialization_test");
+
+    std::vector<Vector> features, labels;
+    makeData(features, labels, 40);
+
+    testRoundTrip(directory, features, labels);
+    testRejectsMalformedFiles(directory);
+    testMappedTrainingKeepsFile(directory, features, labels);
+
+    return report("serialization_test");
+}
@@ -0,0 +1,126 @@
+#include "bbdnn/NeuralNetwork.hpp"
+#include "AllocationCounter.hpp"
+#include "TestCheck.hpp"
+#include "bbdnn/Dataset.hpp"
+#include <vector>
+
+// Once the gradient workspace is warm, training makes no heap allocation per example: a run over more
+// epochs allocates exactly as much as a run over one
+using namespace bbdnn;
+using namespace bbdnn::test;
+
+namespace {
+
+    // Keeps nothing, so the count covers only the training loop itself
+    struct DiscardSink : IMetricsSink {
+        bool endEpoch(const EpochMetrics&) override { return true; }
+    };
+
+    NeuralNetwork makeNetwork() {
+        return NeuralNetwork(7, {
+            DenseLayer(4, Activation::Linear()),
+            DenseLayer(64, Activation::ReLU()),
+            DenseLayer(32, Activation::Tanh()),
+            DenseLayer(2, Activation::Sigmoid()),
+        });
+    }
+
+    void makeData(std::vector<Vector>& features, std::vector<Vector>& labels, int count) {
+        for (int i = 0; i < count; i++) {
+            float x = static_cast<float>(i) / static_cast<float>(count);
+            features.push_back(Vector { x, 1.0f - x, x * x, 0.5f });
+            labels.push_back(Vector { x, 1.0f - x });
+        }
+    }
+
+    void testMode(bool isStochastic, const char* name) {
+        std::vector<Vector> features, labels;
+        makeData(features, labels, 50);
+
+        NeuralNetwork network = makeNetwork();
+        DiscardSink sink;
+
+        network.train(features, labels, 0.01f, 1, sink, isStochastic);
+
+        size_t start = heapAllocations();
+        network.train(features, labels, 0.01f, 1, sink, isStochastic);
+        size_t oneEpoch = heapAllocations() - start;
+
+        start = heapAllocations();
+        network.train(features, labels, 0.01f, 5, sink, isStochastic);
+        size_t fiveEpochs = heapAllocations() - start;
+
+        std::cout << name << ": " << oneEpoch << " allocations for 1 epoch, " << fiveEpochs << " for 5 ("
+                  << features.size() << " examples each)" << std::endl;
+
+        CHECK_MSG(fiveEpochs == oneEpoch, name);
+        CHECK_MSG(oneEpoch == 0, name);
+    }
+
+    // 50 examples in batches of 16 leave a short batch of 2 every epoch; it runs on a row prefix of the
+    // full batch's buffers instead of reallocating them twice per epoch
+    void testMinibatch() {
+        std::vector<Vector> features, labels;
+        makeData(features, labels, 50);
+        Dataset data(features, labels);
+
+        NeuralNetwork network = makeNetwork();
+        DiscardSink sink;
+
+        network.trainMinibatch(features, labels, 0.01f, 1, 16, sink);
+
+        // Each call allocates its own scratch (example order, label rows, losses) once, whatever the epoch count
+        size_t start = heapAllocations();
+        network.trainMinibatch(features, labels, 0.01f, 1, 16, sink);
+        size_t vectorOneEpoch = heapAllocations() - start;
+
+        start = heapAllocations();
+        network.trainMinibatch(features, labels, 0.01f, 5, 16, sink);
+        size_t vectorFiveEpochs = heapAllocations() - start;
+
+        start = heapAllocations();
+        network.trainMinibatch(data, 0.01f, 1, 16, sink);
+        size_t datasetOneEpoch = heapAllocations() - start;
+
+        start = heapAllocations();
+        network.trainMinibatch(data, 0.01f, 5, 16, sink);
+        size_t datasetFiveEpochs = heapAllocations() - start;
+
+        std::cout << "minibatch from vectors: " << vectorOneEpoch << " allocations for 1 epoch, " << vectorFiveEpochs
+                  << " for 5; from a Dataset: " << datasetOneEpoch << " and " << datasetFiveEpochs << " (batches of 16 over "
+                  << features.size() << " examples)" << std::endl;
+
+        CHECK(vectorFiveEpochs == vectorOneEpoch);
+        CHECK(datasetFiveEpochs == datasetOneEpoch);
+    }
+
+    // The workspace is sized when training starts and keeps its storage from then on
+    void testWorkspaceStorage() {
+        std::vector<Vector> features, labels;
+        makeData(features, labels, 10);
+
+        NeuralNetwork network = makeNetwork();
+        DiscardSink sink;
+        network.train(features, labels, 0.01f, 1, sink, true);
+
+        const GradientWorkspace& gradients = network.getGradients();
+        CHECK(gradients.weights.size() == 3);
+        CHECK(gradients.biases.size() == 3);
+        CHECK(gradients.weights[0].Rows() == 4 && gradients.weights[0].Cols() == 64);
+        CHECK(gradients.weights[2].Rows() == 32 && gradients.weights[2].Cols() == 2);
+
+        const float* first = gradients.weights[0].rawData();
+        network.train(features, labels, 0.01f, 3, sink, true);
+        CHECK(network.getGradients().weights[0].rawData() == first);
+    }
+
+}
+
+int main() {
+    testMode(true, "per-example SGD");
+    testMode(false, "full-batch");
+    testMinibatch();
+    testWorkspaceStorage();
+
+    return report("workspace_test");
+}